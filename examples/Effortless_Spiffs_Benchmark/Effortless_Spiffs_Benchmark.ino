@@ -0,0 +1,340 @@
+/*
+Copyright (c) 2019 thebigpotatoe
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+// #include <ArduinoJson.h>  // Uncomment this to include the ArduinoJson overloads in the benchmark
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_Tiered.h>
+
+#include <string>
+
+/* Benchmark
+		Times every saveToFile, appendToFile and openFromFile
+		overload for a range of value sizes, with text and
+		binary encoding, with compression and with and without
+		mounting once. Compare value bytes and file bytes of
+		the compressed lines for the compression ratio. Changing
+		one field of a record is timed both by saving the whole
+		record again and by updating the field in place, value
+		bytes is then the number of bytes written. Saves and
+		opens of a hot file kept in RAM are timed against the
+		same file on flash, including the final persist. Number
+		to text conversions are timed on their own against
+		sprintf and strtod, without any file access. On ESP32
+		the same reads and saves are also timed from several
+		tasks at once, on one shared file and on a file each.
+
+		Results are printed as CSV so runs from different
+		versions of the library can be compared directly:
+		op,type,encoding,mode,value bytes,file bytes,iterations,total us,max us,ops per sec
+
+		Every file used is removed afterwards, but make sure
+		there is some free space in the file system first.
+	*/
+
+#define BENCHMARK_ITERATIONS 20
+#define BENCHMARK_FILE "/bench.txt"
+
+eSPIFFS fileSystem;
+
+const char* encodingName() {
+  if (fileSystem.getCompression()) return "compressed";
+  return fileSystem.getEncoding() == eSPIFFS::BINARY_ENCODING ? "binary" : "text";
+}
+
+const char* modeName() {
+  return fileSystem.isMounted() ? "mounted" : "legacy";
+}
+
+void report(const char* op, const char* type, size_t valueBytes, unsigned long totalMicros, unsigned long maxMicros, int iterations) {
+  float opsPerSec = totalMicros ? iterations * 1000000.0 / totalMicros : 0;
+  Serial.printf("%s,%s,%s,%s,%u,%u,%d,%lu,%lu,%.1f\n", op, type, encodingName(), modeName(), (unsigned)valueBytes,
+                (unsigned)fileSystem.getFileSize(BENCHMARK_FILE), iterations, totalMicros, maxMicros, opsPerSec);
+}
+
+// Time the same call a number of times, keeping the total and the slowest
+#define TIME_CALL(call, totalMicros, maxMicros)          \
+  totalMicros = 0;                                       \
+  maxMicros = 0;                                         \
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {       \
+    unsigned long start = micros();                      \
+    call;                                                \
+    unsigned long elapsed = micros() - start;            \
+    totalMicros += elapsed;                              \
+    if (elapsed > maxMicros) maxMicros = elapsed;        \
+  }
+
+template <class T>
+void benchmarkValue(const char* type, T value, size_t valueBytes) {
+  unsigned long totalMicros, maxMicros;
+  T             output = value;
+
+  fileSystem.removeFile(BENCHMARK_FILE);
+  TIME_CALL(fileSystem.saveToFile(BENCHMARK_FILE, value), totalMicros, maxMicros);
+  report("save", type, valueBytes, totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+
+  TIME_CALL(fileSystem.openFromFile(BENCHMARK_FILE, output), totalMicros, maxMicros);
+  report("open", type, valueBytes, totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+
+  // Appends are always text, so only time them once
+  if (fileSystem.getEncoding() == eSPIFFS::TEXT_ENCODING) {
+    fileSystem.removeFile(BENCHMARK_FILE);
+    TIME_CALL(fileSystem.appendToFile(BENCHMARK_FILE, value), totalMicros, maxMicros);
+    report("append", type, valueBytes, totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  }
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+
+void benchmarkStrings(size_t valueBytes) {
+  // Config style text so compression sees a realistic payload
+  std::string stdString;
+  char        entry[64];
+  for (int i = 0; stdString.size() < valueBytes; i++) {
+    sprintf(entry, "{\"sensor%d\":{\"enabled\":true,\"offset\":%d}},", i, (i * 7) % 13);
+    stdString += entry;
+  }
+  stdString.resize(valueBytes);
+  String arduinoString(stdString.c_str());
+  benchmarkValue("std::string", stdString, valueBytes);
+  benchmarkValue("String", arduinoString, valueBytes);
+  if (valueBytes < Effortless_SPIFFS_CHAR_SIZE) benchmarkValue("char*", (char*)stdString.c_str(), valueBytes);
+}
+
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+void benchmarkJson(size_t numKeys) {
+  DynamicJsonDocument document(numKeys * 64);
+  char                key[16];
+  for (size_t i = 0; i < numKeys; i++) {
+    sprintf(key, "key%u", (unsigned)i);
+    document[key] = i * 1.5;
+  }
+  benchmarkValue("json", document, measureJson(document));
+}
+#endif
+
+void benchmarkBatch(int numFiles) {
+  // Saving many files one at a time versus as a single batch
+  char                              name[24];
+  unsigned long                     start;
+  std::vector<eSPIFFS::BatchEntry> entries;
+  for (int i = 0; i < numFiles; i++) {
+    sprintf(name, "/bench%d.txt", i);
+    entries.push_back({name, "0123456789"});
+  }
+
+  start = micros();
+  for (const eSPIFFS::BatchEntry& entry : entries) fileSystem.saveFile(entry.name.c_str(), entry.data.c_str());
+  unsigned long singleMicros = micros() - start;
+  report("save single files", "batch", numFiles * 10, singleMicros, singleMicros, 1);
+
+  start = micros();
+  fileSystem.saveFiles(entries);
+  unsigned long batchMicros = micros() - start;
+  report("save batch", "batch", numFiles * 10, batchMicros, batchMicros, 1);
+
+  for (const eSPIFFS::BatchEntry& entry : entries) fileSystem.removeFile(entry.name.c_str());
+}
+
+void benchmarkUpdate(size_t recordBytes) {
+  // Change one 4 byte field in the middle of a record, rewriting the whole file versus only the field
+  unsigned long        totalMicros, maxMicros;
+  std::vector<uint8_t> record(recordBytes, 0x00);
+  uint32_t             field = 0;
+  size_t               offset = recordBytes / 2;
+
+  fileSystem.saveFile(BENCHMARK_FILE, record.data(), recordBytes);
+  TIME_CALL(field++; memcpy(&record[offset], &field, sizeof(field)); fileSystem.saveFile(BENCHMARK_FILE, record.data(), recordBytes), totalMicros, maxMicros);
+  report("update rewrite", "record", recordBytes, totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+
+  TIME_CALL(field++; fileSystem.updateField(BENCHMARK_FILE, offset, field), totalMicros, maxMicros);
+  report("update in place", "record", sizeof(field), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+
+template <class T, class Format, class Parse, class LibraryParse>
+void benchmarkConvert(const char* type, T value, Format sprintfFormat, Parse strtoParse, LibraryParse libraryParse) {
+  // Only the conversion to and from text, with sprintf and strto* as older versions did it and with the library
+  unsigned long totalMicros, maxMicros;
+  char          text[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+
+  TIME_CALL(sprintfFormat(text, value), totalMicros, maxMicros);
+  report("format sprintf", type, sizeof(T), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  TIME_CALL(Effortless_SPIFFS_Internal::formatNumber(text, value), totalMicros, maxMicros);
+  report("format", type, sizeof(T), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  TIME_CALL(value = strtoParse(text), totalMicros, maxMicros);
+  report("parse strto", type, sizeof(T), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  TIME_CALL(value = libraryParse(text), totalMicros, maxMicros);
+  report("parse", type, sizeof(T), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+}
+
+void benchmarkConversions() {
+  benchmarkConvert<long>(
+      "long", -1234567890L, [](char* text, long value) { sprintf(text, "%li", value); },
+      [](const char* text) { return strtol(text, nullptr, 10); }, Effortless_SPIFFS_Internal::parseInteger<long>);
+  benchmarkConvert<float>(
+      "float", 3.14159f, [](char* text, float value) { sprintf(text, "%.*g", Effortless_SPIFFS_PRECISION, value); },
+      [](const char* text) { return (float)strtod(text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<float>);
+  benchmarkConvert<double>(
+      "double", 2.718281828459045, [](char* text, double value) { sprintf(text, "%.*g", Effortless_SPIFFS_PRECISION, value); },
+      [](const char* text) { return strtod(text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<double>);
+  benchmarkConvert<double>(
+      "double 1e250", 2.718281828459045e250, [](char* text, double value) { sprintf(text, "%.*g", Effortless_SPIFFS_PRECISION, value); },
+      [](const char* text) { return strtod(text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<double>);
+}
+
+void benchmarkTiered(eSPIFFSTiered::Tier tier, const char* type) {
+  // The same value saved and opened as a hot file, then written to flash once
+  unsigned long totalMicros, maxMicros;
+  eSPIFFSTiered hotFileSystem(tier);
+  int           value = 123456;
+  hotFileSystem.mount();
+  hotFileSystem.addHotFile(BENCHMARK_FILE);
+
+  TIME_CALL(hotFileSystem.saveToFile(BENCHMARK_FILE, value), totalMicros, maxMicros);
+  report("save", type, sizeof(int), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+  TIME_CALL(hotFileSystem.openFromFile(BENCHMARK_FILE, value), totalMicros, maxMicros);
+  report("open", type, sizeof(int), totalMicros, maxMicros, BENCHMARK_ITERATIONS);
+
+  unsigned long start = micros();
+  hotFileSystem.persist();
+  unsigned long persistMicros = micros() - start;
+  report("persist", type, sizeof(int), persistMicros, persistMicros, 1);
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+
+#if defined(ESP32)
+struct ContentionTask {
+  bool              save;
+  bool              shared;
+  int               index;
+  SemaphoreHandle_t done;
+};
+
+void contentionTask(void* _parameter) {
+  ContentionTask* task = (ContentionTask*)_parameter;
+  char            name[24];
+  int             value = task->index;
+  sprintf(name, task->shared ? "/bench.txt" : "/bench%d.txt", task->index);
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    if (task->save) {
+      fileSystem.saveToFile(name, value);
+    } else {
+      fileSystem.openFromFile(name, value);
+    }
+  }
+  xSemaphoreGive(task->done);
+  vTaskDelete(NULL);
+}
+
+void benchmarkContention(int numTasks, bool save, bool shared) {
+  // Several tasks on both cores at once, reads of any file and saves of different files should overlap
+  char           name[24];
+  ContentionTask tasks[numTasks];
+  for (int i = 0; i < numTasks; i++) {
+    sprintf(name, shared ? "/bench.txt" : "/bench%d.txt", i);
+    fileSystem.saveToFile(name, i);
+    tasks[i] = {save, shared, i, xSemaphoreCreateCounting(1, 0)};
+  }
+
+  unsigned long start = micros();
+  for (int i = 0; i < numTasks; i++) xTaskCreatePinnedToCore(contentionTask, "bench", 4096, &tasks[i], 1, nullptr, i % 2);
+  for (int i = 0; i < numTasks; i++) {
+    xSemaphoreTake(tasks[i].done, portMAX_DELAY);
+    vSemaphoreDelete(tasks[i].done);
+  }
+  unsigned long totalMicros = micros() - start;
+
+  sprintf(name, "%d tasks %s file", numTasks, shared ? "shared" : "own");
+  report(save ? "save" : "open", name, sizeof(int), totalMicros, totalMicros, numTasks * BENCHMARK_ITERATIONS);
+  for (int i = 0; i < numTasks; i++) {
+    sprintf(name, shared ? "/bench.txt" : "/bench%d.txt", i);
+    fileSystem.removeFile(name);
+  }
+}
+#endif
+
+void benchmarkAll() {
+  benchmarkValue<bool>("bool", true, sizeof(bool));
+  benchmarkValue<int>("int", 123456, sizeof(int));
+  benchmarkValue<long>("long", -1234567890L, sizeof(long));
+  benchmarkValue<float>("float", 3.14159f, sizeof(float));
+  benchmarkValue<double>("double", 2.718281828459045, sizeof(double));
+  benchmarkStrings(16);
+  benchmarkStrings(256);
+  benchmarkStrings(4096);
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  benchmarkJson(10);
+  benchmarkJson(100);
+#endif
+}
+
+void setup() {
+  // Start Serial
+  Serial.begin(115200);
+  Serial.println();
+
+  // Small delay for startup
+  delay(1000);
+
+  if (!fileSystem.checkFlashConfig()) {
+    Serial.println("Flash size was not correct! Please check your SPIFFS config and try again");
+    return;
+  }
+
+  Serial.println("op,type,encoding,mode,value bytes,file bytes,iterations,total us,max us,ops per sec");
+
+  // Every call checks the file system and opens files by itself
+  fileSystem.setEncoding(eSPIFFS::TEXT_ENCODING);
+  benchmarkAll();
+
+  // Mount once and reuse it for every call
+  fileSystem.mount();
+  benchmarkAll();
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  benchmarkAll();
+  fileSystem.setEncoding(eSPIFFS::TEXT_ENCODING);
+
+  // Strings and JSON compressed on save and expanded on open
+  fileSystem.setCompression(true);
+  benchmarkStrings(256);
+  benchmarkStrings(4096);
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  benchmarkJson(100);
+#endif
+  fileSystem.setCompression(false);
+
+  benchmarkBatch(10);
+  benchmarkBatch(50);
+
+  benchmarkUpdate(256);
+  benchmarkUpdate(4096);
+
+  benchmarkConversions();
+
+  benchmarkValue<int>("int", 123456, sizeof(int));
+  benchmarkTiered(eSPIFFSTiered::RAM_TIER, "int ram tier");
+  benchmarkTiered(eSPIFFSTiered::RTC_TIER, "int rtc tier");
+
+#if defined(ESP32)
+  // Reads and saves from several tasks at once, ops per sec should grow with the number of tasks for reads
+  for (int numTasks = 1; numTasks <= 4; numTasks *= 2) {
+    benchmarkContention(numTasks, false, true);
+    benchmarkContention(numTasks, false, false);
+    benchmarkContention(numTasks, true, false);
+  }
+#endif
+
+  Serial.println("done");
+}
+
+void loop() {}
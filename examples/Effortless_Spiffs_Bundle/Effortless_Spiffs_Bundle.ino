@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2019 thebigpotatoe
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_Bundle.h>
+
+#include <string>
+
+#include "assets.h"
+
+/* Bundle
+		eSPIFFSBundle reads static files from a single read
+		only image, finding them with a binary search and
+		handing back pointers into flash instead of copies.
+
+		assets.h was made from the data folder with:
+		python3 extras/eSPIFFS_bundle.py data --header assets.h --symbol assets
+
+		The second half of this example writes the same files
+		to the file system and times finding and reading them
+		both ways, printed as CSV:
+		op,source,file,bytes,iterations,total us,max us,ops per sec
+	*/
+
+#define BENCHMARK_ITERATIONS 100
+
+eSPIFFS       fileSystem;
+eSPIFFSBundle bundle(&Serial);
+
+void report(const char* op, const char* source, const char* name, size_t bytes, unsigned long totalMicros, unsigned long maxMicros) {
+  float opsPerSec = totalMicros ? BENCHMARK_ITERATIONS * 1000000.0 / totalMicros : 0;
+  Serial.printf("%s,%s,%s,%u,%d,%lu,%lu,%.1f\n", op, source, name, (unsigned)bytes, BENCHMARK_ITERATIONS, totalMicros, maxMicros, opsPerSec);
+}
+
+// Time the same call a number of times, keeping the total and the slowest
+#define TIME_CALL(call, totalMicros, maxMicros)          \
+  totalMicros = 0;                                       \
+  maxMicros = 0;                                         \
+  for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {       \
+    unsigned long start = micros();                      \
+    call;                                                \
+    unsigned long elapsed = micros() - start;            \
+    totalMicros += elapsed;                              \
+    if (elapsed > maxMicros) maxMicros = elapsed;        \
+  }
+
+uint32_t sumBundle(const char* name) {
+  // Read every byte in place, pgm_read_byte keeps this safe for PROGMEM on ESP8266
+  uint32_t             sum = 0;
+  eSPIFFSBundle::Asset asset = bundle.find(name);
+  for (size_t i = 0; i < asset.size; i++) sum += pgm_read_byte(asset.data + i);
+  return sum;
+}
+
+uint32_t sumFile(const char* name) {
+  uint32_t sum = 0;
+  fileSystem.readFile(name, [&](const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) sum += data[i];
+    return true;
+  });
+  return sum;
+}
+
+void benchmark() {
+  unsigned long    totalMicros, maxMicros;
+  volatile uint32_t sink = 0;
+
+  Serial.println("op,source,file,bytes,iterations,total us,max us,ops per sec");
+  for (size_t i = 0; i < bundle.numFiles(); i++) {
+    eSPIFFSBundle::Asset asset = bundle.at(i);
+    char                 name[32];
+    memcpy_P(name, asset.name, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    // Copy the file out of the bundle onto the file system to compare with
+    std::string contents(asset.size, '\0');
+    memcpy_P(&contents[0], asset.data, asset.size);
+    fileSystem.saveFile(name, (const uint8_t*)contents.data(), contents.size());
+
+    TIME_CALL(sink = sink + bundle.getFileSize(name), totalMicros, maxMicros);
+    report("lookup", "bundle", name, asset.size, totalMicros, maxMicros);
+    TIME_CALL(sink = sink + fileSystem.getFileSize(name), totalMicros, maxMicros);
+    report("lookup", "file", name, asset.size, totalMicros, maxMicros);
+
+    TIME_CALL(sink = sink + sumBundle(name), totalMicros, maxMicros);
+    report("read", "bundle", name, asset.size, totalMicros, maxMicros);
+    TIME_CALL(sink = sink + sumFile(name), totalMicros, maxMicros);
+    report("read", "file", name, asset.size, totalMicros, maxMicros);
+
+    fileSystem.removeFile(name);
+  }
+}
+
+void setup() {
+  // Start Serial
+  Serial.begin(115200);
+  Serial.println();
+
+  // Small delay for startup
+  delay(1000);
+
+  // Open the bundle compiled into the sketch, on ESP32 an image flashed to a partition can be opened with bundle.begin("assets")
+  if (!bundle.begin(assets, assets_size) || !bundle.verify()) {
+    Serial.println("Could not open the bundle");
+    return;
+  }
+
+  // Print a file straight from the bundle without copying it
+  eSPIFFSBundle::Asset page = bundle.find("/index.html");
+  if (page) {
+    Serial.printf("/index.html is %u bytes:\n", (unsigned)page.size);
+    for (size_t i = 0; i < page.size; i++) Serial.print((char)pgm_read_byte(page.data + i));
+  }
+
+  // Compare with reading the same files from the file system
+  if (fileSystem.checkFlashConfig() && fileSystem.mount()) benchmark();
+}
+
+void loop() {}
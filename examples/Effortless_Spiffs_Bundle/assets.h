@@ -0,0 +1,44 @@
+// Generated by eSPIFFS_bundle.py, do not edit
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t assets[] PROGMEM __attribute__((aligned(4))) = {
+    0x65, 0x53, 0x50, 0x42, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x40, 0x02, 0x00, 0x00,
+    0xe3, 0x77, 0xf3, 0x0f, 0x44, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x00,
+    0x59, 0x00, 0x00, 0x00, 0x51, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0xc4, 0x00, 0x00, 0x00,
+    0x0b, 0x01, 0x00, 0x00, 0x5d, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd0, 0x01, 0x00, 0x00,
+    0x70, 0x00, 0x00, 0x00, 0x2f, 0x63, 0x6f, 0x6e, 0x66, 0x69, 0x67, 0x2e, 0x6a, 0x73, 0x6f, 0x6e,
+    0x00, 0x2f, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x2e, 0x68, 0x74, 0x6d, 0x6c, 0x00, 0x2f, 0x73, 0x74,
+    0x79, 0x6c, 0x65, 0x2e, 0x63, 0x73, 0x73, 0x00, 0x7b, 0x22, 0x6e, 0x61, 0x6d, 0x65, 0x22, 0x3a,
+    0x22, 0x45, 0x66, 0x66, 0x6f, 0x72, 0x74, 0x6c, 0x65, 0x73, 0x73, 0x20, 0x53, 0x50, 0x49, 0x46,
+    0x46, 0x53, 0x22, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x22, 0x3a, 0x31, 0x2c,
+    0x22, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x73, 0x22, 0x3a, 0x5b, 0x22, 0x74, 0x65, 0x6d, 0x70,
+    0x65, 0x72, 0x61, 0x74, 0x75, 0x72, 0x65, 0x22, 0x2c, 0x22, 0x68, 0x75, 0x6d, 0x69, 0x64, 0x69,
+    0x74, 0x79, 0x22, 0x2c, 0x22, 0x70, 0x72, 0x65, 0x73, 0x73, 0x75, 0x72, 0x65, 0x22, 0x5d, 0x7d,
+    0x0a, 0x00, 0x00, 0x00, 0x3c, 0x21, 0x44, 0x4f, 0x43, 0x54, 0x59, 0x50, 0x45, 0x20, 0x68, 0x74,
+    0x6d, 0x6c, 0x3e, 0x0a, 0x3c, 0x68, 0x74, 0x6d, 0x6c, 0x3e, 0x0a, 0x3c, 0x68, 0x65, 0x61, 0x64,
+    0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x6d, 0x65, 0x74, 0x61, 0x20, 0x63, 0x68, 0x61, 0x72, 0x73, 0x65,
+    0x74, 0x3d, 0x22, 0x75, 0x74, 0x66, 0x2d, 0x38, 0x22, 0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x74, 0x69,
+    0x74, 0x6c, 0x65, 0x3e, 0x45, 0x66, 0x66, 0x6f, 0x72, 0x74, 0x6c, 0x65, 0x73, 0x73, 0x20, 0x53,
+    0x50, 0x49, 0x46, 0x46, 0x53, 0x3c, 0x2f, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x0a, 0x20, 0x20,
+    0x3c, 0x6c, 0x69, 0x6e, 0x6b, 0x20, 0x72, 0x65, 0x6c, 0x3d, 0x22, 0x73, 0x74, 0x79, 0x6c, 0x65,
+    0x73, 0x68, 0x65, 0x65, 0x74, 0x22, 0x20, 0x68, 0x72, 0x65, 0x66, 0x3d, 0x22, 0x2f, 0x73, 0x74,
+    0x79, 0x6c, 0x65, 0x2e, 0x63, 0x73, 0x73, 0x22, 0x3e, 0x0a, 0x3c, 0x2f, 0x68, 0x65, 0x61, 0x64,
+    0x3e, 0x0a, 0x3c, 0x62, 0x6f, 0x64, 0x79, 0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x68, 0x31, 0x3e, 0x45,
+    0x66, 0x66, 0x6f, 0x72, 0x74, 0x6c, 0x65, 0x73, 0x73, 0x20, 0x53, 0x50, 0x49, 0x46, 0x46, 0x53,
+    0x3c, 0x2f, 0x68, 0x31, 0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x70, 0x3e, 0x54, 0x68, 0x69, 0x73, 0x20,
+    0x70, 0x61, 0x67, 0x65, 0x20, 0x77, 0x61, 0x73, 0x20, 0x73, 0x65, 0x72, 0x76, 0x65, 0x64, 0x20,
+    0x73, 0x74, 0x72, 0x61, 0x69, 0x67, 0x68, 0x74, 0x20, 0x66, 0x72, 0x6f, 0x6d, 0x20, 0x61, 0x20,
+    0x72, 0x65, 0x61, 0x64, 0x20, 0x6f, 0x6e, 0x6c, 0x79, 0x20, 0x62, 0x75, 0x6e, 0x64, 0x6c, 0x65,
+    0x20, 0x69, 0x6e, 0x20, 0x66, 0x6c, 0x61, 0x73, 0x68, 0x2e, 0x3c, 0x2f, 0x70, 0x3e, 0x0a, 0x3c,
+    0x2f, 0x62, 0x6f, 0x64, 0x79, 0x3e, 0x0a, 0x3c, 0x2f, 0x68, 0x74, 0x6d, 0x6c, 0x3e, 0x0a, 0x00,
+    0x62, 0x6f, 0x64, 0x79, 0x20, 0x7b, 0x0a, 0x20, 0x20, 0x66, 0x6f, 0x6e, 0x74, 0x2d, 0x66, 0x61,
+    0x6d, 0x69, 0x6c, 0x79, 0x3a, 0x20, 0x73, 0x61, 0x6e, 0x73, 0x2d, 0x73, 0x65, 0x72, 0x69, 0x66,
+    0x3b, 0x0a, 0x20, 0x20, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x20, 0x32, 0x65, 0x6d, 0x20,
+    0x61, 0x75, 0x74, 0x6f, 0x3b, 0x0a, 0x20, 0x20, 0x6d, 0x61, 0x78, 0x2d, 0x77, 0x69, 0x64, 0x74,
+    0x68, 0x3a, 0x20, 0x34, 0x30, 0x65, 0x6d, 0x3b, 0x0a, 0x20, 0x20, 0x63, 0x6f, 0x6c, 0x6f, 0x72,
+    0x3a, 0x20, 0x23, 0x33, 0x33, 0x33, 0x3b, 0x0a, 0x7d, 0x0a, 0x68, 0x31, 0x20, 0x7b, 0x0a, 0x20,
+    0x20, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x20, 0x23, 0x30, 0x61, 0x36, 0x3b, 0x0a, 0x7d, 0x0a,
+};
+const size_t assets_size = 576;
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2019 thebigpotatoe
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+*/
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_KV.h>
+
+/* Key Value Store
+		eSPIFFSKV packs many values into a single file rather
+		than one file per value. It supports the same types
+		and methods as eSPIFFS, with keys instead of file names.
+
+		The second half of this example times saving and
+		opening 10, 100 and 1000 values with both approaches.
+	*/
+
+void benchmark(int numKeys) {
+  char key[24];
+
+  // One file per value
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  unsigned long start = micros();
+  for (int i = 0; i < numKeys; i++) {
+    sprintf(key, "/bench%d.txt", i);
+    fileSystem.saveToFile(key, i);
+  }
+  unsigned long fileSave = micros() - start;
+  start = micros();
+  for (int i = 0; i < numKeys; i++) {
+    int value;
+    sprintf(key, "/bench%d.txt", i);
+    fileSystem.openFromFile(key, value);
+  }
+  unsigned long fileOpen = micros() - start;
+  for (int i = 0; i < numKeys; i++) {
+    sprintf(key, "/bench%d.txt", i);
+    fileSystem.removeFile(key);
+  }
+
+  // Single key value file
+  fileSystem.removeFile("/bench.kv");
+  eSPIFFSKV store("/bench.kv");
+  start = micros();
+  for (int i = 0; i < numKeys; i++) {
+    sprintf(key, "bench%d", i);
+    store.saveToFile(key, i);
+  }
+  unsigned long storeSave = micros() - start;
+  start = micros();
+  for (int i = 0; i < numKeys; i++) {
+    int value;
+    sprintf(key, "bench%d", i);
+    store.openFromFile(key, value);
+  }
+  unsigned long storeOpen = micros() - start;
+  fileSystem.removeFile("/bench.kv");
+
+  // keys,file save us,file open us,store save us,store open us
+  Serial.printf("%d,%lu,%lu,%lu,%lu\n", numKeys, fileSave, fileOpen, storeSave, storeOpen);
+}
+
+void setup() {
+  // Start Serial
+  Serial.begin(115200);
+  Serial.println();
+
+  // Small delay for startup
+  delay(1000);
+
+  // Create a store, all values are kept in "/settings.kv"
+  eSPIFFSKV settings("/settings.kv");
+  if (!settings.begin()) {
+    Serial.println("Failed to open the store! Please check your SPIFFS config and try again");
+    return;
+  }
+
+  // Count the number of boots
+  unsigned long bootCount = 0;
+  settings.openFromFile("bootCount", bootCount);
+  bootCount++;
+  settings.saveToFile("bootCount", bootCount);
+  Serial.print("Boot count is: ");
+  Serial.println(bootCount);
+
+  // Any supported type can be stored
+  String deviceName = "Effortless";
+  settings.saveToFile("deviceName", deviceName);
+  float setpoint = 21.5;
+  settings.saveToFile("setpoint", setpoint);
+  Serial.print("Store holds ");
+  Serial.print(settings.size());
+  Serial.print(" keys in ");
+  Serial.print(settings.fileBytes());
+  Serial.println(" bytes");
+
+  // Compare against one file per value
+  Serial.println();
+  Serial.println("keys,file save us,file open us,store save us,store open us");
+  benchmark(10);
+  benchmark(100);
+  benchmark(1000);
+}
+
+void loop() {}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Pack a directory of static files into an eSPIFFSBundle image.
+
+The image can be flashed to a data partition on ESP32 and opened with
+eSPIFFSBundle::begin("label"), or written out as a C header and compiled
+into the sketch, then opened with eSPIFFSBundle::begin(array, size).
+
+Image layout, all integers little endian:
+    header  magic "eSPB", version (u8), 3 reserved bytes,
+            file count (u32), image size (u32), crc32 of everything after the header (u32)
+    index   one 16 byte entry per file sorted by name:
+            name offset (u32), name length (u32), data offset (u32), data size (u32)
+    names   file names, each followed by a null terminator
+    data    file contents, each starting on a 4 byte boundary
+
+Usage:
+    eSPIFFS_bundle.py data -o assets.bin
+    eSPIFFS_bundle.py data --header assets.h --symbol assets
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"eSPB"
+VERSION = 1
+HEADER_SIZE = 20
+ENTRY_SIZE = 16
+
+
+def collect(source):
+    # Every file below source, named like the file system with a leading slash
+    files = []
+    for root, _, names in os.walk(source):
+        for name in names:
+            path = os.path.join(root, name)
+            relative = os.path.relpath(path, source).replace(os.sep, "/")
+            with open(path, "rb") as f:
+                files.append((("/" + relative).encode("utf-8"), f.read()))
+    files.sort(key=lambda entry: entry[0])
+    return files
+
+
+def align(data, boundary=4):
+    return data + b"\0" * (-len(data) % boundary)
+
+
+def pack(files):
+    names = b""
+    name_offsets = []
+    names_start = HEADER_SIZE + ENTRY_SIZE * len(files)
+    for name, _ in files:
+        name_offsets.append(names_start + len(names))
+        names += name + b"\0"
+
+    data = b""
+    data_offsets = []
+    data_start = names_start + len(align(names))
+    for _, contents in files:
+        data_offsets.append(data_start + len(data))
+        data += align(contents)
+
+    index = b""
+    for i, (name, contents) in enumerate(files):
+        index += struct.pack("<IIII", name_offsets[i], len(name), data_offsets[i], len(contents))
+
+    body = index + align(names) + data
+    header = MAGIC + struct.pack("<B3xII", VERSION, len(files), HEADER_SIZE + len(body))
+    return header + struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF) + body
+
+
+def write_header(image, path, symbol):
+    with open(path, "w") as f:
+        f.write("// Generated by eSPIFFS_bundle.py, do not edit\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <Arduino.h>\n\n")
+        f.write("const uint8_t %s[] PROGMEM __attribute__((aligned(4))) = {\n" % symbol)
+        for i in range(0, len(image), 16):
+            f.write("    " + ", ".join("0x%02x" % b for b in image[i:i + 16]) + ",\n")
+        f.write("};\n")
+        f.write("const size_t %s_size = %d;\n" % (symbol, len(image)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack a directory into an eSPIFFSBundle image")
+    parser.add_argument("source", help="directory of files to pack")
+    parser.add_argument("-o", "--output", help="binary image to write")
+    parser.add_argument("--header", help="C header to write the image into")
+    parser.add_argument("--symbol", default="bundle", help="array name used in the C header")
+    args = parser.parse_args()
+
+    if not args.output and not args.header:
+        parser.error("give an output image, a header or both")
+    if not os.path.isdir(args.source):
+        parser.error("%s is not a directory" % args.source)
+
+    files = collect(args.source)
+    image = pack(files)
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(image)
+    if args.header:
+        write_header(image, args.header, args.symbol)
+
+    for name, contents in files:
+        print("%8d  %s" % (len(contents), name.decode("utf-8")))
+    print("%d files, %d byte image" % (len(files), len(image)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -11,16 +11,21 @@
 // Architecture Specific Libraries
 #if defined(ESP8266)
 #include <LittleFS.h>
-#define EFFORTLESS_SPIFFS_TYPE LittleFS
 #elif defined(ESP32)
 #include "SPIFFS.h"
-#define EFFORTLESS_SPIFFS_TYPE SPIFFS
 #else
 #error Effortless SPIFFS does not work on the selected architecture
 #endif
 
 // Standard c++ libraries
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #ifndef Effortless_SPIFFS_h
 #define Effortless_SPIFFS_h
@@ -34,16 +39,86 @@
 #define Effortless_SPIFFS_CHAR_SIZE 1024
 #endif
 
+#ifndef Effortless_SPIFFS_CHAR_SLOTS
+#define Effortless_SPIFFS_CHAR_SLOTS 4
+#endif
+
 #ifndef Effortless_SPIFFS_PRECISION
 #define Effortless_SPIFFS_PRECISION 15
 #endif
 
+#ifndef Effortless_SPIFFS_CHUNK_SIZE
+#define Effortless_SPIFFS_CHUNK_SIZE 128
+#endif
+
+#ifndef Effortless_SPIFFS_VALUE_SIZE
+#define Effortless_SPIFFS_VALUE_SIZE 64
+#endif
+
+#ifndef Effortless_SPIFFS_ATOMIC_SAVES
+#define Effortless_SPIFFS_ATOMIC_SAVES true
+#endif
+
+#ifndef Effortless_SPIFFS_JOURNAL
+#define Effortless_SPIFFS_JOURNAL "/eSPIFFS.journal"
+#endif
+
+#ifndef Effortless_SPIFFS_CACHE_SIZE
+#define Effortless_SPIFFS_CACHE_SIZE 2048
+#endif
+
+#ifndef Effortless_SPIFFS_STATS
+#define Effortless_SPIFFS_STATS false
+#endif
+
+#ifndef Effortless_SPIFFS_COMPRESSION
+#define Effortless_SPIFFS_COMPRESSION false
+#endif
+
+#ifndef Effortless_SPIFFS_COMPRESS_MIN
+#define Effortless_SPIFFS_COMPRESS_MIN 64
+#endif
+
+#ifndef Effortless_SPIFFS_LZ_HASH_BITS
+#define Effortless_SPIFFS_LZ_HASH_BITS 10
+#endif
+
+#ifndef Effortless_SPIFFS_JSON_BUFFER_SIZE
+#define Effortless_SPIFFS_JSON_BUFFER_SIZE 256
+#endif
+
+#ifndef Effortless_SPIFFS_LOCKS
+#define Effortless_SPIFFS_LOCKS true
+#endif
+
+#ifndef Effortless_SPIFFS_LOCK_STRIPES
+#define Effortless_SPIFFS_LOCK_STRIPES 8
+#endif
+
 // Effortless SPIFFS Debug Macros
 #define ESPIFFS_DEBUG(x) \
   if (printer) printer->print(x)
 #define ESPIFFS_DEBUGLN(x) \
   if (printer) printer->println(x)
 
+// Effortless SPIFFS Statistics Macros - compile to nothing unless Effortless_SPIFFS_STATS is true
+#if Effortless_SPIFFS_STATS
+#define ESPIFFS_STATS_TIMER(op) StatsTimer statsTimer(*this, stats.op)
+#define ESPIFFS_STATS_COUNT(counter, n) statsCount(&Stats::counter, (n))
+#define ESPIFFS_STATS_FAIL(reason) statsFailure(reason)
+#else
+#define ESPIFFS_STATS_TIMER(op)
+#define ESPIFFS_STATS_COUNT(counter, n)
+#define ESPIFFS_STATS_FAIL(reason)
+#endif
+
+// Effortless SPIFFS Locking - only ESP32 runs tasks in parallel, ESP8266 is single threaded
+#if defined(ESP32) && Effortless_SPIFFS_LOCKS
+#define ESPIFFS_LOCKING 1
+#else
+#define ESPIFFS_LOCKING 0
+#endif
+
 // Effortless SPIFFS internal namespace
 namespace Effortless_SPIFFS_Internal {
   template <bool B, class T = void>
@@ -60,481 +135,3327 @@ namespace Effortless_SPIFFS_Internal {
   struct is_same<A, A> {
     static const bool value = true;
   };
-}  // namespace Effortless_SPIFFS_Internal
 
-// Main Effortless SPIFFS Class
-class eSPIFFS {
- public:  // constructors
-  eSPIFFS(Print* _debug = nullptr) : printer(_debug) {}
-  ~eSPIFFS() {}
+  // Binary encoding - magic, type tag (kind << 4 | size), little endian value, crc8
+  static const uint8_t BINARY_MAGIC = 0xE5;
+  static const uint8_t BINARY_BOOL = 0x10;
+  static const uint8_t BINARY_SIGNED = 0x20;
+  static const uint8_t BINARY_UNSIGNED = 0x30;
+  static const uint8_t BINARY_FLOAT = 0x40;
+  static const size_t  BINARY_MAX_SIZE = 11;
 
- public:  // spiffs access methods
-  virtual inline bool checkFlashConfig() {
-#if defined(ESP8266)
-    if (!flashSizeCorrect) {
-      // Get actual flash size and size set in IDE
-      uint32_t realSize = ESP.getFlashChipRealSize();
-      uint32_t ideSize = ESP.getFlashChipSize();
+  // Bulk binary blocks - magic, block tag (0x50 | version), element tag, element size (le16), count (le32), crc32 (le32), elements
+  static const uint8_t BINARY_BLOCK = 0x50;
+  static const uint8_t BINARY_BLOCK_VERSION = 0x01;
+  static const uint8_t BINARY_STRUCT = 0x60;
+  static const size_t  BINARY_BLOCK_HEADER = 13;
 
-      // Compare the two sizes
-      if (realSize >= ideSize) {
-        // Get info about the LittleFS
-        if (EFFORTLESS_SPIFFS_TYPE.begin()) {
-          FSInfo fs_info;
-          EFFORTLESS_SPIFFS_TYPE.info(fs_info);
-          if (fs_info.totalBytes != 0) {
-            // Change the boolean to true if the config is ok
-            flashSizeCorrect = true;
-          } else {
-            ESPIFFS_DEBUGLN("[checkFlashConfig] - LittleFS size was set to 0, please select a LittleFS size from the \"tools->flash size:\" menu");
-          }
-        } else {
-          ESPIFFS_DEBUGLN("[checkFlashConfig] - LittleFS size was set to 0, please select a LittleFS size from the \"tools->flash size:\" menu");
-        }
-      } else {
-        // Tell the user the flash is incorrect if it is not
-        ESPIFFS_DEBUGLN("[checkFlashConfig] - Flash chip set to the incorrect size, correct size is; " + String(realSize));
-      }
-    }
+  // Compressed text - magic, compressed tag (0x70 | version), original size (le32), crc32 of the original (le32), LZSS stream
+  static const uint8_t BINARY_COMPRESSED = 0x70;
+  static const uint8_t BINARY_COMPRESSED_VERSION = 0x01;
+  static const size_t  BINARY_COMPRESSED_HEADER = 10;
 
-#elif defined(ESP32)
-    if (EFFORTLESS_SPIFFS_TYPE.begin()) {
-      if (EFFORTLESS_SPIFFS_TYPE.totalBytes() > 0) {
-        flashSizeCorrect = true;
-      } else {
-        ESPIFFS_DEBUGLN("[checkFlashConfig] - SPIFFS size was set to 0, please select a SPIFFS size from the \"tools->flash size:\" menu or partition a SPIFFS");
-      }
-    } else {
-      ESPIFFS_DEBUGLN("[checkFlashConfig] - Failed to start SPIFFS");
+  inline uint32_t hashName(const char* _name, size_t _len) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (_len--) hash = (hash ^ (uint8_t)*_name++) * 16777619u;
+    return hash;
+  }
+
+  inline uint32_t crc32(const uint8_t* _data, size_t _len, uint32_t _crc = 0x00000000) {
+    _crc = ~_crc;
+    while (_len--) {
+      _crc ^= *_data++;
+      for (uint8_t i = 0; i < 8; i++) _crc = (_crc & 1) ? (_crc >> 1) ^ 0xEDB88320 : (_crc >> 1);
     }
-#endif
+    return ~_crc;
+  }
 
-    // Return the boolean
-    return flashSizeCorrect;
+  // Atomic save names - the target, a mark and the crc32 in eight hex digits, so an ordinary file name is never taken for one
+  inline std::string markedName(const char* _filename, char _mark, uint32_t _crc) {
+    static const char digits[] = "0123456789abcdef";
+    std::string       name(_filename);
+    name += _mark;
+    for (int shift = 28; shift >= 0; shift -= 4) name += digits[(_crc >> shift) & 0x0F];
+    return name;
   }
-  virtual inline int getFileSize(const char* _filename) {
-    // Check if the flash config is set correctly
-    if (checkFlashConfig()) {
-      // Check if the spiffs starts correctly
-      if (EFFORTLESS_SPIFFS_TYPE.begin()) {
-        // Check if the file exists
-        if (EFFORTLESS_SPIFFS_TYPE.exists(_filename)) {
-          // Open the dir and check if it is a file
-          File currentFile = EFFORTLESS_SPIFFS_TYPE.open(_filename, "r");
-          if (currentFile) {
-            // Return the file size
-            return currentFile.size();
-          } else {
-            ESPIFFS_DEBUG("[getFileSize] - File did not open correctly: ");
-            ESPIFFS_DEBUGLN(_filename);
-          }
-        } else {
-          ESPIFFS_DEBUG("[getFileSize] - File does not exist: ");
-          ESPIFFS_DEBUGLN(_filename);
-        }
+  inline bool parseMarkedName(const std::string& _name, char _mark, std::string& _target, uint32_t& _crc) {
+    if (_name.size() < 10 || _name[_name.size() - 9] != _mark) return false;
+    _crc = 0;
+    for (size_t i = _name.size() - 8; i < _name.size(); i++) {
+      char digit = _name[i];
+      if (digit >= '0' && digit <= '9') {
+        _crc = (_crc << 4) | (digit - '0');
+      } else if (digit >= 'a' && digit <= 'f') {
+        _crc = (_crc << 4) | (digit - 'a' + 10);
       } else {
-        ESPIFFS_DEBUGLN("[getFileSize] - Failed to start file system");
+        return false;
       }
     }
-    return 0;
+    _target = _name.substr(0, _name.size() - 9);
+    return true;
   }
-  virtual File getFile(const char* _filename, const char* _readWrite) {
-    // Check if the flash config is set correctly
-    if (checkFlashConfig()) {  // 5us
-      // Check if the spiffs starts correctly
-      if (EFFORTLESS_SPIFFS_TYPE.begin()) {  // 5us
-        // Check if the file exists
-        if (strcmp(_readWrite, "r") == 0 ? EFFORTLESS_SPIFFS_TYPE.exists(_filename) : true) {  // 49us
-          // Open it in read mode and check if its ok
-          File currentFile = EFFORTLESS_SPIFFS_TYPE.open(_filename, _readWrite);  // 115us
-          if (currentFile) {
-            return currentFile;
-          } else {
-            ESPIFFS_DEBUG("[openFile] - Failed to open file");
-            ESPIFFS_DEBUGLN(_filename);
-          }
-        } else {
-          ESPIFFS_DEBUG("[openFile] - File does not exist: ");
-          ESPIFFS_DEBUGLN(_filename);
-        }
-      } else {
-        ESPIFFS_DEBUGLN("[openFile] - Failed to start LittleFS");
-      }
+
+  // Print wrapper keeping a running crc32 of everything written through it
+  class CrcPrint : public Print {
+   public:
+    CrcPrint(Print& _output) : output(_output) {}
+    size_t write(uint8_t _byte) override {
+      return write(&_byte, 1);
     }
-    return File();
-  }
-  virtual bool openFile(const char* _filename, char* _output, size_t _len = 0) {
-    // Open it in read mode and check if its ok
-    File currentFile = getFile(_filename, "r");  // 115us
-    if (currentFile) {
-      // Read the desired number of bytes from the array to the output buffer
-      size_t numBytesToRead = (_len > 0 && _len <= currentFile.size()) ? _len : currentFile.size();
-      if (currentFile.readBytes(_output, numBytesToRead)) {  // readBytes - 300us, readBytesUntil - 465us - goes up with larger strings
-        return true;
-      } else {
-        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
-        ESPIFFS_DEBUGLN(_filename);
-      }
+    size_t write(const uint8_t* _buffer, size_t _size) override {
+      size_t written = output.write(_buffer, _size);
+      crc = crc32(_buffer, written, crc);
+      numWritten += written;
+      return written;
     }
-    return false;
-  }
-  virtual bool saveFile(const char* _filename, const char* _input) {  // Total time is about 6000us for small strings
-    // Open the file in write mode and check if open
-    File currentFile = getFile(_filename, "w");
-    if (currentFile) {
-      // Print the input string to the file
-      if (currentFile.print(_input)) {
-        currentFile.close();
-        return true;
-      } else {
-        ESPIFFS_DEBUG("[saveFile] - Failed to write any bytes to file: ");
-        ESPIFFS_DEBUGLN(_filename);
+    uint32_t value() const {
+      return crc;
+    }
+    size_t size() const {
+      return numWritten;
+    }
+
+   private:
+    Print&   output;
+    uint32_t crc = 0;
+    size_t   numWritten = 0;
+  };
+
+  // Stream serving ArduinoJson's single byte reads from a buffer filled in large reads
+  class BufferedReader : public Stream {
+   public:
+    BufferedReader(Stream& _input) : input(_input) {}
+    int available() override {
+      return (length - position) + input.available();
+    }
+    int read() override {
+      if (position == length && !fill()) return -1;
+      return (uint8_t)buffer[position++];
+    }
+    int peek() override {
+      if (position == length && !fill()) return -1;
+      return (uint8_t)buffer[position];
+    }
+    size_t readBytes(char* _output, size_t _len) override {
+      size_t numBytesRead = 0;
+      while (numBytesRead < _len && (position < length || fill())) {
+        size_t numBytesToCopy = length - position < _len - numBytesRead ? length - position : _len - numBytesRead;
+        memcpy(_output + numBytesRead, buffer + position, numBytesToCopy);
+        position += numBytesToCopy;
+        numBytesRead += numBytesToCopy;
       }
+      return numBytesRead;
+    }
+    size_t write(uint8_t) override {
+      return 0;
     }
+    void flush() {}
 
-    return false;
-  }
-  virtual bool appendFile(const char* _filename, const char* _input) {
-    // Open the file in write mode and check if open
-    File currentFile = getFile(_filename, "a");
-    if (currentFile) {
-      // Print the input string to the file
-      if (currentFile.print(_input)) {
-        currentFile.close();
-        return true;
-      } else {
-        ESPIFFS_DEBUG("[saveFile] - Failed to append any bytes to file: ");
-        ESPIFFS_DEBUGLN(_filename);
+   private:
+    bool fill() {
+      position = 0;
+      length = input.readBytes(buffer, sizeof(buffer));
+      return length > 0;
+    }
+    Stream& input;
+    char    buffer[Effortless_SPIFFS_JSON_BUFFER_SIZE];
+    size_t  position = 0;
+    size_t  length = 0;
+  };
+
+  // Print collecting ArduinoJson's small writes into buffer sized writes, finish() writes the rest
+  class BufferedPrint : public Print {
+   public:
+    BufferedPrint(Print& _output) : output(_output) {}
+    size_t write(uint8_t _byte) override {
+      return write(&_byte, 1);
+    }
+    size_t write(const uint8_t* _buffer, size_t _size) override {
+      for (size_t i = 0; i < _size; i++) {
+        if (length == sizeof(buffer) && !finish()) return i;
+        buffer[length++] = _buffer[i];
       }
+      return _size;
+    }
+    bool finish() {
+      if (length && output.write(buffer, length) != length) failed = true;
+      length = 0;
+      return !failed;
     }
-    return false;
-  }
 
- public:
-  void setDebugOutput(Print* _debug) {
-    if (_debug) printer = _debug;
-  }
-  void clearDebugOutput() {
-    printer = nullptr;
+   private:
+    Print&  output;
+    uint8_t buffer[Effortless_SPIFFS_JSON_BUFFER_SIZE];
+    size_t  length = 0;
+    bool    failed = false;
+  };
+
+  inline uint8_t crc8(const uint8_t* _data, size_t _len, uint8_t _crc = 0x00) {
+    while (_len--) {
+      _crc ^= *_data++;
+      for (uint8_t i = 0; i < 8; i++) _crc = (_crc & 0x80) ? (_crc << 1) ^ 0x07 : (_crc << 1);
+    }
+    return _crc;
   }
 
- public:  // open value templates
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    char   fileContents[fileSize + 1];
-    memset(fileContents, 0x00, fileSize + 1);
+  struct binary_kind {
+    static const uint8_t value = (T(-1) < T(0)) ? BINARY_SIGNED : BINARY_UNSIGNED;
+  };
+  template <>
+  struct binary_kind<bool> {
+    static const uint8_t value = BINARY_BOOL;
+  };
+  template <>
+  struct binary_kind<float> {
+    static const uint8_t value = BINARY_FLOAT;
+  };
+  template <>
+  struct binary_kind<double> {
+    static const uint8_t value = BINARY_FLOAT;
+  };
 
-    if (openFile(_filename, fileContents, fileSize)) {
-      char* ptr;
-      _output = (strtol(fileContents, &ptr, 10));
-      return true;
+  template <class T>
+  size_t encodeBinary(const T& _input, uint8_t* _output) {
+    // Get the raw bits of the value regardless of type
+    uint64_t bits = 0;
+    if (binary_kind<T>::value == BINARY_FLOAT) {
+      memcpy(&bits, &_input, sizeof(T));
+    } else {
+      bits = (uint64_t)_input;
     }
-    return false;
+
+    // Write the header, value and checksum
+    _output[0] = BINARY_MAGIC;
+    _output[1] = binary_kind<T>::value | sizeof(T);
+    for (size_t i = 0; i < sizeof(T); i++) _output[2 + i] = bits >> (8 * i);
+    _output[2 + sizeof(T)] = crc8(_output, 2 + sizeof(T));
+    return 3 + sizeof(T);
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, float>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, double>::value,
-                                                 bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    char   fileContents[fileSize + 1];
-    memset(fileContents, 0x00, fileSize + 1);
 
-    if (openFile(_filename, fileContents, fileSize)) {
-      char* ptr;
-      _output = strtod(fileContents, &ptr);
-      return true;
+  inline bool validScalarTag(uint8_t _tag) {
+    // Only the sizes each kind is saved with, anything else is damaged or was not written by eSPIFFS
+    uint8_t size = _tag & 0x0F;
+    switch (_tag & 0xF0) {
+      case BINARY_BOOL:
+        return size == 1;
+      case BINARY_SIGNED:
+      case BINARY_UNSIGNED:
+        return size == 1 || size == 2 || size == 4 || size == 8;
+      case BINARY_FLOAT:
+        return size == sizeof(float) || size == sizeof(double);
+      default:
+        return false;
     }
-    return false;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
-                                                 bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    char   fileContents[fileSize + 1];
-    memset(fileContents, 0x00, fileSize + 1);
 
-    if (openFile(_filename, fileContents, fileSize)) {
-      char* ptr;
-      _output = strtol(fileContents, &ptr, 10);  //80us
-      return true;
+  template <class T>
+  bool decodeBits(uint8_t _tag, const uint8_t* _input, T& _output) {
+    // Rebuild a little endian value and convert it to the requested type
+    if (!validScalarTag(_tag)) return false;
+    uint8_t  kind = _tag & 0xF0;
+    uint8_t  size = _tag & 0x0F;
+    uint64_t bits = 0;
+    for (size_t i = 0; i < size; i++) bits |= (uint64_t)_input[i] << (8 * i);
+    if (kind == BINARY_FLOAT && size == sizeof(float)) {
+      float value;
+      uint32_t raw = bits;
+      memcpy(&value, &raw, sizeof(float));
+      _output = value;
+    } else if (kind == BINARY_FLOAT) {
+      double value;
+      memcpy(&value, &bits, sizeof(double));
+      _output = value;
+    } else if (kind == BINARY_SIGNED) {
+      if (size < 8 && (bits >> (8 * size - 1)) & 1) bits |= ~(uint64_t)0 << (8 * size);  // sign extend
+      _output = (int64_t)bits;
+    } else {
+      _output = bits;
     }
-    return false;
+    return true;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
-                                                 bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    char   fileContents[fileSize + 1];
-    memset(fileContents, 0x00, fileSize + 1);
 
-    if (openFile(_filename, fileContents, fileSize)) {
-      char* ptr;
-      _output = strtoul(fileContents, &ptr, 10);
-      return true;
-    }
-    return false;
+  template <class T>
+  bool decodeBinary(const uint8_t* _input, size_t _len, T& _output) {
+    // Check this is a complete binary value and not text
+    if (_len < 4 || _input[0] != BINARY_MAGIC) return false;
+    uint8_t size = _input[1] & 0x0F;
+    if (size > 8 || _len != 3u + size || crc8(_input, 2 + size) != _input[2 + size]) return false;
+    return decodeBits(_input[1], _input + 2, _output);
   }
+
+  // Types that can be saved in bulk - the scalar overloads plus plain structs that can be copied with memcpy
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
-                                                 bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    if (Effortless_SPIFFS_CHAR_SIZE > fileSize) {
-      static char fileContents[Effortless_SPIFFS_CHAR_SIZE];
-      memset(fileContents, 0x00, Effortless_SPIFFS_CHAR_SIZE);
+  struct is_bulk_scalar {
+    static const bool value = is_same<T, bool>::value || is_same<T, float>::value || is_same<T, double>::value ||
+                              is_same<T, signed char>::value || is_same<T, signed short>::value || is_same<T, signed int>::value ||
+                              is_same<T, signed long>::value || is_same<T, unsigned char>::value || is_same<T, unsigned short>::value ||
+                              is_same<T, unsigned int>::value || is_same<T, unsigned long>::value;
+  };
 
-      if (openFile(_filename, fileContents, fileSize)) {
-        _output = fileContents;
-        return true;
-      }
-    } else {
-      ESPIFFS_DEBUGLN("[openFromFile<char*>] - Internal static char buffer to small for file contents, set Effortless_SPIFFS_CHAR_SIZE larger if required (default 1024)");
-    }
+  template <class T>
+  struct is_std_array {
+    static const bool value = false;
+  };
+  template <class T, size_t N>
+  struct is_std_array<std::array<T, N> > {
+    static const bool value = true;
+  };
 
-    return false;
+  template <class T>
+  struct is_bulk_struct {
+    static const bool value = std::is_class<T>::value && std::is_trivially_copyable<T>::value && !is_std_array<T>::value
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+                              && !is_same<T, JsonObject>::value && !is_same<T, JsonArray>::value && !is_same<T, JsonVariant>::value
+#endif
+        ;
+  };
+
+  template <class T>
+  struct is_bulk_element {
+    static const bool value = is_bulk_scalar<T>::value || is_bulk_struct<T>::value;
+  };
+
+  // ArduinoJson documents, saved as their serialized text
+  template <class T>
+  struct is_json_document {
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+    static const bool value = is_same<T, DynamicJsonDocument>::value || is_same<T, JsonObject>::value || is_same<T, JsonArray>::value;
+#else
+    static const bool value = false;
+#endif
+  };
+
+  template <class T, bool Scalar = is_bulk_scalar<T>::value>
+  struct bulk_tag {
+    static const uint8_t value = binary_kind<T>::value | sizeof(T);
+  };
+  template <class T>
+  struct bulk_tag<T, false> {
+    static const uint8_t value = BINARY_STRUCT;
+  };
+
+  template <class T>
+  void encodeBlock(const T* _input, size_t _count, std::string& _output) {
+    // Elements are stored as they are in memory, little endian on every supported chip
+    size_t payloadSize = _count * sizeof(T);
+    _output.resize(BINARY_BLOCK_HEADER + payloadSize);
+    uint8_t* block = (uint8_t*)&_output[0];
+    block[0] = BINARY_MAGIC;
+    block[1] = BINARY_BLOCK | BINARY_BLOCK_VERSION;
+    block[2] = bulk_tag<T>::value;
+    block[3] = sizeof(T);
+    block[4] = sizeof(T) >> 8;
+    for (size_t i = 0; i < 4; i++) block[5 + i] = _count >> (8 * i);
+    if (payloadSize) memcpy(block + BINARY_BLOCK_HEADER, _input, payloadSize);
+    uint32_t crc = crc32(block + BINARY_BLOCK_HEADER, payloadSize, crc32(block, 9));
+    for (size_t i = 0; i < 4; i++) block[9 + i] = crc >> (8 * i);
   }
+
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
-                                                 bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    size_t fileSize = getFileSize(_filename);
-    char   fileContents[fileSize + 1];
-    memset(fileContents, 0x00, fileSize + 1);
+  typename enable_if<is_bulk_scalar<T>::value, bool>::type decodeElement(uint8_t _tag, const uint8_t* _input, T& _output) {
+    return _tag != BINARY_STRUCT && decodeBits(_tag, _input, _output);
+  }
+  template <class T>
+  typename enable_if<!is_bulk_scalar<T>::value, bool>::type decodeElement(uint8_t _tag, const uint8_t* _input, T& _output) {
+    if (_tag != BINARY_STRUCT) return false;
+    memcpy(&_output, _input, sizeof(T));
+    return true;
+  }
 
-    if (openFile(_filename, fileContents, fileSize)) {
-      _output = fileContents;
-      return true;
+  // Text numbers - integers through a two digit table, floats and doubles as the fewest digits that read back to the same
+  // value, laid out like printf("%.*g", Effortless_SPIFFS_PRECISION) so files stay readable by strtod and older versions
+  static const size_t NUMBER_TEXT_SIZE = Effortless_SPIFFS_PRECISION + 26;  // digits(17) + sign + point + exponent(5) + \0
+
+  inline const char* digitPairs() {
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    return pairs;
+  }
+  inline size_t formatUnsigned(char* _output, unsigned long _value, bool _negative) {
+    // Written backwards two digits at a time, then moved to the front
+    char  digits[24];
+    char* ptr = digits + sizeof(digits);
+    while (_value >= 100) {
+      const char* pair = digitPairs() + (_value % 100) * 2;
+      _value /= 100;
+      *--ptr = pair[1];
+      *--ptr = pair[0];
     }
-    return false;
+    if (_value >= 10) {
+      const char* pair = digitPairs() + _value * 2;
+      *--ptr = pair[1];
+      *--ptr = pair[0];
+    } else {
+      *--ptr = '0' + _value;
+    }
+    if (_negative) *--ptr = '-';
+    size_t len = digits + sizeof(digits) - ptr;
+    memcpy(_output, ptr, len);
+    _output[len] = '\0';
+    return len;
+  }
+  inline size_t formatNumber(char* _output, signed long _value) {
+    return formatUnsigned(_output, _value < 0 ? 0UL - (unsigned long)_value : (unsigned long)_value, _value < 0);
+  }
+  inline size_t formatNumber(char* _output, unsigned long _value) {
+    return formatUnsigned(_output, _value, false);
+  }
+
+  inline const char* skipSpace(const char* _input) {
+    while (*_input == ' ' || (*_input >= '\t' && *_input <= '\r')) _input++;
+    return _input;
   }
-#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value, bool>::type
-  openFromFile(const char* _filename, T& _output) {
-    File file = getFile(_filename, "r");
-    if (file) {
-      DeserializationError jsonError = deserializeJson(_output, file);
-      if (!jsonError) {
-        return true;
-      } else {
-        ESPIFFS_DEBUG("[openFromFile<DynamicJsonDocument>] - Failed to parse JSON: ");
-        ESPIFFS_DEBUG(jsonError.c_str());
-        ESPIFFS_DEBUG(" for file ");
-        ESPIFFS_DEBUGLN(_filename);
-      }
+  T parseInteger(const char* _input) {
+    // Same text and result as strtol and strtoul in base 10 for signed long and unsigned long, out of range values clamp
+    _input = skipSpace(_input);
+    bool negative = *_input == '-';
+    if (*_input == '-' || *_input == '+') _input++;
+    const bool          isSigned = T(-1) < T(0);
+    const unsigned long limit = isSigned ? (unsigned long)std::numeric_limits<T>::max() + negative : std::numeric_limits<T>::max();
+    unsigned long       value = 0;
+    bool                overflow = false;
+    for (uint8_t digit; (digit = (uint8_t)(*_input - '0')) < 10; _input++) {
+      overflow |= value > (limit - digit) / 10;
+      value = value * 10 + digit;
     }
-    return false;
+    if (overflow) return isSigned && negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    return (T)(negative ? 0UL - value : value);
   }
-#endif
 
- public:  // save value templates
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    char inputString[2];  // Bool string will be: "0" + \0
-    if (sprintf(inputString, "%d", _input)) {
-      if (saveFile(_filename, inputString)) {
-        return true;
-      }
+  struct FloatLayout;
+  template <>
+  struct FloatLayout<float> {
+    typedef uint32_t Bits;
+    static const int      MANTISSA_BITS = 23;
+    static const int      EXPONENT_BITS = 8;
+    static const int      BIAS = 127;
+    static const size_t   WORDS = 7;   // 2^157 is the largest value the digit search needs, plus the normal shift
+    static const uint64_t EXACT_MANTISSA = 1ULL << 24;
+    static const int      EXACT_POWER = 10;  // 10^10 is the largest power of ten a float holds exactly
+    static float parse(const char* _input) {
+      return strtof(_input, nullptr);
     }
-    return false;
+  };
+  template <>
+  struct FloatLayout<double> {
+    typedef uint64_t Bits;
+    static const int      MANTISSA_BITS = 52;
+    static const int      EXPONENT_BITS = 11;
+    static const int      BIAS = 1023;
+    static const size_t   WORDS = 36;  // 2^1080 is the largest value the digit search needs, plus the normal shift
+    static const uint64_t EXACT_MANTISSA = 1ULL << 53;
+    static const int      EXACT_POWER = 22;
+    static double parse(const char* _input) {
+      return strtod(_input, nullptr);
+    }
+  };
+
+  // Unsigned big number with just the operations the digit search needs, sized by the caller
+  template <size_t N>
+  class BigNumber {
+   public:
+    BigNumber() {}
+    explicit BigNumber(uint64_t _value) : used(0) {
+      words[0] = (uint32_t)_value;
+      words[1] = (uint32_t)(_value >> 32);
+      used = words[1] ? 2 : (words[0] ? 1 : 0);
+    }
+    size_t bits() const {
+      return used ? 32 * used - __builtin_clz(words[used - 1]) : 0;
+    }
+    uint64_t toU64() const {
+      return used == 0 ? 0 : (used == 1 ? words[0] : ((uint64_t)words[1] << 32 | words[0]));
+    }
+    void shiftLeft(size_t _bits) {
+      if (used == 0) return;
+      size_t   wordShift = _bits / 32;
+      uint32_t bitShift = _bits % 32;
+      if (bitShift) {
+        words[used + wordShift] = words[used - 1] >> (32 - bitShift);
+        for (size_t i = used - 1; i > 0; i--) words[i + wordShift] = (words[i] << bitShift) | (words[i - 1] >> (32 - bitShift));
+        words[wordShift] = words[0] << bitShift;
+        used++;
+      } else {
+        for (size_t i = used; i-- > 0;) words[i + wordShift] = words[i];
+      }
+      for (size_t i = 0; i < wordShift; i++) words[i] = 0;
+      used += wordShift;
+      trim();
+    }
+    void multiply(uint32_t _factor) {
+      uint64_t carry = 0;
+      for (size_t i = 0; i < used; i++) {
+        carry += (uint64_t)words[i] * _factor;
+        words[i] = (uint32_t)carry;
+        carry >>= 32;
+      }
+      if (carry) words[used++] = (uint32_t)carry;
+    }
+    void multiplyPow10(int _power) {
+      static const uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+      for (; _power >= 9; _power -= 9) multiply(1000000000);
+      if (_power) multiply(powers[_power]);
+    }
+    size_t normalShift() const {
+      // The shift that leaves 28 bits in the top word, so one divide of top words is at most two off in divideDigit
+      return (28 + 32 - (bits() - 1) % 32 - 1) % 32;
+    }
+    uint8_t divideDigit(const BigNumber& _divisor) {
+      // Only called with this < 10 * _divisor and _divisor normalised, this becomes the remainder
+      if (used < _divisor.used) return 0;
+      uint32_t digit = words[_divisor.used - 1] / (_divisor.words[_divisor.used - 1] + 1);
+      if (digit) subtractMultiple(_divisor, digit);
+      while (compare(*this, _divisor) >= 0) {
+        subtractMultiple(_divisor, 1);
+        digit++;
+      }
+      return digit;
+    }
+    static int compare(const BigNumber& _a, const BigNumber& _b) {
+      if (_a.used != _b.used) return _a.used < _b.used ? -1 : 1;
+      for (size_t i = _a.used; i-- > 0;) {
+        if (_a.words[i] != _b.words[i]) return _a.words[i] < _b.words[i] ? -1 : 1;
+      }
+      return 0;
+    }
+    static int compareSum(const BigNumber& _a, const BigNumber& _b, const BigNumber& _c) {
+      // Compares _a + _b against _c without keeping the sum
+      BigNumber sum;
+      size_t    len = _a.used > _b.used ? _a.used : _b.used;
+      uint64_t  carry = 0;
+      for (size_t i = 0; i < len; i++) {
+        carry += (uint64_t)(i < _a.used ? _a.words[i] : 0) + (i < _b.used ? _b.words[i] : 0);
+        sum.words[i] = (uint32_t)carry;
+        carry >>= 32;
+      }
+      if (carry) sum.words[len++] = 1;
+      sum.used = len;
+      return compare(sum, _c);
+    }
+
+   private:
+    void subtractMultiple(const BigNumber& _other, uint32_t _factor) {
+      uint64_t borrow = 0;
+      for (size_t i = 0; i < used; i++) {
+        uint64_t amount = (uint64_t)(i < _other.used ? _other.words[i] : 0) * _factor + borrow;
+        borrow = (amount >> 32) + (words[i] < (uint32_t)amount);
+        words[i] -= (uint32_t)amount;
+      }
+      trim();
+    }
+    void trim() {
+      while (used && words[used - 1] == 0) used--;
+    }
+    uint32_t words[N];
+    size_t   used = 0;
+  };
+
+  // The same operations on one 64 bit word, used whenever the scaled values are below 2^59
+  class SmallNumber {
+   public:
+    explicit SmallNumber(uint64_t _value) : value(_value) {}
+    void multiply(uint32_t _factor) {
+      value *= _factor;
+    }
+    uint8_t divideDigit(const SmallNumber& _divisor) {
+      uint8_t digit = value / _divisor.value;
+      value %= _divisor.value;
+      return digit;
+    }
+    static int compare(const SmallNumber& _a, const SmallNumber& _b) {
+      return _a.value < _b.value ? -1 : (_a.value > _b.value ? 1 : 0);
+    }
+    static int compareSum(const SmallNumber& _a, const SmallNumber& _b, const SmallNumber& _c) {
+      return compare(SmallNumber(_a.value + _b.value), _c);
+    }
+
+   private:
+    uint64_t value;
+  };
+
+  template <class Number>
+  size_t generateDigits(Number& _r, const Number& _s, Number& _mPlus, Number& _mMinus, bool _even, char* _digits) {
+    // Burger and Dybvig free format digits - stop as soon as the digits so far lie within half a unit of the value
+    size_t count = 0;
+    while (true) {
+      _r.multiply(10);
+      _mPlus.multiply(10);
+      _mMinus.multiply(10);
+      uint8_t digit = _r.divideDigit(_s);
+      int  low = Number::compare(_r, _mMinus);
+      int  high = Number::compareSum(_r, _mPlus, _s);
+      bool roundDown = _even ? low <= 0 : low < 0;
+      bool roundUp = _even ? high >= 0 : high > 0;
+      if (roundDown && roundUp) {
+        int half = Number::compareSum(_r, _r, _s);
+        roundDown = half < 0 || (half == 0 && (digit & 1) == 0);
+      }
+      if (roundDown || roundUp) {
+        _digits[count++] = '0' + digit + !roundDown;
+        return count;
+      }
+      _digits[count++] = '0' + digit;
+    }
+  }
+
+  template <class T>
+  size_t shortestDigits(T _value, char* _digits, int& _exponent) {
+    // Finite values above zero only, _digits gets at most 17 digits and the value is 0.<digits> * 10^_exponent
+    typedef FloatLayout<T>           Layout;
+    typedef BigNumber<Layout::WORDS> Big;
+
+    typename Layout::Bits raw;
+    memcpy(&raw, &_value, sizeof(raw));
+    uint64_t mantissa = raw & (((typename Layout::Bits)1 << Layout::MANTISSA_BITS) - 1);
+    int      biased = (int)(raw >> Layout::MANTISSA_BITS) & ((1 << Layout::EXPONENT_BITS) - 1);
+    int      exponent = (biased ? biased : 1) - Layout::BIAS - Layout::MANTISSA_BITS;
+    if (biased) mantissa |= 1ULL << Layout::MANTISSA_BITS;
+    bool even = (mantissa & 1) == 0;
+    bool lowerCloser = biased > 1 && mantissa == 1ULL << Layout::MANTISSA_BITS;
+
+    // Twice the value and the distances to its neighbours, over a common denominator s
+    Big r(mantissa), s(1), mPlus(1), mMinus(1);
+    if (exponent >= 0) {
+      r.shiftLeft(exponent + 1 + lowerCloser);
+      s.shiftLeft(1 + lowerCloser);
+      mPlus.shiftLeft(exponent + lowerCloser);
+      mMinus.shiftLeft(exponent);
+    } else {
+      r.shiftLeft(1 + lowerCloser);
+      s.shiftLeft(1 + lowerCloser - exponent);
+      mPlus.shiftLeft(lowerCloser);
+    }
+
+    // floor(log10(2) * n) is exact for this range of n, and puts k at or one below the real decimal exponent
+    int k = ((exponent + 64 - __builtin_clzll(mantissa) - 1) * 315653 >> 20) + 1;
+    if (k >= 0) {
+      s.multiplyPow10(k);
+    } else {
+      r.multiplyPow10(-k);
+      mPlus.multiplyPow10(-k);
+      mMinus.multiplyPow10(-k);
+    }
+    int high = Big::compareSum(r, mPlus, s);
+    if (even ? high >= 0 : high > 0) {
+      s.multiply(10);
+      k++;
+    }
+    _exponent = k;
+
+    if (s.bits() <= 59) {
+      SmallNumber smallR(r.toU64()), smallPlus(mPlus.toU64()), smallMinus(mMinus.toU64());
+      return generateDigits(smallR, SmallNumber(s.toU64()), smallPlus, smallMinus, even, _digits);
+    }
+    size_t shift = s.normalShift();
+    r.shiftLeft(shift);
+    s.shiftLeft(shift);
+    mPlus.shiftLeft(shift);
+    mMinus.shiftLeft(shift);
+    return generateDigits(r, s, mPlus, mMinus, even, _digits);
+  }
+
+  template <class T>
+  size_t formatFloat(char* _output, T _value) {
+    typename FloatLayout<T>::Bits raw;
+    memcpy(&raw, &_value, sizeof(raw));
+    char* ptr = _output;
+    if (raw >> (sizeof(raw) * 8 - 1)) {
+      *ptr++ = '-';
+      _value = -_value;
+    }
+    if (_value != _value || _value - _value != 0) {
+      memcpy(ptr, _value != _value ? "nan" : "inf", 4);
+      return ptr + 3 - _output;
+    }
+    if (_value == 0) {
+      memcpy(ptr, "0", 2);
+      return ptr + 1 - _output;
+    }
+
+    char   digits[20];
+    int    decimalExponent;
+    size_t count = shortestDigits(_value, digits, decimalExponent);
+    int    point = decimalExponent - 1;  // Exponent of the first digit, as %g decides on it
+    if (point < -4 || point >= Effortless_SPIFFS_PRECISION) {
+      *ptr++ = digits[0];
+      if (count > 1) {
+        *ptr++ = '.';
+        memcpy(ptr, digits + 1, count - 1);
+        ptr += count - 1;
+      }
+      *ptr++ = 'e';
+      *ptr++ = point < 0 ? '-' : '+';
+      unsigned magnitude = point < 0 ? -point : point;
+      if (magnitude >= 100) *ptr++ = '0' + magnitude / 100;
+      memcpy(ptr, digitPairs() + (magnitude % 100) * 2, 2);
+      ptr += 2;
+    } else if (point < 0) {
+      *ptr++ = '0';
+      *ptr++ = '.';
+      for (int i = point; i < -1; i++) *ptr++ = '0';
+      memcpy(ptr, digits, count);
+      ptr += count;
+    } else {
+      size_t whole = point + 1;
+      for (size_t i = 0; i < whole; i++) *ptr++ = i < count ? digits[i] : '0';
+      if (count > whole) {
+        *ptr++ = '.';
+        memcpy(ptr, digits + whole, count - whole);
+        ptr += count - whole;
+      }
+    }
+    *ptr = '\0';
+    return ptr - _output;
+  }
+  inline size_t formatNumber(char* _output, float _value) {
+    return formatFloat(_output, _value);
+  }
+  inline size_t formatNumber(char* _output, double _value) {
+    return formatFloat(_output, _value);
+  }
+
+  template <class T>
+  T parseFloat(const char* _input) {
+    // A mantissa and a power of ten the type holds exactly give a correctly rounded value from one multiply or divide,
+    // anything longer or larger, along with nan and inf, is left to strtod
+    typedef FloatLayout<T> Layout;
+    static const double    powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* ptr = skipSpace(_input);
+    bool        negative = *ptr == '-';
+    if (*ptr == '-' || *ptr == '+') ptr++;
+
+    uint64_t mantissa = 0;
+    int      significant = 0, exponent = 0;
+    bool     exact = true, anyDigits = false;
+    for (uint8_t digit; (digit = (uint8_t)(*ptr - '0')) < 10; ptr++) {
+      anyDigits = true;
+      if (significant < 19) {
+        mantissa = mantissa * 10 + digit;
+        significant += mantissa != 0;
+      } else {
+        exponent++;
+        exact &= digit == 0;
+      }
+    }
+    if (*ptr == '.') {
+      for (uint8_t digit; (digit = (uint8_t)(*++ptr - '0')) < 10;) {
+        anyDigits = true;
+        if (significant < 19) {
+          mantissa = mantissa * 10 + digit;
+          significant += mantissa != 0;
+          exponent--;
+        } else {
+          exact &= digit == 0;
+        }
+      }
+    }
+    if (!anyDigits) return Layout::parse(_input);
+    if (*ptr == 'e' || *ptr == 'E') {
+      const char* power = ptr + 1;
+      bool        negativePower = *power == '-';
+      if (*power == '-' || *power == '+') power++;
+      int value = 0;
+      for (uint8_t digit; (digit = (uint8_t)(*power - '0')) < 10; power++) {
+        if (value < 10000) value = value * 10 + digit;
+      }
+      if (power != ptr + 1 && (uint8_t)(power[-1] - '0') < 10) exponent += negativePower ? -value : value;
+    }
+
+    T value = 0;
+    if (mantissa == 0) {
+      value = 0;
+    } else if (exact && mantissa <= Layout::EXACT_MANTISSA && exponent >= -Layout::EXACT_POWER && exponent <= Layout::EXACT_POWER) {
+      value = (T)mantissa;
+      value = exponent < 0 ? value / (T)powers[-exponent] : value * (T)powers[exponent];
+    } else {
+      return Layout::parse(_input);
+    }
+    return negative ? -value : value;
+  }
+
+  // LZSS - a flag byte per 8 items, literals are one byte, matches are two bytes of 12 bit offset and 4 bit length
+  static const size_t LZ_WINDOW = 4096;
+  static const size_t LZ_MIN_MATCH = 3;
+  static const size_t LZ_MAX_MATCH = 18;
+
+  inline uint32_t lzHash(const uint8_t* _input) {
+    return ((_input[0] << 16 | _input[1] << 8 | _input[2]) * 2654435761u) >> (32 - Effortless_SPIFFS_LZ_HASH_BITS);
+  }
+
+  inline bool isCompressed(const uint8_t* _input, size_t _len) {
+    return _len >= BINARY_COMPRESSED_HEADER && _input[0] == BINARY_MAGIC && _input[1] == (BINARY_COMPRESSED | BINARY_COMPRESSED_VERSION);
+  }
+
+  inline void compressLZ(const uint8_t* _input, size_t _len, std::string& _output) {
+    // Match against the last position each 3 byte hash was seen, the input itself is the window
+    std::vector<uint32_t> lastSeen(1 << Effortless_SPIFFS_LZ_HASH_BITS, 0);
+    uint32_t              crc = crc32(_input, _len);
+    _output.clear();
+    _output.reserve(BINARY_COMPRESSED_HEADER + _len / 2);
+    _output += (char)BINARY_MAGIC;
+    _output += (char)(BINARY_COMPRESSED | BINARY_COMPRESSED_VERSION);
+    for (size_t i = 0; i < 4; i++) _output += (char)(_len >> (8 * i));
+    for (size_t i = 0; i < 4; i++) _output += (char)(crc >> (8 * i));
+
+    size_t  flagPosition = 0;
+    uint8_t flagBit = 8;
+    for (size_t position = 0; position < _len; flagBit++) {
+      if (flagBit == 8) {
+        flagPosition = _output.size();
+        _output += (char)0;
+        flagBit = 0;
+      }
+
+      size_t matchLength = 0;
+      size_t matchOffset = 0;
+      if (position + LZ_MIN_MATCH <= _len) {
+        uint32_t hash = lzHash(_input + position);
+        if (lastSeen[hash] && position - (lastSeen[hash] - 1) <= LZ_WINDOW) {
+          size_t candidate = lastSeen[hash] - 1;
+          size_t maxLength = _len - position < LZ_MAX_MATCH ? _len - position : LZ_MAX_MATCH;
+          while (matchLength < maxLength && _input[candidate + matchLength] == _input[position + matchLength]) matchLength++;
+          matchOffset = position - candidate;
+        }
+        lastSeen[hash] = position + 1;
+      }
+
+      if (matchLength >= LZ_MIN_MATCH) {
+        _output[flagPosition] |= 1 << flagBit;
+        _output += (char)((matchOffset - 1) & 0xFF);
+        _output += (char)(((matchOffset - 1) >> 8) << 4 | (matchLength - LZ_MIN_MATCH));
+        for (size_t i = 1; i < matchLength && position + i + LZ_MIN_MATCH <= _len; i++) lastSeen[lzHash(_input + position + i)] = position + i + 1;
+        position += matchLength;
+      } else {
+        _output += (char)_input[position++];
+      }
+    }
+  }
+
+  inline bool decompressLZ(const uint8_t* _input, size_t _len, std::string& _output) {
+    // Decode straight into the output, which doubles as the window
+    if (!isCompressed(_input, _len)) return false;
+    size_t   size = _input[2] | (_input[3] << 8) | ((uint32_t)_input[4] << 16) | ((uint32_t)_input[5] << 24);
+    uint32_t crc = _input[6] | (_input[7] << 8) | ((uint32_t)_input[8] << 16) | ((uint32_t)_input[9] << 24);
+    _output.resize(size);
+
+    size_t position = BINARY_COMPRESSED_HEADER;
+    size_t outputPosition = 0;
+    while (outputPosition < size && position < _len) {
+      uint8_t flags = _input[position++];
+      for (uint8_t bit = 0; bit < 8 && outputPosition < size; bit++) {
+        if (flags & (1 << bit)) {
+          if (position + 2 > _len) return false;
+          size_t offset = (_input[position] | (_input[position + 1] >> 4) << 8) + 1;
+          size_t length = (_input[position + 1] & 0x0F) + LZ_MIN_MATCH;
+          position += 2;
+          if (offset > outputPosition || length > size - outputPosition) return false;
+          for (size_t i = 0; i < length; i++, outputPosition++) _output[outputPosition] = _output[outputPosition - offset];
+        } else {
+          if (position >= _len) return false;
+          _output[outputPosition++] = _input[position++];
+        }
+      }
+    }
+    return outputPosition == size && crc32((const uint8_t*)_output.data(), size) == crc;
+  }
+
+  template <class T>
+  bool decodeBlocks(const uint8_t* _input, size_t _len, T* _output, size_t _capacity, size_t& _count) {
+    // Count the elements in every valid block, copying up to _capacity of them, stopping at a torn block left by an interrupted append
+    _count = 0;
+    size_t numBlocks = 0;
+    while (_len >= BINARY_BLOCK_HEADER && _input[0] == BINARY_MAGIC && _input[1] == (BINARY_BLOCK | BINARY_BLOCK_VERSION)) {
+      uint8_t  tag = _input[2];
+      size_t   elementSize = _input[3] | (_input[4] << 8);
+      uint32_t count = _input[5] | (_input[6] << 8) | ((uint32_t)_input[7] << 16) | ((uint32_t)_input[8] << 24);
+      uint32_t crc = _input[9] | (_input[10] << 8) | ((uint32_t)_input[11] << 16) | ((uint32_t)_input[12] << 24);
+
+      // Scalars convert between types, structs must be exactly the same size
+      bool sizeValid = tag == BINARY_STRUCT ? elementSize == sizeof(T) : (validScalarTag(tag) && elementSize == (tag & 0x0Fu));
+      if (!sizeValid || (tag == BINARY_STRUCT) != !is_bulk_scalar<T>::value) return false;
+      if (count > (_len - BINARY_BLOCK_HEADER) / elementSize) break;
+      size_t payloadSize = count * elementSize;
+      if (crc32(_input + BINARY_BLOCK_HEADER, payloadSize, crc32(_input, 9)) != crc) break;
+
+      // Copy straight across when the types match, otherwise convert each element
+      const uint8_t* payload = _input + BINARY_BLOCK_HEADER;
+      size_t         numToCopy = _count >= _capacity ? 0 : (_capacity - _count < count ? _capacity - _count : count);
+      if (tag == bulk_tag<T>::value) {
+        if (numToCopy) memcpy((void*)(_output + _count), payload, numToCopy * sizeof(T));
+      } else {
+        for (size_t i = 0; i < numToCopy; i++) {
+          if (!decodeElement(tag, payload + i * elementSize, _output[_count + i])) return false;
+        }
+      }
+      _count += count;
+      _input += BINARY_BLOCK_HEADER + payloadSize;
+      _len -= BINARY_BLOCK_HEADER + payloadSize;
+      numBlocks++;
+    }
+    return numBlocks > 0;
+  }
+  // Char buffer pool - Effortless_SPIFFS_CHAR_SIZE bytes split into slots shared by every char* read, allocated on first use
+  static const size_t CHAR_SLOT_SIZE = (Effortless_SPIFFS_CHAR_SIZE + Effortless_SPIFFS_CHAR_SLOTS - 1) / Effortless_SPIFFS_CHAR_SLOTS;
+  static_assert(Effortless_SPIFFS_CHAR_SLOTS >= 1 && Effortless_SPIFFS_CHAR_SLOTS <= 32, "Effortless_SPIFFS_CHAR_SLOTS must be between 1 and 32");
+
+  struct CharPool {
+    char*    memory = nullptr;
+    uint32_t used = 0;
+#if defined(ESP32)
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+  };
+  inline CharPool& charPool() {
+    static CharPool pool;
+    return pool;
+  }
+  struct CharPoolLock {
+    // Only held for a few instructions, never while reading a file
+#if defined(ESP32)
+    CharPoolLock() {
+      portENTER_CRITICAL(&charPool().lock);
+    }
+    ~CharPoolLock() {
+      portEXIT_CRITICAL(&charPool().lock);
+    }
+#else
+    CharPoolLock() {}  // Single threaded
+#endif
+  };
+  inline char* charPoolAcquire(size_t _numSlots, size_t& _firstSlot) {
+    // Borrow a run of adjacent free slots, or nullptr if there is none
+    CharPool& pool = charPool();
+    if (!_numSlots || _numSlots > Effortless_SPIFFS_CHAR_SLOTS) return nullptr;
+    char* memory;
+    {
+      CharPoolLock lock;
+      memory = pool.memory;
+    }
+    if (!memory) {
+      char* newMemory = (char*)malloc(Effortless_SPIFFS_CHAR_SLOTS * CHAR_SLOT_SIZE);
+      if (!newMemory) return nullptr;
+      {
+        CharPoolLock lock;
+        if (!pool.memory) {
+          pool.memory = newMemory;
+          newMemory = nullptr;
+        }
+        memory = pool.memory;
+      }
+      free(newMemory);
+    }
+
+    uint32_t     mask = _numSlots >= 32 ? 0xFFFFFFFF : (1UL << _numSlots) - 1;
+    CharPoolLock lock;
+    for (size_t slot = 0; slot + _numSlots <= Effortless_SPIFFS_CHAR_SLOTS; slot++) {
+      if (!(pool.used & (mask << slot))) {
+        pool.used |= mask << slot;
+        _firstSlot = slot;
+        return memory + slot * CHAR_SLOT_SIZE;
+      }
+    }
+    return nullptr;
+  }
+  inline void charPoolRelease(size_t _firstSlot, size_t _numSlots) {
+    uint32_t     mask = _numSlots >= 32 ? 0xFFFFFFFF : (1UL << _numSlots) - 1;
+    CharPoolLock lock;
+    charPool().used &= ~(mask << _firstSlot);
+  }
+
+  // File locks - every name hashes to one of Effortless_SPIFFS_LOCK_STRIPES reader writer locks shared by all instances
+  static_assert(Effortless_SPIFFS_LOCK_STRIPES >= 1 && Effortless_SPIFFS_LOCK_STRIPES <= 32, "Effortless_SPIFFS_LOCK_STRIPES must be between 1 and 32");
+  static const uint32_t ALL_STRIPES = (uint32_t)((1ULL << Effortless_SPIFFS_LOCK_STRIPES) - 1);
+
+  inline uint32_t stripeMask(const char* _filename) {
+    return 1UL << (hashName(_filename, strlen(_filename)) % Effortless_SPIFFS_LOCK_STRIPES);
+  }
+#if ESPIFFS_LOCKING
+  struct LockStripe {
+    // The gate is held by one writer or by the readers as a group, the writer can take it again while holding it
+    SemaphoreHandle_t         gate = xSemaphoreCreateBinary();
+    SemaphoreHandle_t         readersMutex = xSemaphoreCreateMutex();
+    std::atomic<TaskHandle_t> writer{nullptr};  // Only compared with the calling task, so relaxed is enough
+    uint32_t                  writeDepth = 0;
+    uint32_t                  readers = 0;
+    LockStripe() {
+      xSemaphoreGive(gate);
+    }
+  };
+  inline LockStripe* lockStripes() {
+    static LockStripe stripes[Effortless_SPIFFS_LOCK_STRIPES];
+    return stripes;
+  }
+  inline bool lockStripe(size_t _stripe, bool _write) {
+    // Returns true if the stripe was taken for writing, a read inside a write is counted as a write
+    LockStripe&  stripe = lockStripes()[_stripe];
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (stripe.writer.load(std::memory_order_relaxed) == self) {
+      stripe.writeDepth++;
+      return true;
+    }
+    if (_write) {
+      xSemaphoreTake(stripe.gate, portMAX_DELAY);
+      stripe.writer.store(self, std::memory_order_relaxed);
+      stripe.writeDepth = 1;
+      return true;
+    }
+    xSemaphoreTake(stripe.readersMutex, portMAX_DELAY);
+    if (stripe.readers++ == 0) xSemaphoreTake(stripe.gate, portMAX_DELAY);
+    xSemaphoreGive(stripe.readersMutex);
+    return false;
+  }
+  inline void unlockStripe(size_t _stripe, bool _write) {
+    LockStripe& stripe = lockStripes()[_stripe];
+    if (_write) {
+      if (--stripe.writeDepth == 0) {
+        stripe.writer.store(nullptr, std::memory_order_relaxed);
+        xSemaphoreGive(stripe.gate);
+      }
+      return;
+    }
+    xSemaphoreTake(stripe.readersMutex, portMAX_DELAY);
+    if (--stripe.readers == 0) xSemaphoreGive(stripe.gate);
+    xSemaphoreGive(stripe.readersMutex);
+  }
+
+  class RecursiveMutex {
+   public:
+    RecursiveMutex() : handle(xSemaphoreCreateRecursiveMutex()) {}
+    RecursiveMutex(const RecursiveMutex&) = delete;
+    RecursiveMutex& operator=(const RecursiveMutex&) = delete;
+    ~RecursiveMutex() {
+      vSemaphoreDelete(handle);
+    }
+    void lock() {
+      xSemaphoreTakeRecursive(handle, portMAX_DELAY);
+    }
+    void unlock() {
+      xSemaphoreGiveRecursive(handle);
+    }
+
+   private:
+    SemaphoreHandle_t handle;
+  };
+#endif
+}  // namespace Effortless_SPIFFS_Internal
+
+// Effortless SPIFFS Backends - the file system an eSPIFFSOn<Backend> keeps its files in
+#if defined(ESP8266)
+struct eSPIFFSLittleFS {
+  static const bool RENAME_REPLACES = true;  // Rename replaces an existing target atomically
+  static const char* name() {
+    return "LittleFS";
+  }
+  static fs::FS& fileSystem() {
+    return LittleFS;
+  }
+  static bool begin() {
+    return LittleFS.begin();
+  }
+  static void end() {
+    LittleFS.end();
+  }
+  static uint64_t totalBytes() {
+    FSInfo info;
+    return LittleFS.info(info) ? info.totalBytes : 0;
+  }
+};
+#elif defined(ESP32)
+struct eSPIFFSSPIFFS {
+  static const bool RENAME_REPLACES = false;
+  static const char* name() {
+    return "SPIFFS";
+  }
+  static fs::FS& fileSystem() {
+    return SPIFFS;
+  }
+  static bool begin() {
+    return SPIFFS.begin();
+  }
+  static void end() {
+    SPIFFS.end();
+  }
+  static uint64_t totalBytes() {
+    return SPIFFS.totalBytes();
+  }
+};
+#if defined(_LITTLEFS_H_)  // Include LittleFS.h before this library to use it
+struct eSPIFFSLittleFS {
+  static const bool RENAME_REPLACES = false;
+  static const char* name() {
+    return "LittleFS";
+  }
+  static fs::FS& fileSystem() {
+    return LittleFS;
+  }
+  static bool begin() {
+    return LittleFS.begin();
+  }
+  static void end() {
+    LittleFS.end();
+  }
+  static uint64_t totalBytes() {
+    return LittleFS.totalBytes();
+  }
+};
+#endif
+#if defined(_SD_H_)  // Include SD.h before this library to use it, call SD.begin() first for other pins
+struct eSPIFFSSD {
+  static const bool RENAME_REPLACES = false;
+  static const char* name() {
+    return "SD";
+  }
+  static fs::FS& fileSystem() {
+    return SD;
+  }
+  static bool begin() {
+    return SD.begin();
+  }
+  static void end() {
+    SD.end();
+  }
+  static uint64_t totalBytes() {
+    return SD.totalBytes();
+  }
+};
+#endif
+#endif
+
+#ifndef Effortless_SPIFFS_BACKEND
+#if defined(ESP8266)
+#define Effortless_SPIFFS_BACKEND eSPIFFSLittleFS
+#else
+#define Effortless_SPIFFS_BACKEND eSPIFFSSPIFFS
+#endif
+#endif
+
+// Main Effortless SPIFFS Class, stores files in the file system given by a backend.
+// Classes built on it pass themselves as Derived, and their saveFile, readText, beforeAccess and the like are then
+// called in place of these at compile time, without a vtable
+template <class Backend, class Derived = void>
+class eSPIFFSOn {
+ public:  // constructors
+  typedef Backend StorageBackend;
+  eSPIFFSOn(Print* _debug = nullptr) : printer(_debug) {}
+  ~eSPIFFSOn() {
+    if (cacheEnabled) flush();
+  }
+
+ public:  // spiffs access methods
+  inline bool checkFlashConfig() {
+    StateLock state(*this);
+    if (!flashSizeCorrect) {
+#if defined(ESP8266)
+      // Get actual flash size and size set in IDE
+      uint32_t realSize = ESP.getFlashChipRealSize();
+      uint32_t ideSize = ESP.getFlashChipSize();
+
+      // Tell the user the flash is incorrect if it is not
+      if (realSize < ideSize) {
+        ESPIFFS_STATS_FAIL(FLASH_CONFIG_FAILURE);
+        ESPIFFS_DEBUGLN("[checkFlashConfig] - Flash chip set to the incorrect size, correct size is; " + String(realSize));
+        return false;
+      }
+#endif
+
+      // Start the backend and check it has some space
+      ESPIFFS_STATS_COUNT(begins, 1);
+      if (Backend::begin()) {
+        if (Backend::totalBytes() > 0) {
+          // Change the boolean to true if the config is ok
+          flashSizeCorrect = true;
+        } else {
+          ESPIFFS_STATS_FAIL(FLASH_CONFIG_FAILURE);
+          ESPIFFS_DEBUG("[checkFlashConfig] - ");
+          ESPIFFS_DEBUG(Backend::name());
+          ESPIFFS_DEBUGLN(" size was set to 0, please select a size from the \"tools->flash size:\" menu or partition it");
+        }
+      } else {
+        ESPIFFS_STATS_FAIL(BEGIN_FAILURE);
+        ESPIFFS_DEBUG("[checkFlashConfig] - Failed to start ");
+        ESPIFFS_DEBUGLN(Backend::name());
+      }
+    }
+
+    // Return the boolean
+    return flashSizeCorrect;
+  }
+  bool mount() {
+    // Check the flash config once and keep the file system started, no file is touched by another task while leftovers are recovered
+    if (isMounted()) return true;
+    FileLock  lock(*this);
+    StateLock state(*this);
+    if (!mounted) {
+      if (checkFlashConfig()) {
+        mounted = true;
+        recoverAtomicSaves();
+        if (indexEnabled) buildIndex();
+      } else {
+        ESPIFFS_DEBUGLN("[mount] - Failed to mount file system");
+      }
+    }
+    return mounted;
+  }
+  void unmount() {
+    // Stop the file system and force the flash config to be checked again
+    FileLock  lock(*this);
+    StateLock state(*this);
+    if (mounted) {
+      Backend::end();
+      mounted = false;
+      flashSizeCorrect = false;
+      indexBuilt = false;
+      indexEntries.clear();
+    }
+  }
+  bool remount() {
+    self().unmount();
+    return mount();
+  }
+  inline bool isMounted() const {
+    StateLock state(*this);
+    return mounted;
+  }
+  inline int getFileSize(const char* _filename) {
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+
+    // Answer from the cache if the file is held in RAM
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) return entry->data.size();
+    }
+
+    // Then from the index if it covers the file
+    {
+      StateLock   state(*this);
+      IndexEntry* indexed;
+      if (indexLookup(_filename, indexed)) {
+        if (!indexed) return 0;
+        if (indexed->size != INDEX_UNKNOWN) return indexed->size;
+      }
+    }
+
+    // Open the file and return its size
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      return currentFile.size();
+    }
+    return 0;
+  }
+  bool exists(const char* _filename) {
+    // Answer from RAM where possible, otherwise ask the file system
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    if (cacheEnabled && cacheFind(_filename)) return true;
+    {
+      StateLock   state(*this);
+      IndexEntry* indexed;
+      if (indexLookup(_filename, indexed)) {
+        if (!indexed) return false;
+        if (indexed->size != INDEX_UNKNOWN) return true;
+      }
+    }
+    if (!startFileSystem()) return false;
+    ESPIFFS_STATS_COUNT(exists, 1);
+    return Backend::fileSystem().exists(_filename);
+  }
+  time_t getLastWrite(const char* _filename) {
+    // Time the file was last written if the file system keeps it, otherwise 0
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    {
+      StateLock   state(*this);
+      IndexEntry* indexed;
+      if (indexLookup(_filename, indexed)) {
+        if (!indexed) return 0;
+        if (indexed->size != INDEX_UNKNOWN) return indexed->time;
+      }
+    }
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      return currentFile.getLastWrite();
+    }
+    return 0;
+  }
+  File getFile(const char* _filename, const char* _readWrite) {
+    // Keep the cache coherent with callers using the file directly, the handle itself is not locked
+    self().beforeAccess(_filename, strcmp(_readWrite, "r") != 0);
+    FileLock lock(*this, _filename, strcmp(_readWrite, "r") != 0);
+    if (cacheEnabled) cacheSync(_filename, _readWrite);
+    return openFileHandle(_filename, _readWrite);
+  }
+  bool openFile(const char* _filename, char* _output, size_t _len = 0) {
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+
+    // Copy straight from the cache if the file is held in RAM
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        size_t numBytesToRead = (_len > 0 && _len <= entry->data.size()) ? _len : entry->data.size();
+        if (numBytesToRead) {
+          memcpy(_output, entry->data.data(), numBytesToRead);
+          return true;
+        }
+        ESPIFFS_STATS_FAIL(READ_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
+        ESPIFFS_DEBUGLN(_filename);
+        return false;
+      }
+    }
+
+    // Open it in read mode and check if its ok
+    File currentFile = openFileHandle(_filename, "r");  // 115us
+    if (currentFile) {
+      // Read the desired number of bytes from the array to the output buffer
+      size_t numBytesToRead = (_len > 0 && _len <= currentFile.size()) ? _len : currentFile.size();
+      if (currentFile.readBytes(_output, numBytesToRead)) {  // readBytes - 300us, readBytesUntil - 465us - goes up with larger strings
+        ESPIFFS_STATS_COUNT(bytesRead, numBytesToRead);
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(READ_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  bool saveFile(const char* _filename, const char* _input) {  // Total time is about 6000us for small strings
+    return self().saveFile(_filename, (const uint8_t*)_input, strlen(_input));
+  }
+  bool saveFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    ESPIFFS_STATS_TIMER(save);
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+
+    // Hold the contents in the cache and only mark them dirty if they changed
+    if (cacheEnabled && _len) {
+      if (cacheStore(_filename, (const char*)_input, _len, false)) return true;
+    }
+
+    // Open the file in write mode and check if open
+    bool atomic;
+    File currentFile = self().openForSave(_filename, atomic);
+    if (currentFile) {
+      // Write the input bytes to the file
+      if (_len && currentFile.write(_input, _len) == _len) {
+        ESPIFFS_STATS_COUNT(bytesWritten, _len);
+        return finishSave(_filename, currentFile, atomic, Effortless_SPIFFS_Internal::crc32(_input, _len));
+      } else {
+        ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+        ESPIFFS_DEBUG("[saveFile] - Failed to write any bytes to file: ");
+        ESPIFFS_DEBUGLN(_filename);
+        abortSave(_filename, currentFile, atomic);
+      }
+    }
+
+    return false;
+  }
+  bool appendFile(const char* _filename, const char* _input) {
+    return self().appendFile(_filename, (const uint8_t*)_input, strlen(_input));
+  }
+  bool appendFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    ESPIFFS_STATS_TIMER(append);
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+
+    // Append to the cached contents if the file is held in RAM
+    if (cacheEnabled && _len) {
+      if (cacheStore(_filename, (const char*)_input, _len, true)) return true;
+    }
+
+    // Open the file in write mode and check if open
+    File currentFile = openFileHandle(_filename, "a");
+    if (currentFile) {
+      // Write the input bytes to the file
+      if (_len && currentFile.write(_input, _len) == _len) {
+        ESPIFFS_STATS_COUNT(bytesWritten, _len);
+        indexSet(_filename, currentFile.size());
+        currentFile.close();
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+        ESPIFFS_DEBUG("[saveFile] - Failed to append any bytes to file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+
+ public:  // streaming methods
+  template <class F>
+  bool readFile(const char* _filename, F _callback) {
+    // The callback runs under a read lock so it must not write to files sharing its lock
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+
+    // Hand the contents to the callback in chunks, stopping early if it returns false
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        const uint8_t* data = (const uint8_t*)entry->data.data();
+        size_t         size = entry->data.size();
+        for (size_t offset = 0; offset < size; offset += Effortless_SPIFFS_CHUNK_SIZE) {
+          if (!_callback(data + offset, size - offset < Effortless_SPIFFS_CHUNK_SIZE ? size - offset : Effortless_SPIFFS_CHUNK_SIZE)) break;
+        }
+        return true;
+      }
+    }
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      uint8_t chunk[Effortless_SPIFFS_CHUNK_SIZE];
+      size_t  numBytesRead;
+      while ((numBytesRead = currentFile.read(chunk, sizeof(chunk))) > 0) {
+        ESPIFFS_STATS_COUNT(bytesRead, numBytesRead);
+        if (!_callback((const uint8_t*)chunk, numBytesRead)) break;
+      }
+      return true;
+    }
+    return false;
+  }
+
+ public:  // partial update methods
+  bool updateRange(const char* _filename, size_t _offset, const uint8_t* _input, size_t _len) {
+    // Overwrite bytes of an existing file in place, the file never grows and nothing else is rewritten
+    ESPIFFS_STATS_TIMER(update);
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+
+    // Patch the cached contents if the file is held in RAM
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheFind(_filename);
+      if (entry) {
+        if (!_len || _offset + _len > entry->data.size()) return rangeFailure(_filename);
+        if (memcmp(&entry->data[_offset], _input, _len) == 0) {
+          cacheStats.writesAvoided++;
+          return true;
+        }
+        memcpy(&entry->data[_offset], _input, _len);
+        entry->dirty = true;
+        if (cacheFlushDue()) return flush();
+        return true;
+      }
+    }
+
+    // Open for reading and writing so the rest of the file is kept, then seek to the range
+    File currentFile = openFileHandle(_filename, "r+");
+    if (currentFile) {
+      size_t fileSize = currentFile.size();
+      if (!_len || _offset + _len > fileSize) {
+        indexSet(_filename, fileSize);
+        return rangeFailure(_filename);
+      }
+      bool success = currentFile.seek(_offset) && currentFile.write(_input, _len) == _len;
+      indexSet(_filename, fileSize);
+      currentFile.close();
+      if (success) {
+        ESPIFFS_STATS_COUNT(bytesWritten, _len);
+        return true;
+      }
+      ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+      ESPIFFS_DEBUG("[updateRange] - Failed to write bytes to file: ");
+      ESPIFFS_DEBUGLN(_filename);
+    }
+    return false;
+  }
+  bool readRange(const char* _filename, size_t _offset, uint8_t* _output, size_t _len) {
+    // Read bytes from the middle of a file without reading the rest of it
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        if (!_len || _offset + _len > entry->data.size()) return rangeFailure(_filename);
+        memcpy(_output, &entry->data[_offset], _len);
+        return true;
+      }
+    }
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      if (!_len || _offset + _len > currentFile.size()) return rangeFailure(_filename);
+      if (currentFile.seek(_offset) && currentFile.read(_output, _len) == _len) {
+        ESPIFFS_STATS_COUNT(bytesRead, _len);
+        return true;
+      }
+      ESPIFFS_STATS_FAIL(READ_FAILURE);
+      ESPIFFS_DEBUG("[readRange] - Failed to read bytes from file: ");
+      ESPIFFS_DEBUGLN(_filename);
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+  updateField(const char* _filename, size_t _offset, const T& _input) {
+    // Fields are stored raw as laid out in memory, so only use them on files written the same way
+    return self().updateRange(_filename, _offset, (const uint8_t*)&_input, sizeof(T));
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+  readField(const char* _filename, size_t _offset, T& _output) {
+    return self().readRange(_filename, _offset, (uint8_t*)&_output, sizeof(T));
+  }
+
+ public:  // batch methods
+  struct BatchEntry {
+    std::string name;
+    std::string data;
+  };
+  bool saveFiles(const std::vector<BatchEntry>& _entries) {
+    // Saves every file or none of them, mounting once for the whole batch
+    ESPIFFS_STATS_TIMER(batch);
+    if (_entries.empty()) return true;
+    if (!mount()) return false;
+    uint32_t stripes = Effortless_SPIFFS_Internal::stripeMask(Effortless_SPIFFS_JOURNAL);
+    for (size_t i = 0; i < _entries.size(); i++) {
+      self().beforeAccess(_entries[i].name.c_str(), true);
+      stripes |= Effortless_SPIFFS_Internal::stripeMask(_entries[i].name.c_str());
+    }
+    FileLock lock(*this, stripes, true);
+
+    // Write and verify every file under a temporary name
+    size_t numWritten = 0;
+    for (; numWritten < _entries.size(); numWritten++) {
+      const BatchEntry& entry = _entries[numWritten];
+      std::string tempName = tempNameFor(entry.name.c_str());
+      File        tempFile = openFileHandle(tempName.c_str(), "w");
+      if (!tempFile) break;
+      bool written = tempFile.write((const uint8_t*)entry.data.data(), entry.data.size()) == entry.data.size();
+      ESPIFFS_STATS_COUNT(bytesWritten, entry.data.size());
+      tempFile.flush();
+      tempFile.close();
+      if (!written || !verifyFile(tempName.c_str(), Effortless_SPIFFS_Internal::crc32((const uint8_t*)entry.data.data(), entry.data.size()))) {
+        numWritten++;
+        break;
+      }
+    }
+
+    // Writing the journal is the commit point, after it every file will be swapped in even across a reset
+    bool committed = false;
+    if (numWritten == _entries.size()) {
+      std::string names;
+      for (size_t i = 0; i < _entries.size(); i++) {
+        if (i) names += '\n';
+        names += _entries[i].name;
+      }
+      uint32_t crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)names.data(), names.size());
+      uint8_t  trailer[4] = {(uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24)};
+      File     journal = openFileHandle(Effortless_SPIFFS_JOURNAL, "w");
+      if (journal) {
+        committed = journal.write((const uint8_t*)names.data(), names.size()) == names.size() && journal.write(trailer, 4) == 4;
+        ESPIFFS_STATS_COUNT(bytesWritten, names.size() + 4);
+        journal.flush();
+        journal.close();
+        committed = committed && verifyFile(Effortless_SPIFFS_JOURNAL, Effortless_SPIFFS_Internal::crc32(trailer, 4, crc));
+      }
+    }
+    if (!committed) {
+      ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+      ESPIFFS_DEBUGLN("[saveFiles] - Failed to write batch, no files were changed");
+      for (size_t i = 0; i < numWritten; i++) fsRemove(tempNameFor(_entries[i].name.c_str()).c_str());
+      fsRemove(Effortless_SPIFFS_JOURNAL);
+      return false;
+    }
+
+    // Cached contents are only dropped once the batch is committed, a failed batch keeps unsaved values
+    if (cacheEnabled) {
+      for (size_t i = 0; i < _entries.size(); i++) {
+        CacheEntry* cached = cacheFind(_entries[i].name.c_str());
+        if (cached) cacheErase(cached);
+      }
+    }
+
+    // Swap every file in and clear the journal
+    bool success = true;
+    for (size_t i = 0; i < _entries.size(); i++) {
+      if (swapIn(tempNameFor(_entries[i].name.c_str()).c_str(), _entries[i].name.c_str())) {
+        indexSet(_entries[i].name.c_str(), _entries[i].data.size());
+      } else {
+        success = false;
+      }
+    }
+    if (success) {
+      fsRemove(Effortless_SPIFFS_JOURNAL);
+    } else {
+      ESPIFFS_STATS_FAIL(RENAME_FAILURE);
+      ESPIFFS_DEBUGLN("[saveFiles] - Failed to swap in every file, the batch will be completed on the next mount");
+    }
+    return success;
+  }
+
+ public:  // file management methods
+  bool removeFile(const char* _filename) {
+    // Drop any cached contents then remove the file
+    ESPIFFS_STATS_TIMER(remove);
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheFind(_filename);
+      if (entry) cacheErase(entry);
+    }
+    if (startFileSystem()) {
+      if (fsRemove(_filename)) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(REMOVE_FAILURE);
+        ESPIFFS_DEBUG("[removeFile] - Failed to remove file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  bool renameFile(const char* _from, const char* _to) {
+    // Write back pending contents of the source and drop both from the cache
+    ESPIFFS_STATS_TIMER(rename);
+    self().beforeAccess(_from, true);
+    self().beforeAccess(_to, true);
+    FileLock lock(*this, _from, _to);
+    if (cacheEnabled) {
+      cacheSync(_from, "w");
+      cacheSync(_to, "w");
+    }
+    if (startFileSystem()) {
+      if (fsRename(_from, _to)) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(RENAME_FAILURE);
+        ESPIFFS_DEBUG("[renameFile] - Failed to rename file: ");
+        ESPIFFS_DEBUGLN(_from);
+      }
+    }
+    return false;
+  }
+
+ public:  // write back cache methods
+  struct CacheStats {
+    unsigned long hits = 0;           // Reads answered from RAM
+    unsigned long misses = 0;         // Reads that had to go to flash
+    unsigned long writesAvoided = 0;  // Saves that matched the cached contents
+    unsigned long flashWrites = 0;    // Dirty entries written back to flash
+    unsigned long evictions = 0;      // Entries dropped to stay within budget
+  };
+  void enableCache(size_t _budget = Effortless_SPIFFS_CACHE_SIZE, unsigned long _flushInterval = 0, size_t _flushCount = 0) {
+    // Budget is in bytes of names plus contents, interval in ms and count in dirty entries, change it before other tasks use the instance
+    CacheLock lock(*this);
+    cacheBudget = _budget;
+    cacheFlushInterval = _flushInterval;
+    cacheFlushCount = _flushCount;
+    cacheLastFlush = millis();
+    cacheEnabled = true;
+  }
+  void disableCache() {
+    CacheLock lock(*this);
+    flush();
+    cacheEntries.clear();
+    cacheEnabled = false;
+  }
+  bool flush() {
+    // Write every dirty entry back to flash in one pass
+    CacheLock lock(*this);
+    bool      success = true;
+    for (size_t i = 0; i < cacheEntries.size(); i++) {
+      if (cacheEntries[i].dirty && !cacheWriteBack(cacheEntries[i])) success = false;
+    }
+    cacheLastFlush = millis();
+    return success;
+  }
+  void handleCache() {
+    // Call from loop() to honour the flush interval when nothing is being saved
+    CacheLock lock(*this);
+    if (cacheEnabled && cacheFlushDue()) flush();
+  }
+  const CacheStats& getCacheStats() const {
+    return cacheStats;
+  }
+  void resetCacheStats() {
+    cacheStats = CacheStats();
+  }
+
+
+ public:  // metadata index methods
+  void enableIndex() {
+    // Keep the size and last write time of every file in RAM, built with one directory scan when mounted
+    StateLock state(*this);
+    indexEnabled = true;
+    if (mounted && !indexBuilt) buildIndex();
+  }
+  void disableIndex() {
+    StateLock state(*this);
+    indexEnabled = false;
+    indexBuilt = false;
+    std::vector<IndexEntry>().swap(indexEntries);
+    std::vector<uint32_t>().swap(indexCollisions);
+  }
+  size_t getIndexMemory() const {
+    StateLock state(*this);
+    return indexEntries.capacity() * sizeof(IndexEntry) + indexCollisions.capacity() * sizeof(uint32_t);
+  }
+
+#if Effortless_SPIFFS_STATS
+ public:  // statistics methods
+  enum Failure {
+    FLASH_CONFIG_FAILURE,  // Flash size or file system size is not set correctly
+    BEGIN_FAILURE,         // File system failed to start
+    NOT_FOUND_FAILURE,     // File did not exist when opening to read
+    OPEN_FAILURE,          // File could not be opened
+    READ_FAILURE,          // No bytes could be read
+    WRITE_FAILURE,         // Fewer bytes were written than requested
+    VERIFY_FAILURE,        // Saved file did not match what was written
+    RENAME_FAILURE,        // File could not be renamed or swapped in
+    REMOVE_FAILURE,        // File could not be removed
+    PARSE_FAILURE,         // File contents could not be parsed
+    RANGE_FAILURE,         // Range to read or update is not inside the file
+    NUM_FAILURES
+  };
+  struct OperationStats {
+    unsigned long count = 0;        // Calls made
+    unsigned long failures = 0;     // Calls that hit at least one failure
+    unsigned long totalMicros = 0;  // Time spent across all calls
+    unsigned long maxMicros = 0;    // Slowest single call
+  };
+  struct Stats {
+    OperationStats read;
+    OperationStats save;
+    OperationStats append;
+    OperationStats remove;
+    OperationStats rename;
+    OperationStats batch;
+    OperationStats update;
+    unsigned long  bytesRead = 0;
+    unsigned long  bytesWritten = 0;
+    unsigned long  opens = 0;
+    unsigned long  begins = 0;
+    unsigned long  exists = 0;
+    unsigned long  failures[NUM_FAILURES] = {};
+  };
+  Stats getStats() const {
+    // A copy, so it is consistent even while other tasks are recording
+    StateLock state(*this);
+    return stats;
+  }
+  void resetStats() {
+    StateLock state(*this);
+    stats = Stats();
+  }
+  void printStats(Print& _output) const {
+    static const char* const failureNames[NUM_FAILURES] = {"flash config", "begin", "not found", "open", "read", "write", "verify", "rename", "remove", "parse", "range"};
+    const char* const        operationNames[] = {"read", "save", "append", "remove", "rename", "batch", "update"};
+    const Stats              snapshot = getStats();
+    const OperationStats*    operations[] = {&snapshot.read, &snapshot.save, &snapshot.append, &snapshot.remove, &snapshot.rename, &snapshot.batch, &snapshot.update};
+
+    // operation: count, failures, total us, max us
+    for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+      _output.printf("%s: %lu calls, %lu failed, %lu us total, %lu us max\n", operationNames[i], operations[i]->count, operations[i]->failures,
+                     operations[i]->totalMicros, operations[i]->maxMicros);
+    }
+    _output.printf("bytes read: %lu, bytes written: %lu\n", snapshot.bytesRead, snapshot.bytesWritten);
+    _output.printf("opens: %lu, begins: %lu, exists: %lu\n", snapshot.opens, snapshot.begins, snapshot.exists);
+    for (size_t i = 0; i < NUM_FAILURES; i++) {
+      if (snapshot.failures[i]) _output.printf("%s failures: %lu\n", failureNames[i], snapshot.failures[i]);
+    }
+  }
+#endif
+
+ public:
+  enum Encoding {
+    TEXT_ENCODING,    // Human readable text, compatible with all versions
+    BINARY_ENCODING,  // Fixed width little endian value with type tag and crc
+  };
+  void setEncoding(Encoding _encoding) {
+    encoding = _encoding;
+  }
+  Encoding getEncoding() const {
+    return encoding;
+  }
+  void setAtomicSaves(bool _atomic) {
+    atomicSaves = _atomic;
+  }
+  void setCompression(bool _compress) {
+    compression = _compress;
+  }
+  bool getCompression() const {
+    return compression;
+  }
+  void setDebugOutput(Print* _debug) {
+    if (_debug) printer = _debug;
+  }
+  void clearDebugOutput() {
+    printer = nullptr;
+  }
+
+ public:  // char buffers
+  class CharBuffer {
+    // Holds one or more adjacent slots of the char pool until it is destroyed or released
+   public:
+    CharBuffer() {}
+    CharBuffer(CharBuffer&& _other) {
+      *this = std::move(_other);
+    }
+    CharBuffer& operator=(CharBuffer&& _other) {
+      if (this != &_other) {
+        release();
+        buffer = _other.buffer;
+        firstSlot = _other.firstSlot;
+        numSlots = _other.numSlots;
+        numChars = _other.numChars;
+        _other.buffer = nullptr;
+        _other.numSlots = 0;
+        _other.numChars = 0;
+      }
+      return *this;
+    }
+    CharBuffer(const CharBuffer&) = delete;
+    CharBuffer& operator=(const CharBuffer&) = delete;
+    ~CharBuffer() {
+      release();
+    }
+    char* data() {
+      return buffer;
+    }
+    const char* c_str() const {
+      return buffer ? buffer : "";
+    }
+    size_t length() const {
+      return numChars;
+    }
+    size_t capacity() const {
+      return numSlots * Effortless_SPIFFS_Internal::CHAR_SLOT_SIZE;
+    }
+    explicit operator bool() const {
+      return buffer != nullptr;
+    }
+    void release() {
+      if (buffer) Effortless_SPIFFS_Internal::charPoolRelease(firstSlot, numSlots);
+      buffer = nullptr;
+      numSlots = 0;
+      numChars = 0;
+    }
+
+   private:
+    friend class eSPIFFSOn;
+    bool acquire(size_t _bytes) {
+      release();
+      size_t slots = (_bytes + Effortless_SPIFFS_Internal::CHAR_SLOT_SIZE - 1) / Effortless_SPIFFS_Internal::CHAR_SLOT_SIZE;
+      buffer = Effortless_SPIFFS_Internal::charPoolAcquire(slots, firstSlot);
+      numSlots = buffer ? slots : 0;
+      return buffer != nullptr;
+    }
+    char*  buffer = nullptr;
+    size_t firstSlot = 0;
+    size_t numSlots = 0;
+    size_t numChars = 0;
+  };
+
+ public:  // open value templates
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    char   fileContents[Effortless_SPIFFS_VALUE_SIZE];
+    size_t fileSize = 0;
+
+    if (self().readValue(_filename, fileContents, sizeof(fileContents), fileSize)) {
+      if (Effortless_SPIFFS_Internal::decodeBinary((uint8_t*)fileContents, fileSize, _output)) return true;
+      _output = Effortless_SPIFFS_Internal::parseInteger<signed long>(fileContents) != 0;
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, float>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, double>::value,
+                                                 bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    char   fileContents[Effortless_SPIFFS_VALUE_SIZE];
+    size_t fileSize = 0;
+
+    if (self().readValue(_filename, fileContents, sizeof(fileContents), fileSize)) {
+      if (Effortless_SPIFFS_Internal::decodeBinary((uint8_t*)fileContents, fileSize, _output)) return true;
+      _output = Effortless_SPIFFS_Internal::parseFloat<T>(fileContents);
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
+                                                 bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    char   fileContents[Effortless_SPIFFS_VALUE_SIZE];
+    size_t fileSize = 0;
+
+    if (self().readValue(_filename, fileContents, sizeof(fileContents), fileSize)) {
+      if (Effortless_SPIFFS_Internal::decodeBinary((uint8_t*)fileContents, fileSize, _output)) return true;
+      _output = Effortless_SPIFFS_Internal::parseInteger<signed long>(fileContents);
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
+                                                 bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    char   fileContents[Effortless_SPIFFS_VALUE_SIZE];
+    size_t fileSize = 0;
+
+    if (self().readValue(_filename, fileContents, sizeof(fileContents), fileSize)) {
+      if (Effortless_SPIFFS_Internal::decodeBinary((uint8_t*)fileContents, fileSize, _output)) return true;
+      _output = Effortless_SPIFFS_Internal::parseInteger<unsigned long>(fileContents);
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
+                                                 bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    // The pointer stays valid until the next char* read by any eSPIFFS, use a CharBuffer to keep several
+    LegacyCharsLock lock;
+    CharBuffer&     fileContents = legacyChars();
+    fileContents.release();  // The previous result's slots are free for this read
+    if (!readChars(_filename, fileContents)) return false;
+    _output = fileContents.data();
+    return true;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, CharBuffer>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    return readChars(_filename, _output);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
+                                                 bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    T fileContents;
+    if (readDecoded(_filename, fileContents)) {
+      _output = std::move(fileContents);
+      return true;
+    }
+    return false;
+  }
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    return openJson(_filename, _output);
+  }
+#if ARDUINOJSON_VERSION_MINOR >= 15
+  template <class T, class F>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value, bool>::type
+  openFromFile(const char* _filename, T& _output, const F& _filter) {
+    // Only the fields set to true in the filter document are kept
+    return openJson(_filename, _output, DeserializationOption::Filter(_filter));
+  }
+#endif
+
+ private:  // json helpers
+  template <class T, class... Options>
+  bool openJson(const char* _filename, T& _output, Options... _options) {
+    // Readers share the lock, subclasses take anything more in beforeAccess before it is held
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    File     file = self().getFile(_filename, "r");
+    if (file) {
+      ESPIFFS_STATS_COUNT(bytesRead, file.size());
+      DeserializationError jsonError;
+      if (file.peek() == Effortless_SPIFFS_Internal::BINARY_MAGIC) {
+        // Compressed documents are expanded in RAM before parsing
+        std::string contents;
+        contents.resize(file.size());
+        contents.resize(file.read((uint8_t*)&contents[0], contents.size()));
+        file.close();
+        std::string decoded;
+        if (!Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)contents.data(), contents.size(), decoded)) {
+          ESPIFFS_STATS_FAIL(PARSE_FAILURE);
+          ESPIFFS_DEBUG("[openFromFile<DynamicJsonDocument>] - Failed to decompress file: ");
+          ESPIFFS_DEBUGLN(_filename);
+          return false;
+        }
+        std::string().swap(contents);
+        jsonError = deserializeJson(_output, decoded.data(), decoded.size(), _options...);
+      } else {
+        Effortless_SPIFFS_Internal::BufferedReader input(file);
+        jsonError = deserializeJson(_output, input, _options...);
+      }
+      if (!jsonError) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(PARSE_FAILURE);
+        ESPIFFS_DEBUG("[openFromFile<DynamicJsonDocument>] - Failed to parse JSON: ");
+        ESPIFFS_DEBUG(jsonError.c_str());
+        ESPIFFS_DEBUG(" for file ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+#endif
+
+ public:  // open bulk templates
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  openFromFile(const char* _filename, T (&_output)[N]) {
+    return openBlock(_filename, _output, N);
+  }
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  openFromFile(const char* _filename, std::array<T, N>& _output) {
+    return openBlock(_filename, _output.data(), N);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value &&
+                                                     !Effortless_SPIFFS_Internal::is_same<T, bool>::value,  // std::vector<bool> is packed
+                                                 bool>::type
+  openFromFile(const char* _filename, std::vector<T>& _output) {
+    // Size the vector from the block headers then fill it from the same read
+    std::string contents;
+    size_t      count;
+    if (self().readText(_filename, contents)) {
+      if (Effortless_SPIFFS_Internal::decodeBlocks((const uint8_t*)contents.data(), contents.size(), (T*)nullptr, 0, count)) {
+        _output.resize(count);
+        return Effortless_SPIFFS_Internal::decodeBlocks((const uint8_t*)contents.data(), contents.size(), _output.data(), count, count);
+      } else {
+        ESPIFFS_DEBUG("[openFromFile<std::vector>] - File does not hold a bulk block of this type: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_struct<T>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    return openBlock(_filename, &_output, 1);
+  }
+
+ public:  // save value templates
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    if (encoding == BINARY_ENCODING) return saveBinary(_filename, _input);
+    char inputString[2] = {_input ? '1' : '0', '\0'};
+    if (self().saveFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, float>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, double>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    if (encoding == BINARY_ENCODING) return saveBinary(_filename, _input);
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, _input);
+    if (self().saveFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    if (encoding == BINARY_ENCODING) return saveBinary(_filename, _input);
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, (signed long)_input);
+    if (self().saveFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    if (encoding == BINARY_ENCODING) return saveBinary(_filename, _input);
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, (unsigned long)_input);
+    if (self().saveFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T _input) {
+    if (self().saveFile(_filename, _input)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    if (compression) return saveCompressed(_filename, (const uint8_t*)_input.c_str(), _input.length());
+    if (self().saveFile(_filename, _input.c_str())) {
+      return true;
+    }
+    return false;
+  }
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, JsonObject>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, JsonArray>::value,
+                                                 bool>::type
+  saveToFile(const char* _filename, T& _input) {
+    ESPIFFS_STATS_TIMER(save);
+    if (compression) {
+      String json;
+      serializeJson(_input, json);
+      return saveCompressed(_filename, (const uint8_t*)json.c_str(), json.length());
+    }
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+    if (cacheEnabled) cacheSync(_filename, "w");
+    bool atomic;
+    File file = self().openForSave(_filename, atomic);
+    if (file) {
+      Effortless_SPIFFS_Internal::CrcPrint      output(file);
+      Effortless_SPIFFS_Internal::BufferedPrint buffered(output);
+      if (serializeJson(_input, buffered) && buffered.finish()) {
+        ESPIFFS_STATS_COUNT(bytesWritten, output.size());
+        return finishSave(_filename, file, atomic, output.value());
+      } else {
+        ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+        ESPIFFS_DEBUG("[saveToFile<DynamicJsonDocument>] - Failed to serialize JSON for file ");
+        ESPIFFS_DEBUGLN(_filename);
+        abortSave(_filename, file, atomic);
+      }
+    }
+    return false;
+  }
+#endif
+
+ public:  // save bulk templates
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  saveToFile(const char* _filename, const T (&_input)[N]) {
+    return saveBlock(_filename, _input, N, false);
+  }
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  saveToFile(const char* _filename, const std::array<T, N>& _input) {
+    return saveBlock(_filename, _input.data(), N, false);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value &&
+                                                     !Effortless_SPIFFS_Internal::is_same<T, bool>::value,  // std::vector<bool> is packed
+                                                 bool>::type
+  saveToFile(const char* _filename, const std::vector<T>& _input) {
+    return saveBlock(_filename, _input.data(), _input.size(), false);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_struct<T>::value, bool>::type
+  saveToFile(const char* _filename, const T& _input) {
+    return saveBlock(_filename, &_input, 1, false);
+  }
+
+ public:  // save value templates
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
+  appendToFile(const char* _filename, T& _input) {
+    char inputString[2] = {_input ? '1' : '0', '\0'};
+    if (self().appendFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
   }
   template <class T>
   typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, float>::value ||
                                                      Effortless_SPIFFS_Internal::is_same<T, double>::value,
                                                  bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    char inputString[Effortless_SPIFFS_PRECISION + 7];  // precision + decimal() + notation(4) + sign(1) + null(1)
-    if (sprintf(inputString, "%.*g", Effortless_SPIFFS_PRECISION, _input)) {
-      if (saveFile(_filename, inputString)) {
+  appendToFile(const char* _filename, T& _input) {
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, _input);
+    if (self().appendFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
+                                                 bool>::type
+  appendToFile(const char* _filename, T& _input) {
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, (signed long)_input);
+    if (self().appendFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
+                                                 bool>::type
+  appendToFile(const char* _filename, T& _input) {
+    char inputString[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+    Effortless_SPIFFS_Internal::formatNumber(inputString, (unsigned long)_input);
+    if (self().appendFile(_filename, inputString)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
+                                                 bool>::type
+  appendToFile(const char* _filename, T _input) {
+    if (self().appendFile(_filename, _input)) {
+      return true;
+    }
+    return false;
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
+                                                 bool>::type
+  appendToFile(const char* _filename, T& _input) {
+    if (self().saveFile(_filename, _input.c_str())) {
+      return true;
+    }
+    return false;
+  }
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, JsonObject>::value ||
+                                                     Effortless_SPIFFS_Internal::is_same<T, JsonArray>::value,
+                                                 bool>::type
+  appendToFile(const char* _filename, T& _input) {
+    ESPIFFS_STATS_TIMER(append);
+    self().beforeAccess(_filename, true);
+    FileLock lock(*this, _filename);
+    File     file = self().getFile(_filename, "a");
+    if (file) {
+      Effortless_SPIFFS_Internal::BufferedPrint buffered(file);
+      size_t                                    numBytesWritten = serializeJson(_input, buffered);
+      if (numBytesWritten && buffered.finish()) {
+        ESPIFFS_STATS_COUNT(bytesWritten, numBytesWritten);
+        file.close();
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+        ESPIFFS_DEBUG("[saveToFile<DynamicJsonDocument>] - Failed to serialize JSON for file ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+#endif
+
+ public:  // append bulk templates
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  appendToFile(const char* _filename, const T (&_input)[N]) {
+    return saveBlock(_filename, _input, N, true);
+  }
+  template <class T, size_t N>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value, bool>::type
+  appendToFile(const char* _filename, const std::array<T, N>& _input) {
+    return saveBlock(_filename, _input.data(), N, true);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_element<T>::value &&
+                                                     !Effortless_SPIFFS_Internal::is_same<T, bool>::value,  // std::vector<bool> is packed
+                                                 bool>::type
+  appendToFile(const char* _filename, const std::vector<T>& _input) {
+    return saveBlock(_filename, _input.data(), _input.size(), true);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_bulk_struct<T>::value, bool>::type
+  appendToFile(const char* _filename, const T& _input) {
+    return saveBlock(_filename, &_input, 1, true);
+  }
+
+ protected:  // single open read helpers
+  bool readValue(const char* _filename, char* _output, size_t _size, size_t& _fileSize) {
+    // Read up to _size - 1 bytes with a single open, null terminated, and report the full size
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        _fileSize = entry->data.size();
+        size_t numBytesRead = _fileSize < _size ? _fileSize : _size - 1;
+        memcpy(_output, entry->data.data(), numBytesRead);
+        _output[numBytesRead] = 0x00;
+        return numBytesRead > 0;
+      }
+    }
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      _fileSize = currentFile.size();
+      size_t numBytesRead = currentFile.read((uint8_t*)_output, _fileSize < _size ? _fileSize : _size - 1);
+      _output[numBytesRead] = 0x00;
+      ESPIFFS_STATS_COUNT(bytesRead, numBytesRead);
+      if (numBytesRead) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(READ_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  bool readText(const char* _filename, std::string& _output) {
+    // Size the string once and read straight into it
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        _output = entry->data;
+        return !_output.empty();
+      }
+    }
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      _output.resize(currentFile.size());
+      if (_output.size()) _output.resize(currentFile.read((uint8_t*)&_output[0], _output.size()));
+      ESPIFFS_STATS_COUNT(bytesRead, _output.size());
+      if (_output.size()) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(READ_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  bool readText(const char* _filename, String& _output) {
+    // Reserve the string once and append the file in chunks
+    ESPIFFS_STATS_TIMER(read);
+    self().beforeAccess(_filename, false);
+    FileLock lock(*this, _filename, false);
+    if (cacheEnabled) {
+      CacheEntry* entry = cacheGet(_filename);
+      if (entry) {
+        _output = entry->data.c_str();
+        return _output.length() > 0;
+      }
+    }
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      _output.reserve(currentFile.size());
+      char   chunk[Effortless_SPIFFS_CHUNK_SIZE + 1];
+      size_t numBytesRead;
+      while ((numBytesRead = currentFile.read((uint8_t*)chunk, Effortless_SPIFFS_CHUNK_SIZE)) > 0) {
+        chunk[numBytesRead] = 0x00;
+        _output += chunk;
+      }
+      ESPIFFS_STATS_COUNT(bytesRead, _output.length());
+      if (_output.length()) {
+        return true;
+      } else {
+        ESPIFFS_STATS_FAIL(READ_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to read any bytes from file: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
+    }
+    return false;
+  }
+  bool startFileSystem() {
+    if (isMounted()) return true;
+    StateLock state(*this);
+    if (checkFlashConfig()) {
+      ESPIFFS_STATS_COUNT(begins, 1);
+      if (Backend::begin()) return true;
+      ESPIFFS_STATS_FAIL(BEGIN_FAILURE);
+      ESPIFFS_DEBUGLN("[startFileSystem] - Failed to start file system");
+    }
+    return false;
+  }
+
+ protected:  // atomic save helpers - write "name~<crc of name>", verify, then replace "name" (via "name^<crc of data>" where rename cannot replace)
+  File openForSave(const char* _filename, bool& _atomic, bool _requireAtomic = false) {
+    // Write to a temporary file unless atomic saves are off or the name is too long
+    _atomic = false;
+    if (atomicSaves || _requireAtomic) {
+      std::string tempName = tempNameFor(_filename);
+      File        tempFile = openFileHandle(tempName.c_str(), "w");
+      if (tempFile) {
+        _atomic = true;
+        return tempFile;
+      }
+      if (_requireAtomic) return File();
+      ESPIFFS_DEBUG("[openForSave] - Falling back to a direct write for: ");
+      ESPIFFS_DEBUGLN(_filename);
+    }
+    return openFileHandle(_filename, "w");
+  }
+  bool finishSave(const char* _filename, File& _file, bool _atomic, uint32_t _crc) {
+    _file.flush();
+    size_t size = _file.size();
+    _file.close();
+    if (!_atomic) {
+      indexSet(_filename, size);
+      return true;
+    }
+
+    // Read the temporary file back and check it matches what was written before the original is removed, a rename that
+    // replaces the original swaps in every byte the writes reported or nothing, so there the check is left out
+    std::string tempName = tempNameFor(_filename);
+    if (!Backend::RENAME_REPLACES && !verifyFile(tempName.c_str(), _crc)) {
+      ESPIFFS_STATS_FAIL(VERIFY_FAILURE);
+      ESPIFFS_DEBUG("[finishSave] - Verification failed, keeping the original file: ");
+      ESPIFFS_DEBUGLN(_filename);
+      fsRemove(tempName.c_str());
+      return false;
+    }
+
+    // Swap the verified file in
+    if (Backend::RENAME_REPLACES) {
+      if (swapIn(tempName.c_str(), _filename)) {
+        indexSet(_filename, size);
         return true;
       }
+    } else {
+      std::string verifiedName = Effortless_SPIFFS_Internal::markedName(_filename, '^', _crc);
+      if (fsRename(tempName.c_str(), verifiedName.c_str())) {
+        if (swapIn(verifiedName.c_str(), _filename)) {
+          indexSet(_filename, size);
+          return true;
+        }
+      }
+    }
+    ESPIFFS_STATS_FAIL(RENAME_FAILURE);
+    ESPIFFS_DEBUG("[finishSave] - Failed to replace file: ");
+    ESPIFFS_DEBUGLN(_filename);
+    return false;
+  }
+  void abortSave(const char* _filename, File& _file, bool _atomic) {
+    _file.close();
+    if (_atomic) fsRemove(tempNameFor(_filename).c_str());
+  }
+  static std::string tempNameFor(const char* _filename) {
+    // An unverified save is marked with the crc32 of its own target name
+    return Effortless_SPIFFS_Internal::markedName(_filename, '~', Effortless_SPIFFS_Internal::crc32((const uint8_t*)_filename, strlen(_filename)));
+  }
+  bool verifyFile(const char* _filename, uint32_t _crc) {
+    File currentFile = openFileHandle(_filename, "r");
+    if (currentFile) {
+      uint8_t  chunk[Effortless_SPIFFS_CHUNK_SIZE];
+      size_t   numBytesRead;
+      uint32_t crc = 0;
+      while ((numBytesRead = currentFile.read(chunk, sizeof(chunk))) > 0) {
+        ESPIFFS_STATS_COUNT(bytesRead, numBytesRead);
+        crc = Effortless_SPIFFS_Internal::crc32(chunk, numBytesRead, crc);
+      }
+      return crc == _crc;
+    }
+    return false;
+  }
+  bool swapIn(const char* _from, const char* _filename) {
+    // Backends whose rename replaces the target do it atomically
+    if (!Backend::RENAME_REPLACES) fsRemove(_filename);
+    return fsRename(_from, _filename);
+  }
+
+ private:  // directory helpers
+  template <class F>
+  void forEachFile(F _callback) {
+    // Call back with the full path, size and last write time of every file in the root directory
+#if defined(ESP8266)
+    Dir dir = Backend::fileSystem().openDir("/");
+    while (dir.next()) {
+      String name = dir.fileName();
+      _callback(name.c_str()[0] == '/' ? std::string(name.c_str()) : "/" + std::string(name.c_str()), dir.fileSize(), dir.fileTime());
+    }
+#else
+    File root = Backend::fileSystem().open("/");
+    File file = root.openNextFile();
+    while (file) {
+      const char* name = file.name();
+      _callback(name[0] == '/' ? std::string(name) : "/" + std::string(name), file.size(), file.getLastWrite());
+      file = root.openNextFile();
+    }
+#endif
+  }
+  void recoverAtomicSaves() {
+    // Only names made by an atomic save are touched, collected first so the directory is not changed while listing it
+    std::vector<std::string> tempFiles;
+    std::vector<std::string> verifiedFiles;
+    bool                     journal = false;
+    forEachFile([&](const std::string& _name, size_t, time_t) {
+      std::string target;
+      uint32_t    crc;
+      if (Effortless_SPIFFS_Internal::parseMarkedName(_name, '~', target, crc)) {
+        if (tempNameFor(target.c_str()) == _name) tempFiles.push_back(_name);
+      } else if (Effortless_SPIFFS_Internal::parseMarkedName(_name, '^', target, crc)) {
+        verifiedFiles.push_back(_name);
+      }
+      if (_name == Effortless_SPIFFS_JOURNAL) journal = true;
+    });
+
+    // A complete journal means a batch was committed, so its verified files are swapped in before the rest are cleaned up
+    if (journal) {
+      std::string names;
+      if (readText(Effortless_SPIFFS_JOURNAL, names) && names.size() > 4) {
+        const uint8_t* trailer = (const uint8_t*)names.data() + names.size() - 4;
+        uint32_t       crc = trailer[0] | (trailer[1] << 8) | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+        names.resize(names.size() - 4);
+        if (Effortless_SPIFFS_Internal::crc32((const uint8_t*)names.data(), names.size()) == crc) {
+          for (size_t start = 0, end; start < names.size(); start = end + 1) {
+            end = names.find('\n', start);
+            if (end == std::string::npos) end = names.size();
+            std::string target = names.substr(start, end - start);
+            std::string tempName = tempNameFor(target.c_str());
+            for (size_t i = 0; i < tempFiles.size(); i++) {
+              if (tempFiles[i] == tempName && swapIn(tempName.c_str(), target.c_str())) {
+                tempFiles.erase(tempFiles.begin() + i);
+                ESPIFFS_DEBUG("[mount] - Completed interrupted batch save: ");
+                ESPIFFS_DEBUGLN(target.c_str());
+                break;
+              }
+            }
+          }
+        }
+      }
+      fsRemove(Effortless_SPIFFS_JOURNAL);
+    }
+
+    // Unverified saves are dropped, leaving the original untouched
+    for (size_t i = 0; i < tempFiles.size(); i++) {
+      fsRemove(tempFiles[i].c_str());
+      ESPIFFS_DEBUG("[mount] - Removed incomplete save: ");
+      ESPIFFS_DEBUGLN(tempFiles[i].c_str());
+    }
+
+    // Verified saves were interrupted while swapping in, they are only finished if the contents still match the crc in the name
+    if (Backend::RENAME_REPLACES) return;
+    for (size_t i = 0; i < verifiedFiles.size(); i++) {
+      std::string target;
+      uint32_t    crc;
+      Effortless_SPIFFS_Internal::parseMarkedName(verifiedFiles[i], '^', target, crc);
+      if (verifyFile(verifiedFiles[i].c_str(), crc)) {
+        fsRemove(target.c_str());
+        fsRename(verifiedFiles[i].c_str(), target.c_str());
+        ESPIFFS_DEBUG("[mount] - Completed interrupted save: ");
+        ESPIFFS_DEBUGLN(target.c_str());
+      }
+    }
+  }
+
+ private:  // file access
+  bool rangeFailure(const char* _filename) {
+    ESPIFFS_STATS_FAIL(RANGE_FAILURE);
+    ESPIFFS_DEBUG("[range] - Range is not inside the file: ");
+    ESPIFFS_DEBUGLN(_filename);
+    return false;
+  }
+  template <class T>
+  bool saveBinary(const char* _filename, const T& _input) {
+    uint8_t inputBytes[Effortless_SPIFFS_Internal::BINARY_MAX_SIZE];
+    size_t  inputLen = Effortless_SPIFFS_Internal::encodeBinary(_input, inputBytes);
+    return self().saveFile(_filename, inputBytes, inputLen);
+  }
+  bool readChars(const char* _filename, CharBuffer& _output) {
+    // Read into a single slot first and only borrow adjacent slots if the file needs them
+    size_t fileSize = 0;
+    if (!_output.acquire(1)) {
+      ESPIFFS_DEBUGLN("[openFromFile<char*>] - Every char buffer is in use, release a CharBuffer or set Effortless_SPIFFS_CHAR_SLOTS larger");
+      return false;
+    }
+    if (!self().readValue(_filename, _output.buffer, _output.capacity(), fileSize)) {
+      _output.release();
+      return false;
+    }
+    if (fileSize >= _output.capacity()) {
+      if (!_output.acquire(fileSize + 1)) {
+        ESPIFFS_DEBUGLN("[openFromFile<char*>] - Not enough free char buffer for file contents, set Effortless_SPIFFS_CHAR_SIZE larger if required (default 1024)");
+        return false;
+      }
+      if (!self().readValue(_filename, _output.buffer, _output.capacity(), fileSize) || fileSize >= _output.capacity()) {
+        _output.release();
+        return false;
+      }
+    }
+    _output.numChars = strlen(_output.buffer);
+    return true;
+  }
+  bool saveCompressed(const char* _filename, const uint8_t* _input, size_t _len) {
+    // Only keep the compressed form if it is actually smaller
+    if (_len >= Effortless_SPIFFS_COMPRESS_MIN) {
+      std::string compressed;
+      Effortless_SPIFFS_Internal::compressLZ(_input, _len, compressed);
+      if (compressed.size() < _len) return self().saveFile(_filename, (const uint8_t*)compressed.data(), compressed.size());
+    }
+    return self().saveFile(_filename, _input, _len);
+  }
+  bool readDecoded(const char* _filename, std::string& _output) {
+    // Read text, expanding it if it was saved compressed
+    if (!self().readText(_filename, _output)) return false;
+    if (!Effortless_SPIFFS_Internal::isCompressed((const uint8_t*)_output.data(), _output.size())) return true;
+    std::string decoded;
+    if (Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)_output.data(), _output.size(), decoded)) {
+      _output = std::move(decoded);
+      return true;
+    }
+    ESPIFFS_STATS_FAIL(PARSE_FAILURE);
+    ESPIFFS_DEBUG("[openFromFile] - Failed to decompress file: ");
+    ESPIFFS_DEBUGLN(_filename);
+    return false;
+  }
+  bool readDecoded(const char* _filename, String& _output) {
+    // Text stops at the first null so a compressed file is read again as bytes, only the header is needed to spot it
+    if (!self().readText(_filename, _output)) return false;
+    if (_output.length() < 2 || (uint8_t)_output[0] != Effortless_SPIFFS_Internal::BINARY_MAGIC ||
+        (uint8_t)_output[1] != (Effortless_SPIFFS_Internal::BINARY_COMPRESSED | Effortless_SPIFFS_Internal::BINARY_COMPRESSED_VERSION)) {
+      return true;
+    }
+    std::string decoded;
+    if (!readDecoded(_filename, decoded)) return false;
+    _output = decoded.c_str();
+    return true;
+  }
+  template <class T>
+  bool saveBlock(const char* _filename, const T* _input, size_t _count, bool _append) {
+    // Build the whole block so it is written with a single call, an append adds a new block after the existing ones
+    std::string block;
+    Effortless_SPIFFS_Internal::encodeBlock(_input, _count, block);
+    if (_append) return self().appendFile(_filename, (const uint8_t*)block.data(), block.size());
+    return self().saveFile(_filename, (const uint8_t*)block.data(), block.size());
+  }
+  template <class T>
+  bool openBlock(const char* _filename, T* _output, size_t _count) {
+    // Read the file once and only fill the output if it holds exactly the expected number of elements
+    std::string contents;
+    size_t      count;
+    if (self().readText(_filename, contents)) {
+      const uint8_t* data = (const uint8_t*)contents.data();
+      if (Effortless_SPIFFS_Internal::decodeBlocks(data, contents.size(), (T*)nullptr, 0, count) && count == _count) {
+        return Effortless_SPIFFS_Internal::decodeBlocks(data, contents.size(), _output, _count, count);
+      } else {
+        ESPIFFS_DEBUG("[openFromFile] - File does not hold a bulk block of this type and size: ");
+        ESPIFFS_DEBUGLN(_filename);
+      }
     }
     return false;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
-                                                 bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    char inputString[15];  // signed long string will be 11 digits + \0
-    if (sprintf(inputString, "%li", (signed long)_input)) {
-      if (saveFile(_filename, inputString)) {
-        return true;
+  File openFileHandle(const char* _filename, const char* _readWrite) {
+    // When mounted the config is already verified so go straight to open
+    if (isMounted()) {
+      // A file the index has never seen is not on flash, so skip asking the file system
+      bool reading = strcmp(_readWrite, "r") == 0;
+      if (reading && indexMissing(_filename)) {
+        ESPIFFS_STATS_FAIL(NOT_FOUND_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - File does not exist: ");
+        ESPIFFS_DEBUGLN(_filename);
+        return File();
+      }
+      ESPIFFS_STATS_COUNT(opens, 1);
+      File currentFile = Backend::fileSystem().open(_filename, _readWrite);  // 115us
+      if (currentFile) {
+        // Anything written through the handle is not seen by the index
+        if (!reading) indexSet(_filename, INDEX_UNKNOWN);
+        return currentFile;
+      } else {
+        ESPIFFS_STATS_FAIL(OPEN_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to open file: ");
+        ESPIFFS_DEBUGLN(_filename);
       }
+      return File();
     }
-    return false;
+
+    // Check if the flash config is set correctly, starting the file system from one task at a time
+    StateLock state(*this);
+    if (checkFlashConfig()) {  // 5us
+      // Check if the spiffs starts correctly
+      ESPIFFS_STATS_COUNT(begins, 1);
+      if (Backend::begin()) {  // 5us
+        // Check if the file exists
+        bool reading = strcmp(_readWrite, "r") == 0;
+        ESPIFFS_STATS_COUNT(exists, reading);
+        if (reading ? Backend::fileSystem().exists(_filename) : true) {  // 49us
+          // Open it in read mode and check if its ok
+          ESPIFFS_STATS_COUNT(opens, 1);
+          File currentFile = Backend::fileSystem().open(_filename, _readWrite);  // 115us
+          if (currentFile) {
+            return currentFile;
+          } else {
+            ESPIFFS_STATS_FAIL(OPEN_FAILURE);
+            ESPIFFS_DEBUG("[openFile] - Failed to open file");
+            ESPIFFS_DEBUGLN(_filename);
+          }
+        } else {
+          ESPIFFS_STATS_FAIL(NOT_FOUND_FAILURE);
+          ESPIFFS_DEBUG("[openFile] - File does not exist: ");
+          ESPIFFS_DEBUGLN(_filename);
+        }
+      } else {
+        ESPIFFS_STATS_FAIL(BEGIN_FAILURE);
+        ESPIFFS_DEBUG("[openFile] - Failed to start ");
+        ESPIFFS_DEBUGLN(Backend::name());
+      }
+    }
+    return File();
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
-                                                 bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    char inputString[15];  // unsigned long string will be 10 digits + \0
-    if (sprintf(inputString, "%lu", (unsigned long)_input)) {
-      if (saveFile(_filename, inputString)) {
-        return true;
+
+ private:  // write back cache
+  struct CacheEntry {
+    std::string   name;
+    std::string   data;
+    bool          dirty = false;
+    unsigned long lastUsed = 0;
+  };
+  CacheEntry* cacheFind(const char* _filename) {
+    for (size_t i = 0; i < cacheEntries.size(); i++) {
+      if (cacheEntries[i].name == _filename) {
+        cacheEntries[i].lastUsed = ++cacheTick;
+        return &cacheEntries[i];
       }
     }
-    return false;
+    return nullptr;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
-                                                 bool>::type
-  saveToFile(const char* _filename, T _input) {
-    if (saveFile(_filename, _input)) {
-      return true;
+  CacheEntry* cacheGet(const char* _filename) {
+    // Return the cached entry, loading it from flash on a miss if it fits the budget
+    CacheEntry* entry = cacheFind(_filename);
+    if (entry) {
+      cacheStats.hits++;
+      return entry;
     }
-    return false;
+    cacheStats.misses++;
+
+    File currentFile = openFileHandle(_filename, "r");
+    if (!currentFile) return nullptr;
+    size_t fileSize = currentFile.size();
+    if (!cacheReserve(strlen(_filename) + fileSize)) return nullptr;
+
+    CacheEntry newEntry;
+    newEntry.name = _filename;
+    newEntry.data.resize(fileSize);
+    ESPIFFS_STATS_COUNT(bytesRead, fileSize);
+    if (fileSize && currentFile.read((uint8_t*)&newEntry.data[0], fileSize) != fileSize) {
+      ESPIFFS_STATS_FAIL(READ_FAILURE);
+      ESPIFFS_DEBUG("[cacheGet] - Failed to read file into cache: ");
+      ESPIFFS_DEBUGLN(_filename);
+      return nullptr;
+    }
+    newEntry.lastUsed = ++cacheTick;
+    cacheEntries.push_back(newEntry);
+    return &cacheEntries.back();
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
-                                                 bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    if (saveFile(_filename, _input.c_str())) {
+  bool cacheStore(const char* _filename, const char* _input, size_t _len, bool _append) {
+    // Appends only go through the cache if the file is already held in RAM
+    CacheEntry* entry = _append ? cacheFind(_filename) : cacheGet(_filename);
+    if (!entry && _append) return false;
+
+    // Skip the write entirely if the contents have not changed
+    if (entry && !_append && entry->data.size() == _len && memcmp(entry->data.data(), _input, _len) == 0) {
+      cacheStats.writesAvoided++;
       return true;
     }
-    return false;
+
+    // Make room for the new contents, writing through if they can never fit
+    size_t oldSize = entry ? entry->name.size() + entry->data.size() : 0;
+    size_t newSize = strlen(_filename) + (_append ? entry->data.size() : 0) + _len;
+    if (newSize > cacheBudget) {
+      if (entry) {
+        if (entry->dirty && !cacheWriteBack(*entry)) return false;
+        cacheErase(entry);
+      }
+      return false;
+    }
+    if (newSize > oldSize) {
+      std::string name = _filename;
+      if (!cacheReserve(newSize - oldSize, _filename)) return false;
+      entry = cacheFind(name.c_str());
+    }
+
+    // Store the new contents and mark them for writing
+    if (!entry) {
+      cacheEntries.push_back(CacheEntry());
+      entry = &cacheEntries.back();
+      entry->name = _filename;
+      entry->lastUsed = ++cacheTick;
+    }
+    if (_append) {
+      entry->data.append(_input, _len);
+    } else {
+      entry->data.assign(_input, _len);
+    }
+    entry->dirty = true;
+
+    // Flush if the policy says so
+    if (cacheFlushDue()) return flush();
+    return true;
   }
-#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, JsonObject>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, JsonArray>::value,
-                                                 bool>::type
-  saveToFile(const char* _filename, T& _input) {
-    File file = getFile(_filename, "w");
-    if (file) {
-      if (serializeJson(_input, file)) {
-        file.close();
-        return true;
+  bool cacheReserve(size_t _bytes, const char* _keep = nullptr) {
+    // Evict least recently used entries until the requested bytes fit in the budget
+    if (_bytes > cacheBudget) return false;
+    while (cacheUsage() + _bytes > cacheBudget) {
+      CacheEntry* oldest = nullptr;
+      for (size_t i = 0; i < cacheEntries.size(); i++) {
+        if (_keep && cacheEntries[i].name == _keep) continue;
+        if (!oldest || cacheEntries[i].lastUsed < oldest->lastUsed) oldest = &cacheEntries[i];
+      }
+      if (!oldest) return false;
+      if (oldest->dirty && !cacheWriteBack(*oldest)) return false;
+      cacheErase(oldest);
+      cacheStats.evictions++;
+    }
+    return true;
+  }
+  void cacheSync(const char* _filename, const char* _readWrite) {
+    // Write back pending contents and drop the entry if the file is about to change
+    CacheEntry* entry = cacheFind(_filename);
+    if (entry) {
+      if (entry->dirty) cacheWriteBack(*entry);
+      if (strcmp(_readWrite, "r") != 0) cacheErase(entry);
+    }
+  }
+  bool cacheWriteBack(CacheEntry& _entry) {
+    bool atomic;
+    File currentFile = self().openForSave(_entry.name.c_str(), atomic);
+    if (currentFile) {
+      const uint8_t* data = (const uint8_t*)_entry.data.data();
+      if (currentFile.write(data, _entry.data.size()) == _entry.data.size()) {
+        ESPIFFS_STATS_COUNT(bytesWritten, _entry.data.size());
+        if (finishSave(_entry.name.c_str(), currentFile, atomic, Effortless_SPIFFS_Internal::crc32(data, _entry.data.size()))) {
+          _entry.dirty = false;
+          cacheStats.flashWrites++;
+          return true;
+        }
       } else {
-        ESPIFFS_DEBUG("[saveToFile<DynamicJsonDocument>] - Failed to serialize JSON for file ");
-        ESPIFFS_DEBUGLN(_filename);
+        ESPIFFS_STATS_FAIL(WRITE_FAILURE);
+        ESPIFFS_DEBUG("[flush] - Failed to write cached contents to file: ");
+        ESPIFFS_DEBUGLN(_entry.name.c_str());
+        abortSave(_entry.name.c_str(), currentFile, atomic);
       }
     }
     return false;
   }
-#endif
+  void cacheErase(CacheEntry* _entry) {
+    cacheEntries.erase(cacheEntries.begin() + (_entry - &cacheEntries[0]));
+  }
+  size_t cacheUsage() const {
+    size_t usage = 0;
+    for (size_t i = 0; i < cacheEntries.size(); i++) usage += cacheEntries[i].name.size() + cacheEntries[i].data.size();
+    return usage;
+  }
+  bool cacheFlushDue() const {
+    size_t dirtyCount = 0;
+    for (size_t i = 0; i < cacheEntries.size(); i++) dirtyCount += cacheEntries[i].dirty;
+    if (!dirtyCount) return false;
+    if (cacheFlushCount && dirtyCount >= cacheFlushCount) return true;
+    return cacheFlushInterval && millis() - cacheLastFlush >= cacheFlushInterval;
+  }
 
- public:  // save value templates
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, bool>::value, bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    char inputString[2];  // Bool string will be: "0" + \0
-    if (sprintf(inputString, "%d", _input)) {
-      if (appendFile(_filename, inputString)) {
-        return true;
+
+ private:  // metadata index - two hashes of the name, size and last write time of each file in the root directory, 16 bytes per file
+  struct IndexEntry {
+    uint32_t hash;   // FNV-1a, the sort key
+    uint32_t check;  // crc32, tells apart names that share the sort key
+    uint32_t size;
+    uint32_t time;
+  };
+  static const uint32_t INDEX_UNKNOWN = 0xFFFFFFFF;  // Size of a file opened for writing by hand, ask the file system
+
+  void buildIndex() {
+    // Names that share a hash are left to the file system
+    StateLock state(*this);
+    indexEntries.clear();
+    indexCollisions.clear();
+    forEachFile([&](const std::string& _name, size_t _size, time_t _time) {
+      IndexEntry entry = {Effortless_SPIFFS_Internal::hashName(_name.data(), _name.size()),
+                          Effortless_SPIFFS_Internal::crc32((const uint8_t*)_name.data(), _name.size()), (uint32_t)_size, (uint32_t)_time};
+      indexEntries.push_back(entry);
+    });
+    std::sort(indexEntries.begin(), indexEntries.end(), [](const IndexEntry& _a, const IndexEntry& _b) { return _a.hash < _b.hash; });
+    for (size_t i = 1; i < indexEntries.size();) {
+      if (indexEntries[i].hash == indexEntries[i - 1].hash) {
+        if (indexCollisions.empty() || indexCollisions.back() != indexEntries[i].hash) indexCollisions.push_back(indexEntries[i].hash);
+        indexEntries.erase(indexEntries.begin() + i);
+      } else {
+        i++;
       }
     }
-    return false;
+    indexEntries.shrink_to_fit();
+    indexBuilt = true;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, float>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, double>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    char inputString[Effortless_SPIFFS_PRECISION + 7];  // precision + decimal() + notation(4) + sign(1) + null(1)
-    if (sprintf(inputString, "%.*g", Effortless_SPIFFS_PRECISION, _input)) {
-      if (appendFile(_filename, inputString)) {
-        return true;
+  size_t indexPosition(uint32_t _hash) const {
+    // First entry with a hash not less than the one given
+    size_t low = 0;
+    size_t high = indexEntries.size();
+    while (low < high) {
+      size_t middle = (low + high) / 2;
+      if (indexEntries[middle].hash < _hash) {
+        low = middle + 1;
+      } else {
+        high = middle;
       }
     }
-    return false;
+    return low;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, signed char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, signed long>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    char inputString[15];  // signed long string will be 11 digits + \0
-    if (sprintf(inputString, "%li", (signed long)_input)) {
-      if (appendFile(_filename, inputString)) {
-        return true;
+  bool indexLookup(const char* _filename, IndexEntry*& _entry) {
+    // Returns false if the index cannot answer for the file, otherwise sets the entry or nullptr if it does not exist, hold the state lock while using it
+    _entry = nullptr;
+    if (!indexBuilt || _filename[0] != '/' || strchr(_filename + 1, '/')) return false;
+    uint32_t hash = Effortless_SPIFFS_Internal::hashName(_filename, strlen(_filename));
+    for (size_t i = 0; i < indexCollisions.size(); i++) {
+      if (indexCollisions[i] == hash) return false;
+    }
+    // An entry for another name means this one does not exist, saving it would have made the hash a collision
+    size_t position = indexPosition(hash);
+    if (position < indexEntries.size() && indexEntries[position].hash == hash &&
+        indexEntries[position].check == Effortless_SPIFFS_Internal::crc32((const uint8_t*)_filename, strlen(_filename))) {
+      _entry = &indexEntries[position];
+    }
+    return true;
+  }
+  bool indexMissing(const char* _filename) {
+    StateLock   state(*this);
+    IndexEntry* entry;
+    return indexLookup(_filename, entry) && !entry;
+  }
+  void indexSet(const char* _filename, uint32_t _size, uint32_t _time = 0) {
+    StateLock   state(*this);
+    IndexEntry* entry;
+    if (!indexLookup(_filename, entry)) return;
+    if (!entry) {
+      // A new file whose hash another file already has leaves both to the file system from now on
+      IndexEntry newEntry = {Effortless_SPIFFS_Internal::hashName(_filename, strlen(_filename)),
+                             Effortless_SPIFFS_Internal::crc32((const uint8_t*)_filename, strlen(_filename)), 0, 0};
+      size_t     position = indexPosition(newEntry.hash);
+      if (position < indexEntries.size() && indexEntries[position].hash == newEntry.hash) {
+        indexCollisions.push_back(newEntry.hash);
+        indexEntries.erase(indexEntries.begin() + position);
+        return;
       }
+      entry = &*indexEntries.insert(indexEntries.begin() + position, newEntry);
     }
-    return false;
+    entry->size = _size;
+    entry->time = _time ? _time : (uint32_t)time(nullptr);
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, unsigned char>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned int>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned short>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, unsigned long>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    char inputString[15];  // unsigned long string will be 10 digits + \0
-    if (sprintf(inputString, "%lu", (unsigned long)_input)) {
-      if (appendFile(_filename, inputString)) {
-        return true;
+  void indexErase(const char* _filename) {
+    StateLock   state(*this);
+    IndexEntry* entry;
+    if (indexLookup(_filename, entry) && entry) indexEntries.erase(indexEntries.begin() + (entry - &indexEntries[0]));
+  }
+  bool fsRemove(const char* _filename) {
+    // Every remove and rename goes through these so the index follows the file system
+    if (!Backend::fileSystem().remove(_filename)) return false;
+    indexErase(_filename);
+    return true;
+  }
+  bool fsRename(const char* _from, const char* _to) {
+    if (!Backend::fileSystem().rename(_from, _to)) return false;
+    StateLock   state(*this);
+    IndexEntry* entry;
+    IndexEntry  moved = {0, 0, INDEX_UNKNOWN, 0};
+    if (indexLookup(_from, entry) && entry) moved = *entry;
+    indexErase(_from);
+    indexSet(_to, moved.size, moved.time);
+    return true;
+  }
+
+#if Effortless_SPIFFS_STATS
+ private:  // statistics
+  // Every update takes the state lock, so tasks sharing an instance can record at the same time
+  class StatsTimer {
+   public:
+    // Only the outermost operation of each task is recorded so nested calls are not counted twice
+    StatsTimer(eSPIFFSOn& _fileSystem, OperationStats& _operation) : task(statsTask()), fileSystem(_fileSystem), operation(_operation) {
+      StateLock state(fileSystem);
+      outermost = !fileSystem.statsActiveTimer();
+      if (outermost) fileSystem.statsActive.push_back(this);
+      start = micros();
+    }
+    ~StatsTimer() {
+      if (!outermost) return;
+      unsigned long elapsed = micros() - start;
+      StateLock     state(fileSystem);
+      operation.count++;
+      operation.failures += failed;
+      operation.totalMicros += elapsed;
+      if (elapsed > operation.maxMicros) operation.maxMicros = elapsed;
+      fileSystem.statsActive.erase(std::find(fileSystem.statsActive.begin(), fileSystem.statsActive.end(), this));
+    }
+    bool        failed = false;
+    const void* task;
+
+   private:
+    eSPIFFSOn&      fileSystem;
+    OperationStats& operation;
+    unsigned long   start;
+    bool            outermost;
+  };
+  static const void* statsTask() {
+#if ESPIFFS_LOCKING
+    return xTaskGetCurrentTaskHandle();
+#else
+    return nullptr;
+#endif
+  }
+  StatsTimer* statsActiveTimer() {
+    // The outermost timer of the calling task, the state lock must be held
+    const void* task = statsTask();
+    for (size_t i = 0; i < statsActive.size(); i++) {
+      if (statsActive[i]->task == task) return statsActive[i];
+    }
+    return nullptr;
+  }
+  void statsCount(unsigned long Stats::*_counter, unsigned long _amount) {
+    StateLock state(*this);
+    stats.*_counter += _amount;
+  }
+  void statsFailure(Failure _reason) {
+    StateLock   state(*this);
+    StatsTimer* timer = statsActiveTimer();
+    stats.failures[_reason]++;
+    if (timer) timer->failed = true;
+  }
+  Stats                    stats;
+  std::vector<StatsTimer*> statsActive;
+#endif
+
+ protected:  // derived class access
+  typedef typename std::conditional<std::is_void<Derived>::value, eSPIFFSOn, Derived>::type Self;
+  Self& self() {
+    return static_cast<Self&>(*this);
+  }
+
+ protected:  // file locks - operations on one file are serialised against writers of it, files on different stripes run in parallel
+  void beforeAccess(const char*, bool) {
+    // Called before any lock is taken with the kind of access that follows, take extra file locks here rather than in getFile or openForSave
+  }
+  class FileLock {
+   public:
+    FileLock(eSPIFFSOn& _fileSystem, const char* _filename, bool _write = true)
+        : FileLock(_fileSystem, Effortless_SPIFFS_Internal::stripeMask(_filename), _write) {}
+    FileLock(eSPIFFSOn& _fileSystem, const char* _first, const char* _second)
+        : FileLock(_fileSystem, Effortless_SPIFFS_Internal::stripeMask(_first) | Effortless_SPIFFS_Internal::stripeMask(_second), true) {}
+    explicit FileLock(eSPIFFSOn& _fileSystem) : FileLock(_fileSystem, Effortless_SPIFFS_Internal::ALL_STRIPES, true) {}
+#if ESPIFFS_LOCKING
+    FileLock(eSPIFFSOn& _fileSystem, uint32_t _stripes, bool _write) : fileSystem(_fileSystem), stripes(_stripes) {
+      // The cache is shared by every file so while it is on one task uses the instance at a time
+      if (fileSystem.cacheEnabled) {
+        cached = true;
+        fileSystem.cacheMutex.lock();
+        return;
+      }
+      // Stripes are always taken in ascending order so two tasks never wait on each other
+      for (size_t i = 0; i < Effortless_SPIFFS_LOCK_STRIPES; i++) {
+        if ((stripes & (1UL << i)) && Effortless_SPIFFS_Internal::lockStripe(i, _write)) written |= 1UL << i;
       }
     }
-    return false;
+    ~FileLock() {
+      if (cached) {
+        fileSystem.cacheMutex.unlock();
+        return;
+      }
+      for (size_t i = Effortless_SPIFFS_LOCK_STRIPES; i-- > 0;) {
+        if (stripes & (1UL << i)) Effortless_SPIFFS_Internal::unlockStripe(i, written & (1UL << i));
+      }
+    }
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+   private:
+    eSPIFFSOn& fileSystem;
+    uint32_t stripes;
+    uint32_t written = 0;
+    bool     cached = false;
+#else
+    FileLock(eSPIFFSOn&, uint32_t, bool) {}  // Single threaded or locks turned off
+#endif
+  };
+
+ private:  // legacy char* reads - one buffer shared by every instance, its lock is taken before the cache lock
+  static CharBuffer& legacyChars() {
+    Effortless_SPIFFS_Internal::charPool();  // Constructed first so the pool outlives the buffer
+    static CharBuffer buffer;
+    return buffer;
+  }
+#if ESPIFFS_LOCKING
+  struct LegacyCharsLock {
+    LegacyCharsLock() {
+      mutex().lock();
+    }
+    ~LegacyCharsLock() {
+      mutex().unlock();
+    }
+    static Effortless_SPIFFS_Internal::RecursiveMutex& mutex() {
+      static Effortless_SPIFFS_Internal::RecursiveMutex legacyMutex;
+      return legacyMutex;
+    }
+  };
+#else
+  struct LegacyCharsLock {
+    LegacyCharsLock() {}  // Single threaded
+  };
+#endif
+
+ private:  // instance locks - the cache lock is taken before any file lock, the state lock is only held briefly after them
+#if ESPIFFS_LOCKING
+  struct CacheLock {
+    CacheLock(const eSPIFFSOn& _fileSystem) : fileSystem(_fileSystem) {
+      fileSystem.cacheMutex.lock();
+    }
+    ~CacheLock() {
+      fileSystem.cacheMutex.unlock();
+    }
+    const eSPIFFSOn& fileSystem;
+  };
+  struct StateLock {
+    StateLock(const eSPIFFSOn& _fileSystem) : fileSystem(_fileSystem) {
+      fileSystem.stateMutex.lock();
+    }
+    ~StateLock() {
+      fileSystem.stateMutex.unlock();
+    }
+    const eSPIFFSOn& fileSystem;
+  };
+  mutable Effortless_SPIFFS_Internal::RecursiveMutex cacheMutex;
+  mutable Effortless_SPIFFS_Internal::RecursiveMutex stateMutex;
+#else
+  struct CacheLock {
+    CacheLock(const eSPIFFSOn&) {}
+  };
+  struct StateLock {
+    StateLock(const eSPIFFSOn&) {}
+  };
+#endif
+
+ protected:  // debug output
+  Print* printer = nullptr;
+
+ private:  // storage
+  bool     flashSizeCorrect = false;
+  bool     mounted = false;
+  Encoding encoding = TEXT_ENCODING;
+  bool     atomicSaves = Effortless_SPIFFS_ATOMIC_SAVES;
+  bool     compression = Effortless_SPIFFS_COMPRESSION;
+
+  bool                    cacheEnabled = false;
+  size_t                  cacheBudget = 0;
+  unsigned long           cacheFlushInterval = 0;
+  size_t                  cacheFlushCount = 0;
+  unsigned long           cacheLastFlush = 0;
+  unsigned long           cacheTick = 0;
+  CacheStats              cacheStats;
+  std::vector<CacheEntry> cacheEntries;
+
+  bool                    indexEnabled = false;
+  bool                    indexBuilt = false;
+  std::vector<IndexEntry> indexEntries;
+  std::vector<uint32_t>   indexCollisions;
+};
+
+// eSPIFFS on the default backend, the one every other class in the library builds on, a class so it can still be forward declared
+class eSPIFFS : public eSPIFFSOn<Effortless_SPIFFS_BACKEND> {
+ public:  // constructors
+  using eSPIFFSOn<Effortless_SPIFFS_BACKEND>::eSPIFFSOn;
+};
+
+// Stages saves in RAM and commits them to a file system all at once, FileSystem is eSPIFFS or any eSPIFFSOn
+template <class FileSystem>
+class eSPIFFSBatchOn {
+ public:  // constructors
+  typedef typename FileSystem::BatchEntry BatchEntry;
+  eSPIFFSBatchOn(FileSystem& _fileSystem, Print* _debug = nullptr) : fileSystem(_fileSystem), staging(_fileSystem, entries, _debug) {}
+  ~eSPIFFSBatchOn() {}
+
+ public:  // batch methods
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<!Effortless_SPIFFS_Internal::is_json_document<T>::value, bool>::type
+  stage(const char* _filename, T& _input) {
+    // Any value saveToFile takes, encoded exactly as the file system would save it
+    staging.useSettingsOf(fileSystem);
+    return staging.saveToFile(_filename, _input);
   }
   template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, char*>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, const char*>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T _input) {
-    if (appendFile(_filename, _input)) {
-      return true;
+  typename Effortless_SPIFFS_Internal::enable_if<!Effortless_SPIFFS_Internal::is_json_document<T>::value, bool>::type
+  stageAppend(const char* _filename, T& _input) {
+    // Added to the staged contents, or to the current contents of the file the first time it is staged
+    staging.useSettingsOf(fileSystem);
+    return staging.appendToFile(_filename, _input);
+  }
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_json_document<T>::value, bool>::type
+  stage(const char* _filename, T& _input) {
+    // Serialized into the staged contents, compressed if the file system compresses text
+    std::string json;
+    serializeJson(_input, json);
+    staging.useSettingsOf(fileSystem);
+    return staging.saveToFile(_filename, json);
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_json_document<T>::value, bool>::type
+  stageAppend(const char* _filename, T& _input) {
+    std::string json;
+    serializeJson(_input, json);
+    return staging.appendFile(_filename, (const uint8_t*)json.data(), json.size());
+  }
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    if (!isStaged(_filename)) return fileSystem.openFromFile(_filename, _output);
+    std::string json;
+    return staging.openFromFile(_filename, json) && !deserializeJson(_output, json.data(), json.size());
+  }
+#endif
+  template <class T>
+  typename Effortless_SPIFFS_Internal::enable_if<!Effortless_SPIFFS_Internal::is_json_document<T>::value, bool>::type
+  openFromFile(const char* _filename, T& _output) {
+    // Staged contents if the file is in the batch, otherwise the file on the file system
+    if (!isStaged(_filename)) return fileSystem.openFromFile(_filename, _output);
+    return staging.openFromFile(_filename, _output);
+  }
+  bool isStaged(const char* _filename) const {
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].name == _filename) return true;
     }
     return false;
   }
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, String>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, std::string>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    if (saveFile(_filename, _input.c_str())) {
+  bool commit() {
+    // Commit the staged files and start a new batch if successful
+    if (fileSystem.saveFiles(entries)) {
+      entries.clear();
       return true;
     }
     return false;
   }
-#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
-  template <class T>
-  typename Effortless_SPIFFS_Internal::enable_if<Effortless_SPIFFS_Internal::is_same<T, DynamicJsonDocument>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, JsonObject>::value ||
-                                                     Effortless_SPIFFS_Internal::is_same<T, JsonArray>::value,
-                                                 bool>::type
-  appendToFile(const char* _filename, T& _input) {
-    File file = getFile(_filename, "a");
-    if (file) {
-      if (serializeJson(_input, file)) {
-        file.close();
+  void clear() {
+    entries.clear();
+  }
+  size_t size() const {
+    return entries.size();
+  }
+
+ private:  // staging - serializes through the usual overloads into the staged entries, never touches flash
+  class Staging : public eSPIFFSOn<typename FileSystem::StorageBackend, Staging> {
+    typedef eSPIFFSOn<typename FileSystem::StorageBackend, Staging> Base;
+    friend Base;
+
+   public:
+    Staging(FileSystem& _target, std::vector<BatchEntry>& _entries, Print* _debug) : Base(_debug), target(_target), entries(_entries) {}
+    void useSettingsOf(const FileSystem& _fileSystem) {
+      this->setEncoding((typename Base::Encoding)_fileSystem.getEncoding());
+      this->setCompression(_fileSystem.getCompression());
+    }
+
+   public:  // eSPIFFS overrides
+    using Base::appendFile;
+    using Base::saveFile;
+    bool saveFile(const char* _filename, const uint8_t* _input, size_t _len) {
+      if (_len) {
+        find(_filename).data.assign((const char*)_input, _len);
         return true;
-      } else {
-        ESPIFFS_DEBUG("[saveToFile<DynamicJsonDocument>] - Failed to serialize JSON for file ");
-        ESPIFFS_DEBUGLN(_filename);
       }
+      return false;
     }
-    return false;
-  }
-#endif
+    bool appendFile(const char* _filename, const uint8_t* _input, size_t _len) {
+      // Start from the current contents of the file if it has not been staged yet
+      if (_len) {
+        bool        staged = false;
+        for (size_t i = 0; i < entries.size(); i++) staged |= entries[i].name == _filename;
+        BatchEntry& entry = find(_filename);
+        if (!staged) {
+          target.readFile(_filename, [&](const uint8_t* _data, size_t _size) {
+            entry.data.append((const char*)_data, _size);
+            return true;
+          });
+        }
+        entry.data.append((const char*)_input, _len);
+        return true;
+      }
+      return false;
+    }
+
+   protected:  // eSPIFFS overrides
+    bool readValue(const char* _filename, char* _output, size_t _size, size_t& _fileSize) {
+      BatchEntry* entry = findStaged(_filename);
+      if (!entry) return false;
+      _fileSize = entry->data.size();
+      size_t numBytesRead = _fileSize < _size ? _fileSize : _size - 1;
+      memcpy(_output, entry->data.data(), numBytesRead);
+      _output[numBytesRead] = 0x00;
+      return numBytesRead > 0;
+    }
+    bool readText(const char* _filename, std::string& _output) {
+      BatchEntry* entry = findStaged(_filename);
+      if (entry) _output = entry->data;
+      return entry && !_output.empty();
+    }
+    bool readText(const char* _filename, String& _output) {
+      BatchEntry* entry = findStaged(_filename);
+      if (entry) _output = entry->data.c_str();
+      return entry && _output.length() > 0;
+    }
+
+   private:
+    BatchEntry* findStaged(const char* _filename) {
+      for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].name == _filename) return &entries[i];
+      }
+      return nullptr;
+    }
+    BatchEntry& find(const char* _filename) {
+      BatchEntry* entry = findStaged(_filename);
+      if (entry) return *entry;
+      entries.push_back(BatchEntry());
+      entries.back().name = _filename;
+      return entries.back();
+    }
+    FileSystem&              target;
+    std::vector<BatchEntry>& entries;
+  };
 
  private:  // storage
-  bool   flashSizeCorrect = false;
-  Print* printer = nullptr;
+  FileSystem&             fileSystem;
+  std::vector<BatchEntry> entries;
+  Staging                 staging;
+};
+
+// Batch for the default eSPIFFS, a class so it can be forward declared
+class eSPIFFSBatch : public eSPIFFSBatchOn<eSPIFFS> {
+ public:  // constructors
+  using eSPIFFSBatchOn<eSPIFFS>::eSPIFFSBatchOn;
 };
 
 #endif
@@ -0,0 +1,367 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#include <functional>
+
+#ifndef Effortless_SPIFFS_Async_h
+#define Effortless_SPIFFS_Async_h
+
+// Effortless SPIFFS Async Constants
+#ifndef Effortless_SPIFFS_ASYNC_QUEUE
+#define Effortless_SPIFFS_ASYNC_QUEUE 8
+#endif
+
+#ifndef Effortless_SPIFFS_ASYNC_SIZE
+#define Effortless_SPIFFS_ASYNC_SIZE 4096
+#endif
+
+#ifndef Effortless_SPIFFS_ASYNC_STACK
+#define Effortless_SPIFFS_ASYNC_STACK 4096
+#endif
+
+#ifndef Effortless_SPIFFS_ASYNC_PRIORITY
+#define Effortless_SPIFFS_ASYNC_PRIORITY 1
+#endif
+
+// eSPIFFS whose saves and appends are queued and written later, by a background task on ESP32 or poll() on ESP8266
+template <class Backend>
+class eSPIFFSAsyncOn : public eSPIFFSOn<Backend, eSPIFFSAsyncOn<Backend> > {
+  typedef eSPIFFSOn<Backend, eSPIFFSAsyncOn<Backend> > Base;
+  typedef typename Base::FileLock                      FileLock;
+  friend Base;
+
+ public:  // constructors
+  eSPIFFSAsyncOn(Print* _debug = nullptr) : Base(_debug) {
+#if defined(ESP32)
+    queueMutex = xSemaphoreCreateMutex();
+#endif
+  }
+  ~eSPIFFSAsyncOn() {
+#if defined(ESP32)
+    if (workerTask) {
+      // Ask the worker to finish its current write and wait for it to stop
+      workerStopped = xSemaphoreCreateBinary();
+      {
+        QueueLock lock(*this);
+        stopping = true;
+      }
+      xTaskNotifyGive(workerTask);
+      xSemaphoreTake(workerStopped, portMAX_DELAY);
+      vSemaphoreDelete(workerStopped);
+    }
+#endif
+    flushAndWait();
+#if defined(ESP32)
+    vSemaphoreDelete(queueMutex);
+#endif
+  }
+
+ public:  // async methods
+  typedef std::function<void(uint32_t request, const char* filename, bool success)> CompletionCallback;
+  void onComplete(CompletionCallback _callback) {
+    // Called once per queued save or append, from the worker task on ESP32
+    completionCallback = _callback;
+  }
+  template <class T>
+  uint32_t queueSave(const char* _filename, T& _input) {
+    // saveToFile returning the request number of this save for isPending and the completion callback, 0 if it failed
+    {
+      QueueLock lock(*this);
+      rememberRequest(0);
+    }
+    return this->saveToFile(_filename, _input) ? lastRequest() : 0;
+  }
+  template <class T>
+  uint32_t queueAppend(const char* _filename, T& _input) {
+    {
+      QueueLock lock(*this);
+      rememberRequest(0);
+    }
+    return this->appendToFile(_filename, _input) ? lastRequest() : 0;
+  }
+  uint32_t lastRequest() {
+    // Request number of the most recent saveToFile or appendToFile made by the calling task
+    QueueLock   lock(*this);
+    const void* task = currentTask();
+    for (size_t i = 0; i < taskRequests.size(); i++) {
+      if (taskRequests[i].task == task) return taskRequests[i].request;
+    }
+    return 0;
+  }
+  bool isPending(uint32_t _request) {
+    QueueLock lock(*this);
+    for (size_t i = 0; i < inFlight.size(); i++) {
+      if (hasRequest(*inFlight[i], _request)) return true;
+    }
+    for (size_t i = 0; i < queue.size(); i++) {
+      if (hasRequest(queue[i], _request)) return true;
+    }
+    return false;
+  }
+  size_t pending() {
+    QueueLock lock(*this);
+    return queue.size() + inFlight.size();
+  }
+  bool poll() {
+    // Write the oldest queued file, call from loop() on ESP8266
+    return writeNext();
+  }
+  void flushAndWait() {
+    // Write everything queued so far, then wait for any write the worker has in progress
+    while (writeNext()) {
+    }
+    std::vector<std::string> writing;
+    {
+      QueueLock lock(*this);
+      for (size_t i = 0; i < inFlight.size(); i++) writing.push_back(inFlight[i]->name);
+    }
+    for (size_t i = 0; i < writing.size(); i++) FileLock lock(*this, writing[i].c_str());
+  }
+
+ public:  // eSPIFFS overrides
+  using Base::appendFile;
+  using Base::saveFile;
+  void unmount() {
+    flushAndWait();
+    Base::unmount();
+  }
+  bool saveFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    return queueWrite(_filename, _input, _len, false) != 0;
+  }
+  bool appendFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    return queueWrite(_filename, _input, _len, true) != 0;
+  }
+
+ protected:  // eSPIFFS overrides
+  void beforeAccess(const char* _filename, bool _write) {
+    // Every other read or write of a file, including ArduinoJson documents, happens after anything queued for it.
+    // A read with nothing queued goes straight on, its own read lock waits for a write the worker has in progress
+    if (!_write && !isQueued(_filename)) return;
+    FileLock lock(*this, _filename);
+    if (!isWriting(_filename)) writePending(_filename);
+  }
+
+ private:  // queue
+  struct AsyncEntry {
+    std::string           name;
+    std::string           data;
+    bool                  append = false;
+    std::vector<uint32_t> requests;
+  };
+  uint32_t queueWrite(const char* _filename, const uint8_t* _input, size_t _len, bool _append) {
+    // Returns the request number, 0 if the write failed straight away
+    if (!_len) return 0;
+    if (!startWorker()) return writeNow(_filename, _input, _len, _append);
+
+    uint32_t request;
+    while (true) {
+      {
+        // Coalesce with a queued write to the same file, a save replaces it and an append extends it
+        QueueLock   lock(*this);
+        AsyncEntry* entry = findEntry(_filename);
+        size_t      newBytes = queuedBytes + _len - (entry && !_append ? entry->data.size() : 0);
+        if ((entry || queue.size() < Effortless_SPIFFS_ASYNC_QUEUE) && newBytes <= Effortless_SPIFFS_ASYNC_SIZE) {
+          if (!entry) {
+            queue.push_back(AsyncEntry());
+            entry = &queue.back();
+            entry->name = _filename;
+            entry->append = _append;
+          }
+          if (_append) {
+            entry->data.append((const char*)_input, _len);
+          } else {
+            entry->data.assign((const char*)_input, _len);
+            entry->append = false;
+          }
+          request = ++lastRequestId;
+          entry->requests.push_back(request);
+          rememberRequest(request);
+          queuedBytes = newBytes;
+          break;
+        }
+      }
+
+      // The queue is full so make room by writing the oldest file here, or write directly if it can never fit
+      if (!writeNext()) return writeNow(_filename, _input, _len, _append);
+    }
+
+#if defined(ESP32)
+    xTaskNotifyGive(workerTask);
+#endif
+    return request;
+  }
+  uint32_t writeNow(const char* _filename, const uint8_t* _input, size_t _len, bool _append) {
+    // Write in the calling task, after anything already queued for the file
+    FileLock lock(*this, _filename);
+    writePending(_filename);
+    bool     success = _append ? Base::appendFile(_filename, _input, _len) : Base::saveFile(_filename, _input, _len);
+    uint32_t request;
+    {
+      QueueLock queueLock(*this);
+      request = ++lastRequestId;
+      rememberRequest(request);
+    }
+    if (completionCallback) completionCallback(request, _filename, success);
+    return success ? request : 0;
+  }
+  void rememberRequest(uint32_t _request) {
+    // One slot per task that has saved through this instance, the queue lock must be held
+    const void* task = currentTask();
+    for (size_t i = 0; i < taskRequests.size(); i++) {
+      if (taskRequests[i].task == task) {
+        taskRequests[i].request = _request;
+        return;
+      }
+    }
+    taskRequests.push_back({task, _request});
+  }
+  bool writeNext() {
+    // Lock the oldest queued file before taking it off the queue so writes to a file stay in order
+    std::string name;
+    {
+      QueueLock queueLock(*this);
+      if (queue.empty()) return false;
+      name = queue.front().name;
+    }
+    FileLock lock(*this, name.c_str());
+    writePending(name.c_str());
+    return true;
+  }
+  void writePending(const char* _filename) {
+    // Write anything queued for a file before it is read or changed directly, its file lock must be held
+    AsyncEntry entry;
+    {
+      QueueLock   queueLock(*this);
+      AsyncEntry* queued = findEntry(_filename);
+      if (!queued) return;
+      entry = std::move(*queued);
+      queue.erase(queue.begin() + (queued - &queue[0]));
+      queuedBytes -= entry.data.size();
+      inFlight.push_back(&entry);
+    }
+    writeEntry(entry);
+  }
+  void writeEntry(AsyncEntry& _entry) {
+    const uint8_t* data = (const uint8_t*)_entry.data.data();
+    bool success = _entry.append ? Base::appendFile(_entry.name.c_str(), data, _entry.data.size()) : Base::saveFile(_entry.name.c_str(), data, _entry.data.size());
+    if (!success) {
+      ESPIFFS_DEBUG("[async] - Failed to write queued file: ");
+      ESPIFFS_DEBUGLN(_entry.name.c_str());
+    }
+    {
+      QueueLock queueLock(*this);
+      inFlight.erase(std::find(inFlight.begin(), inFlight.end(), &_entry));
+    }
+    if (completionCallback) {
+      for (size_t i = 0; i < _entry.requests.size(); i++) completionCallback(_entry.requests[i], _entry.name.c_str(), success);
+    }
+  }
+  bool isQueued(const char* _filename) {
+    QueueLock queueLock(*this);
+    return findEntry(_filename) != nullptr;
+  }
+  bool isWriting(const char* _filename) {
+    // A write in progress for a file can only belong to the task holding its file lock
+    QueueLock queueLock(*this);
+    for (size_t i = 0; i < inFlight.size(); i++) {
+      if (inFlight[i]->name == _filename) return true;
+    }
+    return false;
+  }
+  AsyncEntry* findEntry(const char* _filename) {
+    for (size_t i = 0; i < queue.size(); i++) {
+      if (queue[i].name == _filename) return &queue[i];
+    }
+    return nullptr;
+  }
+  bool hasRequest(const AsyncEntry& _entry, uint32_t _request) const {
+    for (size_t i = 0; i < _entry.requests.size(); i++) {
+      if (_entry.requests[i] == _request) return true;
+    }
+    return false;
+  }
+
+ private:  // locking - file locks from eSPIFFS keep writes to each file in order, the queue lock is only held briefly
+#if defined(ESP32)
+  struct QueueLock {
+    QueueLock(eSPIFFSAsyncOn& _async) : async(_async) {
+      xSemaphoreTake(async.queueMutex, portMAX_DELAY);
+    }
+    ~QueueLock() {
+      xSemaphoreGive(async.queueMutex);
+    }
+    eSPIFFSAsyncOn& async;
+  };
+  bool stopRequested() {
+    QueueLock lock(*this);
+    return stopping;
+  }
+  bool startWorker() {
+    // False if the worker task could not be created, the caller then writes straight away
+    QueueLock lock(*this);
+    if (workerTask) return true;
+    if (xTaskCreate(workerLoop, "eSPIFFSAsync", Effortless_SPIFFS_ASYNC_STACK, this, Effortless_SPIFFS_ASYNC_PRIORITY, &workerTask) == pdPASS) return true;
+    workerTask = nullptr;
+    ESPIFFS_DEBUGLN("[async] - Failed to create the worker task, writing straight away");
+    return false;
+  }
+  static const void* currentTask() {
+    return xTaskGetCurrentTaskHandle();
+  }
+  static void workerLoop(void* _async) {
+    eSPIFFSAsyncOn* async = (eSPIFFSAsyncOn*)_async;
+    while (!async->stopRequested()) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      while (!async->stopRequested() && async->writeNext()) {
+      }
+    }
+    xSemaphoreGive(async->workerStopped);
+    vTaskDelete(NULL);
+  }
+#else
+  // Single threaded, queued files are written from poll()
+  struct QueueLock {
+    QueueLock(eSPIFFSAsyncOn&) {}
+  };
+  bool startWorker() {
+    return true;
+  }
+  static const void* currentTask() {
+    return nullptr;
+  }
+#endif
+
+ private:  // storage
+  using Base::printer;
+  std::vector<AsyncEntry> queue;
+  size_t                  queuedBytes = 0;
+  std::vector<AsyncEntry*> inFlight;
+  uint32_t                lastRequestId = 0;
+  struct TaskRequest {
+    const void* task;
+    uint32_t    request;
+  };
+  std::vector<TaskRequest> taskRequests;
+  CompletionCallback      completionCallback;
+#if defined(ESP32)
+  SemaphoreHandle_t queueMutex = nullptr;
+  SemaphoreHandle_t workerStopped = nullptr;
+  TaskHandle_t      workerTask = nullptr;
+  bool              stopping = false;
+#endif
+};
+
+// Async eSPIFFS on the default backend, a class so it can be forward declared
+class eSPIFFSAsync : public eSPIFFSAsyncOn<Effortless_SPIFFS_BACKEND> {
+ public:  // constructors
+  using eSPIFFSAsyncOn<Effortless_SPIFFS_BACKEND>::eSPIFFSAsyncOn;
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
@@ -0,0 +1,229 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#if defined(ESP32)
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#endif
+
+#ifndef Effortless_SPIFFS_Bundle_h
+#define Effortless_SPIFFS_Bundle_h
+
+// Read only bundle of files packed by extras/eSPIFFS_bundle.py, looked up without copying
+class eSPIFFSBundle {
+ public:  // constructors
+  eSPIFFSBundle(Print* _debug = nullptr) : printer(_debug) {}
+  ~eSPIFFSBundle() {
+    end();
+  }
+
+ public:  // types
+  struct Asset {
+    // Views into the image, which is flash on ESP8266 so read them with memcpy_P or pgm_read_byte
+    const char*    name = nullptr;
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+    explicit operator bool() const {
+      return data != nullptr;
+    }
+  };
+
+ public:  // bundle methods
+  bool begin(const uint8_t* _image, size_t _size) {
+    // Use an image already in memory, such as a PROGMEM array generated with --header
+    end();
+    return openImage(_image, _size);
+  }
+#if defined(ESP32)
+  bool begin(const char* _partitionLabel) {
+    // Map a data partition the image was flashed to straight into the address space
+    end();
+    const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, _partitionLabel);
+    if (!partition) {
+      ESPIFFS_DEBUG("[begin] - Could not find bundle partition: ");
+      ESPIFFS_DEBUGLN(_partitionLabel);
+      return false;
+    }
+
+    // Only map as much of the partition as the image uses
+    uint8_t header[HEADER_SIZE];
+    if (esp_partition_read(partition, 0, header, HEADER_SIZE) != ESP_OK) return false;
+    uint32_t imageSize = readLE32(header + 12);
+    if (imageSize < HEADER_SIZE || imageSize > partition->size) imageSize = partition->size;
+
+    const void* mapped = nullptr;
+    if (esp_partition_mmap(partition, 0, imageSize, MMAP_DATA, &mapped, &mapHandle) != ESP_OK) {
+      ESPIFFS_DEBUG("[begin] - Failed to map bundle partition: ");
+      ESPIFFS_DEBUGLN(_partitionLabel);
+      return false;
+    }
+    isMapped = true;
+    if (!openImage((const uint8_t*)mapped, imageSize)) {
+      end();
+      return false;
+    }
+    return true;
+  }
+#endif
+  void end() {
+#if defined(ESP32)
+    if (isMapped) unmap(mapHandle);
+    isMapped = false;
+#endif
+    image = nullptr;
+    size = 0;
+    count = 0;
+  }
+  bool verify() {
+    // Check the crc32 of the whole image, this reads every byte so only call it once after begin
+    if (!image) return false;
+    uint8_t  chunk[Effortless_SPIFFS_CHUNK_SIZE];
+    uint32_t crc = 0;
+    memcpy_P(chunk, image + HEADER_SIZE - 4, 4);
+    uint32_t expected = readLE32(chunk);
+    for (size_t offset = HEADER_SIZE; offset < size; offset += sizeof(chunk)) {
+      size_t numBytes = size - offset < sizeof(chunk) ? size - offset : sizeof(chunk);
+      memcpy_P(chunk, image + offset, numBytes);
+      crc = Effortless_SPIFFS_Internal::crc32(chunk, numBytes, crc);
+    }
+    if (crc != expected) ESPIFFS_DEBUGLN("[verify] - Bundle image is corrupt");
+    return crc == expected;
+  }
+
+ public:  // lookup methods
+  Asset find(const char* _filename) const {
+    // Binary search of the sorted index
+    Asset  asset;
+    size_t nameLength = strlen(_filename);
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+      size_t middle = (low + high) / 2;
+      int    order = compareName(middle, _filename, nameLength);
+      if (order == 0) return at(middle);
+      if (order < 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return asset;
+  }
+  Asset at(size_t _index) const {
+    Asset asset;
+    if (_index >= count) return asset;
+    uint8_t entry[ENTRY_SIZE];
+    memcpy_P(entry, image + HEADER_SIZE + _index * ENTRY_SIZE, ENTRY_SIZE);
+    asset.name = (const char*)image + readLE32(entry);
+    asset.data = image + readLE32(entry + 8);
+    asset.size = readLE32(entry + 12);
+    return asset;
+  }
+  bool exists(const char* _filename) const {
+    return (bool)find(_filename);
+  }
+  int getFileSize(const char* _filename) const {
+    Asset asset = find(_filename);
+    return asset ? (int)asset.size : -1;
+  }
+  size_t numFiles() const {
+    return count;
+  }
+  size_t imageSize() const {
+    return size;
+  }
+  bool isOpen() const {
+    return image != nullptr;
+  }
+
+ private:  // image format - see extras/eSPIFFS_bundle.py
+  static const uint8_t VERSION = 1;
+  static const size_t  HEADER_SIZE = 20;
+  static const size_t  ENTRY_SIZE = 16;
+
+  bool openImage(const uint8_t* _image, size_t _size) {
+    if (!_image || _size < HEADER_SIZE) {
+      ESPIFFS_DEBUGLN("[begin] - Bundle image is too small");
+      return false;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    memcpy_P(header, _image, HEADER_SIZE);
+    uint32_t numFiles = readLE32(header + 8);
+    uint32_t imageSize = readLE32(header + 12);
+    if (memcmp(header, "eSPB", 4) != 0 || header[4] != VERSION) {
+      ESPIFFS_DEBUGLN("[begin] - Not a bundle image or an unsupported version");
+      return false;
+    }
+    if (imageSize > _size || numFiles > (imageSize - HEADER_SIZE) / ENTRY_SIZE) {
+      ESPIFFS_DEBUGLN("[begin] - Bundle image is truncated");
+      return false;
+    }
+
+    // Check every entry once here so lookups can trust the index
+    for (uint32_t i = 0; i < numFiles; i++) {
+      uint8_t entry[ENTRY_SIZE];
+      memcpy_P(entry, _image + HEADER_SIZE + i * ENTRY_SIZE, ENTRY_SIZE);
+      uint32_t nameOffset = readLE32(entry);
+      uint32_t nameLength = readLE32(entry + 4);
+      uint32_t dataOffset = readLE32(entry + 8);
+      uint32_t dataSize = readLE32(entry + 12);
+      if (nameOffset > imageSize || nameLength >= imageSize - nameOffset || dataOffset > imageSize || dataSize > imageSize - dataOffset) {
+        ESPIFFS_DEBUGLN("[begin] - Bundle index points outside the image");
+        return false;
+      }
+    }
+
+    image = _image;
+    size = imageSize;
+    count = numFiles;
+    return true;
+  }
+  static uint32_t readLE32(const uint8_t* _bytes) {
+    return _bytes[0] | (_bytes[1] << 8) | ((uint32_t)_bytes[2] << 16) | ((uint32_t)_bytes[3] << 24);
+  }
+  int compareName(size_t _index, const char* _filename, size_t _nameLength) const {
+    // Same order as the packer, bytewise with a shorter name first when one is a prefix of the other
+    uint8_t entry[8];
+    memcpy_P(entry, image + HEADER_SIZE + _index * ENTRY_SIZE, sizeof(entry));
+    size_t entryLength = readLE32(entry + 4);
+    int    order = memcmp_P(_filename, image + readLE32(entry), _nameLength < entryLength ? _nameLength : entryLength);
+    if (order != 0) return -order;
+    return entryLength < _nameLength ? -1 : entryLength > _nameLength ? 1 : 0;
+  }
+
+#if defined(ESP32)
+#if ESP_IDF_VERSION_MAJOR >= 5
+  typedef esp_partition_mmap_handle_t MapHandle;
+  static const esp_partition_mmap_memory_t MMAP_DATA = ESP_PARTITION_MMAP_DATA;
+  static void unmap(MapHandle _handle) {
+    esp_partition_munmap(_handle);
+  }
+#else
+  typedef spi_flash_mmap_handle_t MapHandle;
+  static const spi_flash_mmap_memory_t MMAP_DATA = SPI_FLASH_MMAP_DATA;
+  static void unmap(MapHandle _handle) {
+    spi_flash_munmap(_handle);
+  }
+#endif
+#endif
+
+ private:  // storage
+  Print*         printer = nullptr;
+  const uint8_t* image = nullptr;
+  size_t         size = 0;
+  size_t         count = 0;
+#if defined(ESP32)
+  MapHandle mapHandle = 0;
+  bool      isMapped = false;
+#endif
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
@@ -0,0 +1,429 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_KV_h
+#define Effortless_SPIFFS_KV_h
+
+// Effortless SPIFFS KV Constants
+#ifndef Effortless_SPIFFS_KV_COMPACT_PERCENT
+#define Effortless_SPIFFS_KV_COMPACT_PERCENT 50
+#endif
+
+#ifndef Effortless_SPIFFS_KV_COMPACT_MIN
+#define Effortless_SPIFFS_KV_COMPACT_MIN 1024
+#endif
+
+// Key value store packing many values into a single log structured file of the file system given by a backend
+template <class Backend>
+class eSPIFFSKVOn : public eSPIFFSOn<Backend, eSPIFFSKVOn<Backend> > {
+  typedef eSPIFFSOn<Backend, eSPIFFSKVOn<Backend> > Base;
+  typedef typename Base::FileLock                   FileLock;
+  friend Base;
+
+ public:  // constructors
+  eSPIFFSKVOn(const char* _storeFile = "/store.kv", Print* _debug = nullptr) : Base(_debug), storeFile(_storeFile) {}
+  ~eSPIFFSKVOn() {}
+
+ public:  // store methods
+  bool begin() {
+    // Mount and build the index on first use
+    FileLock lock(*this, storeFile.c_str());
+    if (!loaded) {
+      if (this->mount()) {
+        loaded = loadIndex();
+      }
+    }
+    return loaded;
+  }
+  bool contains(const char* _key) {
+    FileLock lock(*this, storeFile.c_str());
+    if (begin()) {
+      return findKey(_key) >= 0;
+    }
+    return false;
+  }
+  bool remove(const char* _key) {
+    FileLock lock(*this, storeFile.c_str());
+    if (begin()) {
+      int position = findKey(_key);
+      if (position >= 0) {
+        // Append a tombstone so the removal survives a reload
+        if (writeRecord(_key, strlen(_key), nullptr, 0, false)) {
+          garbageSize += index[position].length + RECORD_OVERHEAD + strlen(_key);
+          index.erase(index.begin() + position);
+          compactIfNeeded();
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  bool compact() {
+    // Copy every live record to a new file and swap it in atomically
+    FileLock lock(*this, storeFile.c_str());
+    if (!begin()) return false;
+
+    File source = Base::getFile(storeFile.c_str(), "r");
+    bool atomic;
+    File dest = this->openForSave(storeFile.c_str(), atomic, true);
+    if (!dest) return false;
+
+    uint32_t    newSize = 0;
+    uint32_t    crc = 0;
+    std::string record;
+    for (size_t i = 0; i < index.size(); i++) {
+      if (!source || !readRecord(source, index[i].offset, index[i].length, record) || dest.write((const uint8_t*)record.data(), record.size()) != record.size()) {
+        ESPIFFS_DEBUGLN("[compact] - Failed to copy record to new store");
+        this->abortSave(storeFile.c_str(), dest, atomic);
+        loaded = false;
+        return false;
+      }
+      crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)record.data(), record.size(), crc);
+      index[i].offset = newSize;
+      newSize += record.size();
+    }
+    source.close();
+
+    if (!this->finishSave(storeFile.c_str(), dest, atomic, crc)) {
+      loaded = false;
+      return false;
+    }
+    storeSize = newSize;
+    garbageSize = 0;
+    return true;
+  }
+  void setCompactThreshold(uint8_t _percent, size_t _minBytes = Effortless_SPIFFS_KV_COMPACT_MIN) {
+    compactPercent = _percent;
+    compactMinBytes = _minBytes;
+  }
+  size_t size() {
+    FileLock lock(*this, storeFile.c_str());
+    begin();
+    return index.size();
+  }
+  size_t fileBytes() const {
+    return storeSize;
+  }
+  size_t garbageBytes() const {
+    return garbageSize;
+  }
+
+ public:  // eSPIFFS overrides
+  using Base::appendFile;
+  using Base::saveFile;
+  int getFileSize(const char* _key) {
+    std::string value;
+    if (getValue(_key, value)) {
+      return value.size();
+    }
+    return 0;
+  }
+  bool exists(const char* _key) {
+    return contains(_key);
+  }
+  time_t getLastWrite(const char*) {
+    // Values do not keep their own time, so report when the store was last written
+    return Base::getLastWrite(storeFile.c_str());
+  }
+  File getFile(const char* _key, const char*) {
+    ESPIFFS_DEBUG("[getFile] - Direct file access is not supported by the key value store: ");
+    ESPIFFS_DEBUGLN(_key);
+    return File();
+  }
+  bool openFile(const char* _key, char* _output, size_t _len = 0) {
+    std::string value;
+    if (getValue(_key, value)) {
+      size_t numBytesToRead = (_len > 0 && _len <= value.size()) ? _len : value.size();
+      if (numBytesToRead) {
+        memcpy(_output, value.data(), numBytesToRead);
+        return true;
+      }
+    }
+    return false;
+  }
+  bool updateRange(const char* _key, size_t, const uint8_t*, size_t) {
+    // Records are rewritten whole, so save the value again instead
+    ESPIFFS_DEBUG("[updateRange] - Partial updates are not supported by the key value store: ");
+    ESPIFFS_DEBUGLN(_key);
+    return false;
+  }
+  bool readRange(const char* _key, size_t _offset, uint8_t* _output, size_t _len) {
+    std::string value;
+    if (getValue(_key, value) && _len && _offset + _len <= value.size()) {
+      memcpy(_output, value.data() + _offset, _len);
+      return true;
+    }
+    return false;
+  }
+  template <class F>
+  bool readFile(const char* _key, F _callback) {
+    std::string value;
+    if (getValue(_key, value)) {
+      for (size_t offset = 0; offset < value.size(); offset += Effortless_SPIFFS_CHUNK_SIZE) {
+        size_t numBytes = value.size() - offset < Effortless_SPIFFS_CHUNK_SIZE ? value.size() - offset : Effortless_SPIFFS_CHUNK_SIZE;
+        if (!_callback((const uint8_t*)value.data() + offset, numBytes)) break;
+      }
+      return true;
+    }
+    return false;
+  }
+  bool saveFile(const char* _key, const uint8_t* _input, size_t _len) {
+    if (begin() && _len) {
+      return setValue(_key, (const char*)_input, _len);
+    }
+    return false;
+  }
+  bool appendFile(const char* _key, const uint8_t* _input, size_t _len) {
+    FileLock lock(*this, storeFile.c_str());
+    if (begin() && _len) {
+      std::string value;
+      getValue(_key, value);
+      value.append((const char*)_input, _len);
+      return setValue(_key, value.data(), value.size());
+    }
+    return false;
+  }
+
+ protected:  // eSPIFFS helper overrides
+  File openForSave(const char* _key, bool& _atomic, bool _requireAtomic = false) {
+    // Compaction writes the store file itself, anything else would be a stray file named after a key
+    if (_key == storeFile) return Base::openForSave(_key, _atomic, _requireAtomic);
+    ESPIFFS_DEBUG("[saveToFile] - ArduinoJson documents are not supported by the key value store: ");
+    ESPIFFS_DEBUGLN(_key);
+    _atomic = false;
+    return File();
+  }
+  bool readValue(const char* _key, char* _output, size_t _size, size_t& _fileSize) {
+    std::string value;
+    if (getValue(_key, value)) {
+      _fileSize = value.size();
+      size_t numBytesRead = _fileSize < _size ? _fileSize : _size - 1;
+      memcpy(_output, value.data(), numBytesRead);
+      _output[numBytesRead] = 0x00;
+      return numBytesRead > 0;
+    }
+    return false;
+  }
+  bool readText(const char* _key, std::string& _output) {
+    return getValue(_key, _output) && !_output.empty();
+  }
+  bool readText(const char* _key, String& _output) {
+    std::string value;
+    if (getValue(_key, value)) {
+      _output = value.c_str();
+      return _output.length() > 0;
+    }
+    return false;
+  }
+
+ private:  // record format - magic, flags, key length, value length (le16), key, value, crc8
+  static const uint8_t RECORD_LIVE = 0x01;
+  static const size_t  RECORD_HEADER = 5;
+  static const size_t  RECORD_OVERHEAD = RECORD_HEADER + 1;
+
+  struct IndexEntry {
+    uint32_t hash;
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  bool loadIndex() {
+    // Scan the log once, keeping the latest record for every key
+    index.clear();
+    storeSize = 0;
+    garbageSize = 0;
+
+    File currentFile = Base::getFile(storeFile.c_str(), "r");
+    if (!currentFile) return true;  // New store
+    size_t fileSize = currentFile.size();
+
+    std::string record;
+    while (storeSize + RECORD_OVERHEAD <= fileSize) {
+      uint8_t header[RECORD_HEADER];
+      currentFile.seek(storeSize);
+      if (currentFile.read(header, RECORD_HEADER) != RECORD_HEADER || header[0] != Effortless_SPIFFS_Internal::BINARY_MAGIC) break;
+      uint32_t length = RECORD_OVERHEAD + header[2] + (header[3] | (header[4] << 8));
+      if (storeSize + length > fileSize || !readRecord(currentFile, storeSize, length, record)) break;
+
+      // Replace or remove any earlier record for the same key
+      const char* key = record.data() + RECORD_HEADER;
+      int         position = findKey(key, header[2], currentFile);
+      if (position >= 0) {
+        garbageSize += index[position].length;
+        index.erase(index.begin() + position);
+      }
+      if (header[1] & RECORD_LIVE) {
+        insertEntry(Effortless_SPIFFS_Internal::hashName(key, header[2]), storeSize, length);
+      } else {
+        garbageSize += length;
+      }
+      storeSize += length;
+    }
+    currentFile.close();
+
+    // Anything left is a torn write, rewrite the store without it
+    if (storeSize < fileSize) {
+      ESPIFFS_DEBUGLN("[loadIndex] - Store has a partial record at the end, compacting");
+      if (!compactNow()) return false;
+    }
+    return true;
+  }
+  bool readRecord(File& _file, uint32_t _offset, uint32_t _length, std::string& _record) {
+    // Read a whole record and check it is intact
+    _record.resize(_length);
+    _file.seek(_offset);
+    if (_file.read((uint8_t*)&_record[0], _length) != _length) return false;
+    const uint8_t* bytes = (const uint8_t*)_record.data();
+    return bytes[0] == Effortless_SPIFFS_Internal::BINARY_MAGIC && Effortless_SPIFFS_Internal::crc8(bytes, _length - 1) == bytes[_length - 1];
+  }
+  bool writeRecord(const char* _key, size_t _keyLen, const char* _value, size_t _valueLen, bool _live) {
+    // Build the record in one buffer so it is written with a single call
+    std::string record;
+    record.reserve(RECORD_OVERHEAD + _keyLen + _valueLen);
+    record += (char)Effortless_SPIFFS_Internal::BINARY_MAGIC;
+    record += (char)(_live ? RECORD_LIVE : 0x00);
+    record += (char)_keyLen;
+    record += (char)(_valueLen & 0xFF);
+    record += (char)(_valueLen >> 8);
+    record.append(_key, _keyLen);
+    if (_valueLen) record.append(_value, _valueLen);
+    record += (char)Effortless_SPIFFS_Internal::crc8((const uint8_t*)record.data(), record.size());
+
+    File currentFile = Base::getFile(storeFile.c_str(), "a");
+    if (currentFile) {
+      if (currentFile.write((const uint8_t*)record.data(), record.size()) == record.size()) {
+        currentFile.close();
+        if (_live) insertEntry(Effortless_SPIFFS_Internal::hashName(_key, _keyLen), storeSize, record.size());
+        storeSize += record.size();
+        return true;
+      }
+      ESPIFFS_DEBUG("[writeRecord] - Failed to write record for key: ");
+      ESPIFFS_DEBUGLN(_key);
+    }
+    return false;
+  }
+  bool getValue(const char* _key, std::string& _value) {
+    // Every value lives in the store file, so its lock also guards the index
+    FileLock lock(*this, storeFile.c_str());
+    if (!begin()) return false;
+    File currentFile;
+    int  position = findKey(_key, strlen(_key), currentFile);
+    if (position < 0) return false;
+
+    std::string record;
+    if (currentFile && readRecord(currentFile, index[position].offset, index[position].length, record)) {
+      size_t keyLen = (uint8_t)record[2];
+      _value.assign(record, RECORD_HEADER + keyLen, record.size() - RECORD_OVERHEAD - keyLen);
+      return true;
+    }
+    ESPIFFS_DEBUG("[getValue] - Failed to read record for key: ");
+    ESPIFFS_DEBUGLN(_key);
+    return false;
+  }
+  bool setValue(const char* _key, const char* _value, size_t _len) {
+    size_t keyLen = strlen(_key);
+    if (keyLen == 0 || keyLen > 0xFF || _len > 0xFFFF) {
+      ESPIFFS_DEBUG("[setValue] - Key or value too long for key value store: ");
+      ESPIFFS_DEBUGLN(_key);
+      return false;
+    }
+
+    // Skip the write if the value has not changed
+    FileLock    lock(*this, storeFile.c_str());
+    std::string current;
+    int         position = findKey(_key);
+    if (position >= 0) {
+      if (getValue(_key, current) && current.size() == _len && memcmp(current.data(), _value, _len) == 0) return true;
+      garbageSize += index[position].length;
+      index.erase(index.begin() + position);
+    }
+
+    if (writeRecord(_key, keyLen, _value, _len, true)) {
+      compactIfNeeded();
+      return true;
+    }
+    return false;
+  }
+  int findKey(const char* _key) {
+    File currentFile;
+    return findKey(_key, strlen(_key), currentFile);
+  }
+  int findKey(const char* _key, size_t _keyLen, File& _file) {
+    // Binary search for the first entry with a matching hash
+    uint32_t hash = Effortless_SPIFFS_Internal::hashName(_key, _keyLen);
+    size_t   low = 0;
+    size_t   high = index.size();
+    while (low < high) {
+      size_t middle = (low + high) / 2;
+      if (index[middle].hash < hash) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+
+    // Confirm the key against the file to rule out hash collisions
+    for (size_t i = low; i < index.size() && index[i].hash == hash; i++) {
+      if (!_file) _file = Base::getFile(storeFile.c_str(), "r");
+      uint8_t header[RECORD_HEADER];
+      if (_file && _file.seek(index[i].offset) && _file.read(header, RECORD_HEADER) == RECORD_HEADER) {
+        if (header[2] == _keyLen && storedKeyMatches(_file, _key, _keyLen)) return i;
+      }
+    }
+    return -1;
+  }
+  bool storedKeyMatches(File& _file, const char* _key, size_t _keyLen) {
+    // Compare the key that follows the header in fixed chunks
+    uint8_t chunk[Effortless_SPIFFS_CHUNK_SIZE];
+    for (size_t offset = 0; offset < _keyLen;) {
+      size_t numBytes = _keyLen - offset < sizeof(chunk) ? _keyLen - offset : sizeof(chunk);
+      if (_file.read(chunk, numBytes) != numBytes || memcmp(chunk, _key + offset, numBytes) != 0) return false;
+      offset += numBytes;
+    }
+    return true;
+  }
+  void insertEntry(uint32_t _hash, uint32_t _offset, uint32_t _length) {
+    IndexEntry entry = {_hash, _offset, _length};
+    size_t     position = 0;
+    while (position < index.size() && index[position].hash <= _hash) position++;
+    index.insert(index.begin() + position, entry);
+  }
+  void compactIfNeeded() {
+    if (compactPercent && storeSize >= compactMinBytes && garbageSize * 100 >= (size_t)compactPercent * storeSize) {
+      compactNow();
+    }
+  }
+  bool compactNow() {
+    // Compact without going through begin() so it can run while loading
+    bool wasLoaded = loaded;
+    loaded = true;
+    bool success = compact();
+    loaded = wasLoaded && success;
+    return success;
+  }
+
+ private:  // storage
+  using Base::printer;
+  std::string             storeFile;
+  std::vector<IndexEntry> index;
+  bool                    loaded = false;
+  uint32_t                storeSize = 0;
+  uint32_t                garbageSize = 0;
+  uint8_t                 compactPercent = Effortless_SPIFFS_KV_COMPACT_PERCENT;
+  size_t                  compactMinBytes = Effortless_SPIFFS_KV_COMPACT_MIN;
+};
+
+// Key value store on the default backend, a class so it can be forward declared
+class eSPIFFSKV : public eSPIFFSKVOn<Effortless_SPIFFS_BACKEND> {
+ public:  // constructors
+  using eSPIFFSKVOn<Effortless_SPIFFS_BACKEND>::eSPIFFSKVOn;
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_POSIX_h
+#define Effortless_SPIFFS_POSIX_h
+
+#if defined(ESP32)
+#include <sys/stat.h>
+#include <vfs_api.h>
+
+// Effortless SPIFFS POSIX Constants
+#ifndef Effortless_SPIFFS_POSIX_ROOT
+#define Effortless_SPIFFS_POSIX_ROOT "."
+#endif
+
+// Backend keeping files under a directory through the C file API, an IDF mount point such as "/sdcard" on ESP32 or any folder on a host build
+struct eSPIFFSPOSIX {
+  static const bool RENAME_REPLACES = false;  // Depends on the file system under the root, so never relied on
+  static const char* name() {
+    return "POSIX";
+  }
+  static fs::FS& fileSystem() {
+    static fs::FS files(vfs());
+    return files;
+  }
+  static bool begin() {
+    // Nothing is mounted here, the root must already be a directory
+    struct stat info;
+    vfs()->mountpoint(root().c_str());
+    return stat(root().c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+  }
+  static void end() {}
+  static uint64_t totalBytes() {
+    // The size of what is mounted under the root is not known through the C file API
+    return begin() ? UINT64_MAX : 0;
+  }
+  static void setRoot(const char* _root) {
+    // Call before the first mount, or remount after changing it
+    root() = _root;
+    while (root().size() > 1 && root()[root().size() - 1] == '/') root().erase(root().size() - 1);
+    vfs()->mountpoint(root().c_str());
+  }
+  static const char* getRoot() {
+    return root().c_str();
+  }
+
+ private:
+  static std::string& root() {
+    static std::string path(Effortless_SPIFFS_POSIX_ROOT);
+    return path;
+  }
+  static std::shared_ptr<VFSImpl> vfs() {
+    static std::shared_ptr<VFSImpl> impl = std::make_shared<VFSImpl>();
+    return impl;
+  }
+};
+
+#else
+#error The POSIX backend needs the ESP32 virtual file system
+#endif
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
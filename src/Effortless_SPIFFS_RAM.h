@@ -0,0 +1,345 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_RAM_h
+#define Effortless_SPIFFS_RAM_h
+
+#if defined(ESP32)
+#include <FSImpl.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Effortless SPIFFS RAM Constants
+#ifndef Effortless_SPIFFS_RAM_SIZE
+#define Effortless_SPIFFS_RAM_SIZE 32768
+#endif
+
+namespace Effortless_SPIFFS_Internal {
+
+  // Files held on the heap until restart, directories only exist as the folders in file names
+  class RamFS : public fs::FSImpl, public std::enable_shared_from_this<RamFS> {
+   public:
+    RamFS(size_t _capacity) : capacity(_capacity) {}
+
+    size_t usedBytes() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return usedLocked();
+    }
+    void format() {
+      // Open handles keep the contents they had
+      std::lock_guard<std::mutex> lock(mutex);
+      files.clear();
+      changed();
+    }
+
+   public:  // fs::FSImpl
+    fs::FileImplPtr open(const char* _path, const char* _mode, const bool) override {
+      if (!_path || _path[0] != '/') return fs::FileImplPtr();
+      std::lock_guard<std::mutex> lock(mutex);
+      std::string                 path(_path);
+      if (isDirectory(path)) return std::make_shared<RamDir>(shared_from_this(), path, children(path));
+
+      bool reading = _mode[0] == 'r';
+      bool plus = strchr(_mode, '+') != nullptr;
+      auto found = files.find(path);
+      if (found == files.end()) {
+        if (reading || usedLocked() + cost(path, 0) > capacity) return fs::FileImplPtr();
+        found = files.insert(std::make_pair(path, std::make_shared<Node>())).first;
+        changed();
+      } else if (_mode[0] == 'w') {
+        found->second->data.clear();
+        found->second->lastWrite = time(nullptr);
+        changed();
+      }
+      return std::make_shared<RamFile>(shared_from_this(), path, found->second, reading || plus, !reading || plus, _mode[0] == 'a');
+    }
+    bool exists(const char* _path) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      return files.count(_path) || isDirectory(_path);
+    }
+    bool rename(const char* _pathFrom, const char* _pathTo) override {
+      // Replaces an existing target in one step
+      std::lock_guard<std::mutex> lock(mutex);
+      auto                        found = files.find(_pathFrom);
+      if (found == files.end() || !_pathTo || _pathTo[0] != '/') return false;
+      std::shared_ptr<Node> node = found->second;
+      auto                  replaced = files.find(_pathTo);
+      size_t                freed = cost(_pathFrom, node->data.size()) + (replaced != files.end() ? cost(_pathTo, replaced->second->data.size()) : 0);
+      if (usedLocked() - freed + cost(_pathTo, node->data.size()) > capacity) return false;
+      files.erase(found);
+      files[_pathTo] = node;
+      changed();
+      return true;
+    }
+    bool remove(const char* _path) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!files.erase(_path)) return false;
+      changed();
+      return true;
+    }
+    bool mkdir(const char*) override {
+      return true;  // Folders appear with the first file saved in them
+    }
+    bool rmdir(const char* _path) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      return !isDirectory(_path);
+    }
+
+   protected:  // capacity - bytes a file takes up and a hook after every change, both called with the mutex held
+    virtual size_t cost(const std::string&, size_t _size) {
+      return _size;
+    }
+    virtual void changed() {}
+
+   protected:  // files
+    struct Node {
+      std::vector<uint8_t> data;
+      time_t               lastWrite = time(nullptr);
+    };
+    class RamFile : public fs::FileImpl {
+     public:
+      RamFile(std::shared_ptr<RamFS> _fileSystem, const std::string& _path, std::shared_ptr<Node> _node, bool _readable, bool _writable, bool _append)
+          : fileSystem(_fileSystem), filePath(_path), node(_node), readable(_readable), writable(_writable), append(_append) {}
+      size_t write(const uint8_t* _buffer, size_t _size) override {
+        // Fails whole if the file system would grow past its capacity
+        std::lock_guard<std::mutex> lock(fileSystem->mutex);
+        if (!node || !writable) return 0;
+        if (append) offset = node->data.size();
+        size_t end = offset + _size;
+        if (end > node->data.size()) {
+          if (fileSystem->usedLocked() + end - node->data.size() > fileSystem->capacity) return 0;
+          node->data.resize(end);
+        }
+        std::copy(_buffer, _buffer + _size, node->data.begin() + offset);
+        offset = end;
+        node->lastWrite = time(nullptr);
+        fileSystem->changed();
+        return _size;
+      }
+      size_t read(uint8_t* _buffer, size_t _size) override {
+        std::lock_guard<std::mutex> lock(fileSystem->mutex);
+        if (!node || !readable || offset >= node->data.size()) return 0;
+        size_t count = std::min(_size, node->data.size() - offset);
+        std::copy(node->data.begin() + offset, node->data.begin() + offset + count, _buffer);
+        offset += count;
+        return count;
+      }
+      void flush() override {}
+      bool seek(uint32_t _pos, fs::SeekMode _mode) override {
+        std::lock_guard<std::mutex> lock(fileSystem->mutex);
+        if (!node) return false;
+        size_t base = _mode == fs::SeekSet ? 0 : _mode == fs::SeekCur ? offset : node->data.size();
+        if (base + _pos > node->data.size()) return false;
+        offset = base + _pos;
+        return true;
+      }
+      size_t position() const override {
+        return offset;
+      }
+      size_t size() const override {
+        std::lock_guard<std::mutex> lock(fileSystem->mutex);
+        return node ? node->data.size() : 0;
+      }
+      bool setBufferSize(size_t) override {
+        return true;
+      }
+      void close() override {
+        node = nullptr;
+      }
+      time_t getLastWrite() override {
+        std::lock_guard<std::mutex> lock(fileSystem->mutex);
+        return node ? node->lastWrite : 0;
+      }
+      const char* path() const override {
+        return filePath.c_str();
+      }
+      const char* name() const override {
+        return filePath.c_str() + filePath.rfind('/') + 1;
+      }
+      bool isDirectory() override {
+        return false;
+      }
+      fs::FileImplPtr openNextFile(const char*) override {
+        return fs::FileImplPtr();
+      }
+      void rewindDirectory() override {}
+      operator bool() override {
+        return node != nullptr;
+      }
+
+      // Only declared by newer cores, so these are left without override
+      bool seekDir(long) {
+        return false;
+      }
+      String getNextFileName() {
+        return String();
+      }
+      String getNextFileName(bool*) {
+        return String();
+      }
+
+     private:
+      std::shared_ptr<RamFS> fileSystem;
+      std::string            filePath;
+      std::shared_ptr<Node>  node;
+      bool                   readable;
+      bool                   writable;
+      bool                   append;
+      size_t                 offset = 0;
+    };
+    class RamDir : public fs::FileImpl {
+     public:
+      RamDir(std::shared_ptr<RamFS> _fileSystem, const std::string& _path, const std::vector<std::string>& _entries)
+          : fileSystem(_fileSystem), dirPath(_path), entries(_entries) {}
+      size_t write(const uint8_t*, size_t) override {
+        return 0;
+      }
+      size_t read(uint8_t*, size_t) override {
+        return 0;
+      }
+      void flush() override {}
+      bool seek(uint32_t, fs::SeekMode) override {
+        return false;
+      }
+      size_t position() const override {
+        return 0;
+      }
+      size_t size() const override {
+        return 0;
+      }
+      bool setBufferSize(size_t) override {
+        return false;
+      }
+      void close() override {
+        open = false;
+      }
+      time_t getLastWrite() override {
+        return 0;
+      }
+      const char* path() const override {
+        return dirPath.c_str();
+      }
+      const char* name() const override {
+        return dirPath.c_str() + dirPath.rfind('/') + 1;
+      }
+      bool isDirectory() override {
+        return true;
+      }
+      fs::FileImplPtr openNextFile(const char* _mode) override {
+        // Entries removed since the listing are skipped
+        while (open && next < entries.size()) {
+          fs::FileImplPtr entry = fileSystem->open(entries[next++].c_str(), _mode, false);
+          if (entry) return entry;
+        }
+        return fs::FileImplPtr();
+      }
+      void rewindDirectory() override {
+        next = 0;
+      }
+      operator bool() override {
+        return open;
+      }
+
+      // Only declared by newer cores, so these are left without override
+      bool seekDir(long _position) {
+        if (_position < 0 || (size_t)_position > entries.size()) return false;
+        next = _position;
+        return true;
+      }
+      String getNextFileName() {
+        return open && next < entries.size() ? String(entries[next++].c_str()) : String();
+      }
+      String getNextFileName(bool* _isDirectory) {
+        String entry = getNextFileName();
+        if (_isDirectory) *_isDirectory = entry.length() && !fileSystem->isFile(entry.c_str());
+        return entry;
+      }
+
+     private:
+      std::shared_ptr<RamFS>   fileSystem;
+      std::string              dirPath;
+      std::vector<std::string> entries;
+      size_t                   next = 0;
+      bool                     open = true;
+    };
+
+    size_t usedLocked() {
+      size_t used = 0;
+      for (auto& file : files) used += cost(file.first, file.second->data.size());
+      return used;
+    }
+    bool isFile(const char* _path) {
+      std::lock_guard<std::mutex> lock(mutex);
+      return files.count(_path) > 0;
+    }
+    bool isDirectory(const std::string& _path) {
+      if (_path == "/") return true;
+      std::string prefix = _path + "/";
+      auto        found = files.lower_bound(prefix);
+      return found != files.end() && found->first.compare(0, prefix.size(), prefix) == 0;
+    }
+    std::vector<std::string> children(const std::string& _path) {
+      // Files directly in the folder, and each folder below it once
+      std::string              prefix = _path == "/" ? _path : _path + "/";
+      std::vector<std::string> names;
+      for (auto found = files.lower_bound(prefix); found != files.end() && found->first.compare(0, prefix.size(), prefix) == 0; found++) {
+        size_t      slash = found->first.find('/', prefix.size());
+        std::string name = found->first.substr(0, slash);
+        if (names.empty() || names.back() != name) names.push_back(name);
+      }
+      return names;
+    }
+
+   protected:  // storage
+    std::mutex                                    mutex;
+    std::map<std::string, std::shared_ptr<Node>> files;
+    size_t                                        capacity;
+  };
+
+}  // namespace Effortless_SPIFFS_Internal
+
+// Backend keeping every file in Effortless_SPIFFS_RAM_SIZE bytes of heap, shared by every instance and lost on restart
+struct eSPIFFSRAM {
+  static const bool RENAME_REPLACES = true;
+  static const char* name() {
+    return "RAM";
+  }
+  static fs::FS& fileSystem() {
+    static fs::FS files(ram());
+    return files;
+  }
+  static bool begin() {
+    return true;
+  }
+  static void end() {}  // Files are kept until restart or format
+  static uint64_t totalBytes() {
+    return Effortless_SPIFFS_RAM_SIZE;
+  }
+  static size_t usedBytes() {
+    return ram()->usedBytes();
+  }
+  static void format() {
+    ram()->format();
+  }
+
+ private:
+  static std::shared_ptr<Effortless_SPIFFS_Internal::RamFS> ram() {
+    static std::shared_ptr<Effortless_SPIFFS_Internal::RamFS> fileSystem = std::make_shared<Effortless_SPIFFS_Internal::RamFS>(Effortless_SPIFFS_RAM_SIZE);
+    return fileSystem;
+  }
+};
+
+#else
+#error The RAM backend needs the ESP32 file system interface, use eSPIFFSTiered to keep files in RAM on ESP8266
+#endif
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
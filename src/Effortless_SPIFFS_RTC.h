@@ -0,0 +1,130 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS_RAM.h"
+
+#ifndef Effortless_SPIFFS_RTC_h
+#define Effortless_SPIFFS_RTC_h
+
+#if defined(ESP32)
+
+// Effortless SPIFFS RTC Backend Constants
+#ifndef Effortless_SPIFFS_RTC_FS_SIZE
+#define Effortless_SPIFFS_RTC_FS_SIZE 2048
+#endif
+
+namespace Effortless_SPIFFS_Internal {
+  static const size_t   RTC_FS_WORDS = (Effortless_SPIFFS_RTC_FS_SIZE + 3) / 4;
+  static const uint32_t RTC_FS_MAGIC = 0x53465452;  // "RTFS"
+
+  inline uint32_t* rtcFileMemory() {
+    // Kept through deep sleep and resets, garbage after power on until the magic and crc32 match
+    static RTC_NOINIT_ATTR uint32_t memory[RTC_FS_WORDS];
+    return memory;
+  }
+
+  // RAM files copied whole into RTC memory after every change and brought back from it when first used after a reset
+  class RtcFS : public RamFS {
+   public:
+    RtcFS() : RamFS(RTC_FS_WORDS * 4 - RTC_HEADER) {
+      load();
+    }
+
+   public:  // fs::FSImpl
+    fs::FileImplPtr open(const char* _path, const char* _mode, const bool _create) override {
+      if (!_path || strlen(_path) > 0xFF) return fs::FileImplPtr();
+      return RamFS::open(_path, _mode, _create);
+    }
+    bool rename(const char* _pathFrom, const char* _pathTo) override {
+      if (!_pathTo || strlen(_pathTo) > 0xFF) return false;
+      return RamFS::rename(_pathFrom, _pathTo);
+    }
+
+   protected:  // image - magic, crc32 and length, then name length, contents length (le16), name and contents of each file
+    static const size_t RTC_HEADER = 12;
+    static const size_t RTC_ENTRY = 3;
+
+    size_t cost(const std::string& _path, size_t _size) override {
+      return RTC_ENTRY + _path.size() + _size;
+    }
+    void changed() override {
+      // Written in place with the header last, a reset part way through leaves an image whose crc32 does not match
+      uint32_t* words = rtcFileMemory();
+      uint8_t*  bytes = (uint8_t*)words;
+      size_t    length = RTC_HEADER;
+      words[0] = 0;
+      for (auto& file : files) {
+        const std::vector<uint8_t>& data = file.second->data;
+        bytes[length++] = file.first.size();
+        bytes[length++] = data.size() & 0xFF;
+        bytes[length++] = data.size() >> 8;
+        memcpy(bytes + length, file.first.data(), file.first.size());
+        length += file.first.size();
+        if (!data.empty()) memcpy(bytes + length, data.data(), data.size());
+        length += data.size();
+      }
+      words[2] = length;
+      words[1] = crc32(bytes + 8, length - 8);
+      words[0] = RTC_FS_MAGIC;
+    }
+    void load() {
+      const uint32_t* words = rtcFileMemory();
+      const uint8_t*  bytes = (const uint8_t*)words;
+      size_t          length = words[2];
+      if (words[0] != RTC_FS_MAGIC || length < RTC_HEADER || length > RTC_FS_WORDS * 4 || crc32(bytes + 8, length - 8) != words[1]) return;
+      for (size_t position = RTC_HEADER; position + RTC_ENTRY <= length;) {
+        size_t nameLen = bytes[position];
+        size_t dataLen = bytes[position + 1] | (bytes[position + 2] << 8);
+        position += RTC_ENTRY;
+        if (position + nameLen + dataLen > length) break;
+        std::shared_ptr<Node> node = std::make_shared<Node>();
+        node->data.assign(bytes + position + nameLen, bytes + position + nameLen + dataLen);
+        files[std::string((const char*)bytes + position, nameLen)] = node;
+        position += nameLen + dataLen;
+      }
+    }
+  };
+
+}  // namespace Effortless_SPIFFS_Internal
+
+// Backend keeping every file in Effortless_SPIFFS_RTC_FS_SIZE bytes of RTC memory, kept through deep sleep and resets but lost when the power goes
+struct eSPIFFSRTC {
+  static const bool RENAME_REPLACES = true;
+  static const char* name() {
+    return "RTC";
+  }
+  static fs::FS& fileSystem() {
+    static fs::FS files(rtc());
+    return files;
+  }
+  static bool begin() {
+    return true;
+  }
+  static void end() {}  // Files are kept until the power goes or format
+  static uint64_t totalBytes() {
+    return Effortless_SPIFFS_Internal::RTC_FS_WORDS * 4;
+  }
+  static size_t usedBytes() {
+    return rtc()->usedBytes();
+  }
+  static void format() {
+    rtc()->format();
+  }
+
+ private:
+  static std::shared_ptr<Effortless_SPIFFS_Internal::RtcFS> rtc() {
+    static std::shared_ptr<Effortless_SPIFFS_Internal::RtcFS> fileSystem = std::make_shared<Effortless_SPIFFS_Internal::RtcFS>();
+    return fileSystem;
+  }
+};
+
+#else
+#error The RTC backend needs the ESP32 file system interface, use eSPIFFSTiered with RTC_TIER to keep files in RTC memory on ESP8266
+#endif
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
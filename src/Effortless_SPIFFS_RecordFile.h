@@ -0,0 +1,71 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_RecordFile_h
+#define Effortless_SPIFFS_RecordFile_h
+
+// File of fixed size records that are read and overwritten in place by index
+template <class T, class FileSystem = eSPIFFS>
+class eSPIFFSRecordFile {
+  static_assert(std::is_trivially_copyable<T>::value, "eSPIFFSRecordFile records must be plain structs that can be copied with memcpy");
+
+ public:  // constructors
+  eSPIFFSRecordFile(FileSystem& _fileSystem, const char* _filename, Print* _debug = nullptr)
+      : fileSystem(_fileSystem), filename(_filename), printer(_debug) {}
+
+ public:  // record methods
+  bool read(size_t _index, T& _output) {
+    return fileSystem.readRange(filename.c_str(), _index * RECORD_SIZE, (uint8_t*)&_output, RECORD_SIZE);
+  }
+  bool write(size_t _index, const T& _record) {
+    // Overwrite an existing record, or add one when the index is one past the end
+    size_t numRecords = size();
+    if (_index < numRecords) return fileSystem.updateRange(filename.c_str(), _index * RECORD_SIZE, (const uint8_t*)&_record, RECORD_SIZE);
+    if (_index == numRecords) return fileSystem.appendFile(filename.c_str(), (const uint8_t*)&_record, RECORD_SIZE);
+    ESPIFFS_DEBUG("[write] - Record index is past the end of the file: ");
+    ESPIFFS_DEBUGLN(filename.c_str());
+    return false;
+  }
+  bool append(const T& _record) {
+    return fileSystem.appendFile(filename.c_str(), (const uint8_t*)&_record, RECORD_SIZE);
+  }
+  template <class F>
+  bool writeField(size_t _index, size_t _offset, const F& _value) {
+    // Overwrite one field of a record, use offsetof(T, field) for the offset
+    if (_offset + sizeof(F) > RECORD_SIZE) return false;
+    return fileSystem.updateField(filename.c_str(), _index * RECORD_SIZE + _offset, _value);
+  }
+  template <class F>
+  bool readField(size_t _index, size_t _offset, F& _value) {
+    if (_offset + sizeof(F) > RECORD_SIZE) return false;
+    return fileSystem.readField(filename.c_str(), _index * RECORD_SIZE + _offset, _value);
+  }
+  bool resize(size_t _count) {
+    // Create the file with a number of zeroed records, keeping any that are already there
+    std::vector<uint8_t> contents(_count * RECORD_SIZE, 0x00);
+    size_t               numKept = size() < _count ? size() : _count;
+    if (numKept && !fileSystem.readRange(filename.c_str(), 0, contents.data(), numKept * RECORD_SIZE)) return false;
+    if (contents.empty()) return fileSystem.removeFile(filename.c_str()) || !fileSystem.exists(filename.c_str());
+    return fileSystem.saveFile(filename.c_str(), contents.data(), contents.size());
+  }
+  size_t size() {
+    return fileSystem.getFileSize(filename.c_str()) / RECORD_SIZE;
+  }
+
+ private:  // record format - the struct exactly as laid out in memory, no header
+  static const size_t RECORD_SIZE = sizeof(T);
+
+ private:  // storage
+  FileSystem& fileSystem;
+  std::string filename;
+  Print*      printer = nullptr;
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
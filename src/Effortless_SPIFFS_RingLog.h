@@ -0,0 +1,231 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_RingLog_h
+#define Effortless_SPIFFS_RingLog_h
+
+// Effortless SPIFFS Ring Log Constants
+#ifndef Effortless_SPIFFS_LOG_BUFFER
+#define Effortless_SPIFFS_LOG_BUFFER 8
+#endif
+
+// Fixed capacity circular log of fixed size binary records in a single preallocated file
+template <class T, class FileSystem = eSPIFFS>
+class eSPIFFSRingLog {
+  static_assert(std::is_trivially_copyable<T>::value, "eSPIFFSRingLog records must be plain structs that can be copied with memcpy");
+
+ public:  // constructors
+  eSPIFFSRingLog(FileSystem& _fileSystem, const char* _filename, size_t _capacity, size_t _bufferRecords = Effortless_SPIFFS_LOG_BUFFER, Print* _debug = nullptr)
+      : fileSystem(_fileSystem), filename(_filename), numSlots(_capacity ? _capacity : 1), printer(_debug) {
+    // A flush writes each buffered slot once, so the buffer never holds more than one lap of the ring
+    bufferRecords = _bufferRecords ? _bufferRecords : 1;
+    if (bufferRecords > numSlots) bufferRecords = numSlots;
+  }
+  ~eSPIFFSRingLog() {
+    end();
+  }
+
+ public:  // log methods
+  bool begin() {
+    // Open the log once and keep the handle for every append
+    if (logFile) return true;
+    if (!fileSystem.mount()) return false;
+
+    logFile = fileSystem.getFile(filename.c_str(), "r+");
+    if (!logFile || logFile.size() != numSlots * SLOT_SIZE) {
+      if (logFile) ESPIFFS_DEBUGLN("[begin] - Log file has a different capacity, starting a new log");
+      logFile.close();
+      if (!preallocate()) return false;
+      logFile = fileSystem.getFile(filename.c_str(), "r+");
+      if (!logFile) return false;
+    }
+
+    recoverHead();
+    buffer.reserve(bufferRecords * SLOT_SIZE);
+    return true;
+  }
+  void end() {
+    if (logFile) {
+      flush();
+      logFile.close();
+    }
+  }
+  bool append(const T& _record) {
+    if (!begin()) return false;
+
+    // Build the slot in the write buffer, flushing once it holds a full batch
+    uint8_t slot[SLOT_SIZE];
+    buildSlot(nextSeq, _record, slot);
+    buffer.insert(buffer.end(), slot, slot + SLOT_SIZE);
+    nextSeq++;
+    if (buffer.size() >= bufferRecords * SLOT_SIZE) return flush();
+    return true;
+  }
+  bool flush() {
+    // Write the buffered slots with at most two writes, splitting where the ring wraps
+    if (!logFile || buffer.empty()) return true;
+    size_t numBuffered = buffer.size() / SLOT_SIZE;
+    size_t firstSlot = (nextSeq - numBuffered - 1) % numSlots;
+    size_t numToEnd = numSlots - firstSlot < numBuffered ? numSlots - firstSlot : numBuffered;
+
+    bool success = writeSlots(firstSlot, buffer.data(), numToEnd);
+    if (success && numToEnd < numBuffered) success = writeSlots(0, buffer.data() + numToEnd * SLOT_SIZE, numBuffered - numToEnd);
+    logFile.flush();
+    buffer.clear();
+    if (!success) ESPIFFS_DEBUGLN("[flush] - Failed to write log records");
+    return success;
+  }
+  size_t readLast(T* _output, size_t _count) {
+    // Read the newest records oldest first, without touching the rest of the file
+    if (!begin()) return 0;
+    size_t numRecords = size();
+    if (_count > numRecords) _count = numRecords;
+
+    size_t   numRead = 0;
+    uint32_t firstSeq = nextSeq - _count;
+    size_t   numBuffered = buffer.size() / SLOT_SIZE;
+    uint32_t firstBufferedSeq = nextSeq - numBuffered;
+    for (uint32_t seq = firstSeq; seq < nextSeq;) {
+      if (seq >= firstBufferedSeq) {
+        // Still in the write buffer
+        if (parseSlot(buffer.data() + (seq - firstBufferedSeq) * SLOT_SIZE, seq, _output[numRead])) numRead++;
+        seq++;
+        continue;
+      }
+
+      // A slot larger than the chunk is read on its own, straight into the output
+      uint8_t chunk[Effortless_SPIFFS_CHUNK_SIZE];
+      size_t  slotIndex = (seq - 1) % numSlots;
+      if (SLOT_SIZE > sizeof(chunk)) {
+        bool intact;
+        if (!readLargeSlot(slotIndex, seq, _output[numRead], intact)) break;
+        if (intact) numRead++;
+        seq++;
+        continue;
+      }
+
+      // Otherwise read a contiguous run of slots up to the buffer, the end of the file or the chunk size
+      size_t numSlotsToRead = firstBufferedSeq - seq;
+      size_t maxSlots = sizeof(chunk) / SLOT_SIZE;
+      if (numSlotsToRead > numSlots - slotIndex) numSlotsToRead = numSlots - slotIndex;
+      if (numSlotsToRead > maxSlots) numSlotsToRead = maxSlots;
+      if (!logFile.seek(slotIndex * SLOT_SIZE) || logFile.read(chunk, numSlotsToRead * SLOT_SIZE) != numSlotsToRead * SLOT_SIZE) break;
+      for (size_t i = 0; i < numSlotsToRead; i++, seq++) {
+        if (parseSlot(chunk + i * SLOT_SIZE, seq, _output[numRead])) numRead++;
+      }
+    }
+    return numRead;
+  }
+  size_t size() const {
+    return nextSeq - 1 < numSlots ? nextSeq - 1 : numSlots;
+  }
+  size_t capacity() const {
+    return numSlots;
+  }
+  bool clear() {
+    // Overwrite every slot and start a new empty log
+    buffer.clear();
+    logFile.close();
+    if (!fileSystem.mount() || !preallocate()) return false;
+    return begin();
+  }
+
+ private:  // slot format - sequence number (le32), record, crc8
+  static const size_t SLOT_SIZE = 4 + sizeof(T) + 1;
+
+  void buildSlot(uint32_t _seq, const T& _record, uint8_t* _slot) {
+    for (size_t i = 0; i < 4; i++) _slot[i] = _seq >> (8 * i);
+    memcpy(_slot + 4, &_record, sizeof(T));
+    _slot[SLOT_SIZE - 1] = Effortless_SPIFFS_Internal::crc8(_slot, SLOT_SIZE - 1);
+  }
+  uint32_t slotSeq(const uint8_t* _slot) {
+    // Sequence number of a slot, zero if it is empty or damaged
+    if (Effortless_SPIFFS_Internal::crc8(_slot, SLOT_SIZE - 1) != _slot[SLOT_SIZE - 1]) return 0;
+    return _slot[0] | (_slot[1] << 8) | ((uint32_t)_slot[2] << 16) | ((uint32_t)_slot[3] << 24);
+  }
+  bool parseSlot(const uint8_t* _slot, uint32_t _seq, T& _record) {
+    if (slotSeq(_slot) != _seq) return false;
+    memcpy(&_record, _slot + 4, sizeof(T));
+    return true;
+  }
+  bool readLargeSlot(size_t _slotIndex, uint32_t _seq, T& _record, bool& _intact) {
+    // Read the record straight into the output, it only counts if the sequence number and crc match
+    uint8_t seqBytes[4];
+    uint8_t storedCrc;
+    if (!logFile.seek(_slotIndex * SLOT_SIZE) || logFile.read(seqBytes, 4) != 4) return false;
+    if (logFile.read((uint8_t*)&_record, sizeof(T)) != sizeof(T) || logFile.read(&storedCrc, 1) != 1) return false;
+    uint8_t crc = Effortless_SPIFFS_Internal::crc8((const uint8_t*)&_record, sizeof(T), Effortless_SPIFFS_Internal::crc8(seqBytes, 4));
+    _intact = storedCrc == crc && (seqBytes[0] | (seqBytes[1] << 8) | ((uint32_t)seqBytes[2] << 16) | ((uint32_t)seqBytes[3] << 24)) == _seq;
+    return true;
+  }
+  uint32_t readSeq(size_t _slotIndex) {
+    uint8_t slot[SLOT_SIZE];
+    if (logFile.seek(_slotIndex * SLOT_SIZE) && logFile.read(slot, SLOT_SIZE) == SLOT_SIZE) return slotSeq(slot);
+    return 0;
+  }
+  void recoverHead() {
+    // Slot i holds sequence number i + 1 plus a whole number of laps, so every slot written in the
+    // newest lap has seq - i equal to slot 0 and the head can be found with a binary search
+    nextSeq = 1;
+    uint32_t firstSeq = readSeq(0);
+    if (firstSeq == 0) {
+      // Either a new log or the write of slot 0 was torn after wrapping
+      uint32_t lastSeq = readSeq(numSlots - 1);
+      if (lastSeq) nextSeq = lastSeq + 1;
+      return;
+    }
+
+    size_t low = 0;
+    size_t high = numSlots - 1;
+    while (low < high) {
+      size_t   middle = (low + high + 1) / 2;
+      uint32_t seq = readSeq(middle);
+      if (seq && seq - middle == firstSeq) {
+        low = middle;
+      } else {
+        high = middle - 1;
+      }
+    }
+    nextSeq = firstSeq + low + 1;
+  }
+  bool preallocate() {
+    // Fill the whole log with empty slots so appends never grow the file
+    File newFile = fileSystem.getFile(filename.c_str(), "w");
+    if (!newFile) return false;
+    uint8_t zeros[Effortless_SPIFFS_CHUNK_SIZE];
+    memset(zeros, 0x00, sizeof(zeros));
+    for (size_t remaining = numSlots * SLOT_SIZE; remaining;) {
+      size_t numBytes = remaining < sizeof(zeros) ? remaining : sizeof(zeros);
+      if (newFile.write(zeros, numBytes) != numBytes) {
+        ESPIFFS_DEBUGLN("[begin] - Failed to preallocate log file, is there enough space?");
+        return false;
+      }
+      remaining -= numBytes;
+    }
+    newFile.close();
+    nextSeq = 1;
+    return true;
+  }
+  bool writeSlots(size_t _slotIndex, const uint8_t* _slots, size_t _numSlots) {
+    return logFile.seek(_slotIndex * SLOT_SIZE) && logFile.write(_slots, _numSlots * SLOT_SIZE) == _numSlots * SLOT_SIZE;
+  }
+
+ private:  // storage
+  FileSystem&          fileSystem;
+  std::string          filename;
+  size_t               numSlots;
+  size_t               bufferRecords;
+  Print*               printer = nullptr;
+  File                 logFile;
+  uint32_t             nextSeq = 1;
+  std::vector<uint8_t> buffer;
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
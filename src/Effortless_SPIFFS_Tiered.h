@@ -0,0 +1,494 @@
+#pragma once
+
+#ifdef __cplusplus
+
+#include "Effortless_SPIFFS.h"
+
+#ifndef Effortless_SPIFFS_Tiered_h
+#define Effortless_SPIFFS_Tiered_h
+
+// Effortless SPIFFS Tiered Constants
+#ifndef Effortless_SPIFFS_TIER_SIZE
+#define Effortless_SPIFFS_TIER_SIZE 1024
+#endif
+
+#ifndef Effortless_SPIFFS_RTC_SIZE
+#define Effortless_SPIFFS_RTC_SIZE 256
+#endif
+
+#ifndef Effortless_SPIFFS_RTC_OFFSET
+#define Effortless_SPIFFS_RTC_OFFSET 0
+#endif
+
+// Effortless SPIFFS RTC memory - kept through deep sleep and resets, lost when the power goes
+namespace Effortless_SPIFFS_Internal {
+  static const size_t   RTC_WORDS = (Effortless_SPIFFS_RTC_SIZE + 3) / 4;
+  static const uint32_t RTC_MAGIC = 0x52546945;  // "EiTR"
+#if defined(ESP32)
+  inline uint32_t* rtcMemory() {
+    static RTC_NOINIT_ATTR uint32_t memory[RTC_WORDS];
+    return memory;
+  }
+  inline bool rtcRead(uint32_t* _output) {
+    memcpy(_output, rtcMemory(), RTC_WORDS * 4);
+    return true;
+  }
+  inline bool rtcWrite(const uint32_t* _input) {
+    memcpy(rtcMemory(), _input, RTC_WORDS * 4);
+    return true;
+  }
+#else
+  // ESP8266 keeps 512 bytes of RTC user memory, the offset is in 4 byte blocks
+  inline bool rtcRead(uint32_t* _output) {
+    return ESP.rtcUserMemoryRead(Effortless_SPIFFS_RTC_OFFSET, _output, RTC_WORDS * 4);
+  }
+  inline bool rtcWrite(const uint32_t* _input) {
+    return ESP.rtcUserMemoryWrite(Effortless_SPIFFS_RTC_OFFSET, (uint32_t*)_input, RTC_WORDS * 4);
+  }
+#endif
+}  // namespace Effortless_SPIFFS_Internal
+
+// eSPIFFS that keeps chosen files in RAM or RTC memory and only writes them to the file system of a backend on a policy
+template <class Backend>
+class eSPIFFSTieredOn : public eSPIFFSOn<Backend, eSPIFFSTieredOn<Backend> > {
+  typedef eSPIFFSOn<Backend, eSPIFFSTieredOn<Backend> > Base;
+  friend Base;
+
+ public:  // constructors
+  enum Tier {
+    RAM_TIER,  // Hot files live in RAM and are lost on a reset unless persisted
+    RTC_TIER,  // Changed hot files are also kept in RTC memory so they survive deep sleep and resets
+  };
+  eSPIFFSTieredOn(Tier _tier = RAM_TIER, Print* _debug = nullptr) : Base(_debug), tier(_tier), persistOnSleep(_tier == RAM_TIER) {
+#if defined(ESP32)
+    tierMutex = xSemaphoreCreateMutex();
+#endif
+  }
+  ~eSPIFFSTieredOn() {
+    persist();
+#if defined(ESP32)
+    vSemaphoreDelete(tierMutex);
+#endif
+  }
+
+ public:  // tier methods
+  void addHotFile(const char* _filename) {
+    // Call from setup() for every hot file, on the RTC tier this also brings back files kept through deep sleep
+    TierLock lock(*this);
+    restoreRtc();
+    if (!findHot(_filename)) {
+      hotFiles.push_back(HotFile());
+      hotFiles.back().name = _filename;
+    }
+  }
+  bool isHot(const char* _filename) {
+    TierLock lock(*this);
+    return findHot(_filename) != nullptr;
+  }
+  void setPersistInterval(unsigned long _interval) {
+    // Write changed hot files to flash at most this often in ms, 0 only writes them on persist() or prepareSleep()
+    TierLock lock(*this);
+    persistInterval = _interval;
+    lastPersist = millis();
+  }
+  void setPersistOnSleep(bool _persist) {
+    persistOnSleep = _persist;
+  }
+  bool persist() {
+    // Write every changed hot file to flash, call before a restart or power off
+    std::vector<std::string> names;
+    {
+      TierLock lock(*this);
+      for (size_t i = 0; i < hotFiles.size(); i++) {
+        if (hotFiles[i].dirty) names.push_back(hotFiles[i].name);
+      }
+      lastPersist = millis();
+    }
+    bool success = true;
+    for (size_t i = 0; i < names.size(); i++) success &= persistFile(names[i].c_str());
+    return success;
+  }
+  void handlePersist() {
+    // Call from loop() to honour the persist interval when nothing is being saved
+    if (persistDue()) persist();
+  }
+  bool prepareSleep() {
+    // Call right before deep sleep, the RAM tier is written to flash and the RTC tier is already kept
+    if (persistOnSleep) return persist();
+    return true;
+  }
+  size_t changedFiles() {
+    TierLock lock(*this);
+    size_t   numChanged = 0;
+    for (size_t i = 0; i < hotFiles.size(); i++) numChanged += hotFiles[i].dirty;
+    return numChanged;
+  }
+
+ public:  // eSPIFFS overrides
+  using Base::appendFile;
+  using Base::saveFile;
+  int getFileSize(const char* _filename) {
+    int size = 0;
+    if (withHot(_filename, [&](HotFile& _file) {
+          size = _file.present ? _file.data.size() : 0;
+          return true;
+        })) {
+      return size;
+    }
+    return Base::getFileSize(_filename);
+  }
+  bool exists(const char* _filename) {
+    bool present = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          present = _file.present;
+          return true;
+        })) {
+      return present;
+    }
+    return Base::exists(_filename);
+  }
+  bool openFile(const char* _filename, char* _output, size_t _len = 0) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          size_t numBytesToRead = (_len > 0 && _len <= _file.data.size()) ? _len : _file.data.size();
+          memcpy(_output, _file.data.data(), numBytesToRead);
+          success = _file.present && numBytesToRead;
+          return true;
+        })) {
+      return success;
+    }
+    return Base::openFile(_filename, _output, _len);
+  }
+  bool saveFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    if (_len && storeHot(_filename, _input, _len, false)) return true;
+    return Base::saveFile(_filename, _input, _len);
+  }
+  bool appendFile(const char* _filename, const uint8_t* _input, size_t _len) {
+    if (_len && storeHot(_filename, _input, _len, true)) return true;
+    return Base::appendFile(_filename, _input, _len);
+  }
+  bool updateRange(const char* _filename, size_t _offset, const uint8_t* _input, size_t _len) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          success = _file.present && _len && _offset + _len <= _file.data.size();
+          if (success && memcmp(&_file.data[_offset], _input, _len) != 0) {
+            memcpy(&_file.data[_offset], _input, _len);
+            markChanged(_file);
+          }
+          return true;
+        })) {
+      return success && afterChange(_filename);
+    }
+    return Base::updateRange(_filename, _offset, _input, _len);
+  }
+  bool readRange(const char* _filename, size_t _offset, uint8_t* _output, size_t _len) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          success = _file.present && _len && _offset + _len <= _file.data.size();
+          if (success) memcpy(_output, &_file.data[_offset], _len);
+          return true;
+        })) {
+      return success;
+    }
+    return Base::readRange(_filename, _offset, _output, _len);
+  }
+  bool removeFile(const char* _filename) {
+    // Changes that were never persisted are dropped along with the file
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (file) dropFile(*file);
+    }
+    return Base::removeFile(_filename);
+  }
+
+ protected:  // eSPIFFS overrides
+  bool readValue(const char* _filename, char* _output, size_t _size, size_t& _fileSize) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          _fileSize = _file.data.size();
+          size_t numBytesRead = _fileSize < _size ? _fileSize : _size - 1;
+          memcpy(_output, _file.data.data(), numBytesRead);
+          _output[numBytesRead] = 0x00;
+          success = _file.present && numBytesRead;
+          return true;
+        })) {
+      return success;
+    }
+    return Base::readValue(_filename, _output, _size, _fileSize);
+  }
+  bool readText(const char* _filename, std::string& _output) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          _output = _file.data;
+          success = _file.present && !_output.empty();
+          return true;
+        })) {
+      return success;
+    }
+    return Base::readText(_filename, _output);
+  }
+  bool readText(const char* _filename, String& _output) {
+    bool success = false;
+    if (withHot(_filename, [&](HotFile& _file) {
+          _output = _file.data.c_str();
+          success = _file.present && _output.length();
+          return true;
+        })) {
+      return success;
+    }
+    return Base::readText(_filename, _output);
+  }
+  void beforeAccess(const char* _filename, bool) {
+    // Anything else that touches a hot file, such as ArduinoJson or getFile, sees it on flash and reloads it afterwards
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (!file || !file->loaded || file->writer == currentTask()) return;
+    }
+    persistFile(_filename);
+    TierLock lock(*this);
+    HotFile* file = findHot(_filename);
+    if (file && !file->dirty) dropFile(*file);
+  }
+
+ private:  // hot files
+  struct HotFile {
+    std::string name;
+    std::string data;
+    bool        loaded = false;   // Contents are held here, otherwise they are only on flash
+    bool        present = false;  // File exists with some contents
+    bool        dirty = false;    // Contents have changed since they were last written to flash
+    uint32_t    version = 0;
+    void*       writer = nullptr;  // Task writing the contents to flash
+  };
+  HotFile* findHot(const char* _filename) {
+    for (size_t i = 0; i < hotFiles.size(); i++) {
+      if (hotFiles[i].name == _filename) return &hotFiles[i];
+    }
+    return nullptr;
+  }
+  bool loadHot(const char* _filename) {
+    // Returns false if the file is not hot, otherwise reads it from flash the first time it is used
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (!file) return false;
+      if (file->loaded) return true;
+    }
+    std::string contents;
+    bool        present = Base::readText(_filename, contents);
+    TierLock    lock(*this);
+    HotFile*    file = findHot(_filename);
+    if (!file) return false;
+    if (!file->loaded && hotUsage() + contents.size() <= Effortless_SPIFFS_TIER_SIZE) {
+      file->data = std::move(contents);
+      file->present = present;
+      file->loaded = true;
+    }
+    return file->loaded;
+  }
+  template <class F>
+  bool withHot(const char* _filename, F _callback) {
+    // Run the callback on a loaded hot file, false if the file is not hot or too large to hold
+    if (!loadHot(_filename)) return false;
+    TierLock lock(*this);
+    HotFile* file = findHot(_filename);
+    return file && file->loaded && _callback(*file);
+  }
+  bool storeHot(const char* _filename, const uint8_t* _input, size_t _len, bool _append) {
+    // Appends need the current contents, saves replace them, files that do not fit are written straight to flash
+    if (_append && !loadHot(_filename)) return false;
+    bool tooLarge;
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (!file) return false;
+      size_t newSize = (_append ? file->data.size() : 0) + _len;
+      tooLarge = hotUsage() - (file->loaded ? file->data.size() : 0) + newSize > Effortless_SPIFFS_TIER_SIZE;
+    }
+    if (tooLarge) {
+      beforeAccess(_filename, true);
+      return false;
+    }
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (!file) return false;
+      if (!_append && file->loaded && file->present && file->data.size() == _len && memcmp(file->data.data(), _input, _len) == 0) return true;
+      if (_append) {
+        file->data.append((const char*)_input, _len);
+      } else {
+        file->data.assign((const char*)_input, _len);
+      }
+      file->loaded = true;
+      file->present = true;
+      markChanged(*file);
+    }
+    return afterChange(_filename);
+  }
+  void markChanged(HotFile& _file) {
+    _file.dirty = true;
+    _file.version++;
+  }
+  bool afterChange(const char* _filename) {
+    // Keep the RTC copy up to date, writing the file to flash if the RTC memory is full, then honour the interval
+    bool rtcFull;
+    {
+      TierLock lock(*this);
+      rtcFull = !saveRtc();
+    }
+    if (rtcFull) {
+      ESPIFFS_DEBUG("[tier] - RTC memory is full, writing hot file to flash: ");
+      ESPIFFS_DEBUGLN(_filename);
+      if (!persistFile(_filename)) return false;
+    }
+    if (persistDue()) return persist();
+    return true;
+  }
+  bool persistFile(const char* _filename) {
+    // Write the contents through eSPIFFS so the cache, index and atomic saves all apply
+    std::string contents;
+    uint32_t    version;
+    {
+      TierLock lock(*this);
+      HotFile* file = findHot(_filename);
+      if (!file || !file->dirty || file->writer) return true;
+      contents = file->data;
+      version = file->version;
+      file->writer = currentTask();
+    }
+    bool success = contents.empty() ? true : Base::saveFile(_filename, (const uint8_t*)contents.data(), contents.size());
+    TierLock lock(*this);
+    HotFile* file = findHot(_filename);
+    if (file) {
+      file->writer = nullptr;
+      if (success && file->version == version) file->dirty = false;
+      saveRtc();
+    }
+    if (!success) {
+      ESPIFFS_DEBUG("[tier] - Failed to write hot file to flash: ");
+      ESPIFFS_DEBUGLN(_filename);
+    }
+    return success;
+  }
+  void dropFile(HotFile& _file) {
+    std::string().swap(_file.data);
+    _file.loaded = false;
+    _file.present = false;
+    _file.dirty = false;
+    saveRtc();
+  }
+  bool persistDue() {
+    TierLock lock(*this);
+    return persistInterval && millis() - lastPersist >= persistInterval;
+  }
+  size_t hotUsage() const {
+    size_t usage = 0;
+    for (size_t i = 0; i < hotFiles.size(); i++) usage += hotFiles[i].data.size();
+    return usage;
+  }
+
+ private:  // rtc copy - magic, crc32 and length, then name length, contents length (le16), name and contents of each changed file
+  static const size_t RTC_HEADER = 12;
+
+  bool saveRtc() {
+    // Returns false if the changed files do not fit, tier lock must be held
+    if (tier != RTC_TIER) return true;
+    uint32_t words[Effortless_SPIFFS_Internal::RTC_WORDS] = {};
+    uint8_t* bytes = (uint8_t*)words;
+    size_t   length = RTC_HEADER;
+    for (size_t i = 0; i < hotFiles.size(); i++) {
+      const HotFile& file = hotFiles[i];
+      if (!file.dirty) continue;
+      if (file.name.size() > 0xFF || file.data.size() > 0xFFFF || length + 3 + file.name.size() + file.data.size() > sizeof(words)) return false;
+      bytes[length++] = file.name.size();
+      bytes[length++] = file.data.size() & 0xFF;
+      bytes[length++] = file.data.size() >> 8;
+      memcpy(bytes + length, file.name.data(), file.name.size());
+      length += file.name.size();
+      memcpy(bytes + length, file.data.data(), file.data.size());
+      length += file.data.size();
+    }
+    words[0] = Effortless_SPIFFS_Internal::RTC_MAGIC;
+    words[2] = length;
+    words[1] = Effortless_SPIFFS_Internal::crc32(bytes + 8, length - 8);
+    return Effortless_SPIFFS_Internal::rtcWrite(words);
+  }
+  void restoreRtc() {
+    // Bring back files changed before deep sleep or a reset, tier lock must be held
+    if (tier != RTC_TIER || restored) return;
+    restored = true;
+    uint32_t words[Effortless_SPIFFS_Internal::RTC_WORDS];
+    uint8_t* bytes = (uint8_t*)words;
+    if (!Effortless_SPIFFS_Internal::rtcRead(words) || words[0] != Effortless_SPIFFS_Internal::RTC_MAGIC) return;
+    size_t length = words[2];
+    if (length < RTC_HEADER || length > sizeof(words) || Effortless_SPIFFS_Internal::crc32(bytes + 8, length - 8) != words[1]) return;
+    for (size_t position = RTC_HEADER; position + 3 <= length;) {
+      size_t nameLen = bytes[position];
+      size_t dataLen = bytes[position + 1] | (bytes[position + 2] << 8);
+      position += 3;
+      if (position + nameLen + dataLen > length) break;
+      std::string name((const char*)bytes + position, nameLen);
+      HotFile*    file = findHot(name.c_str());
+      if (!file) {
+        hotFiles.push_back(HotFile());
+        file = &hotFiles.back();
+        file->name = name;
+      }
+      file->data.assign((const char*)bytes + position + nameLen, dataLen);
+      file->loaded = true;
+      file->present = true;
+      markChanged(*file);
+      position += nameLen + dataLen;
+    }
+  }
+
+ private:  // locking - the tier lock only guards the hot files and is never held while touching flash
+#if defined(ESP32)
+  struct TierLock {
+    TierLock(eSPIFFSTieredOn& _tiered) : tiered(_tiered) {
+      xSemaphoreTake(tiered.tierMutex, portMAX_DELAY);
+    }
+    ~TierLock() {
+      xSemaphoreGive(tiered.tierMutex);
+    }
+    eSPIFFSTieredOn& tiered;
+  };
+  void* currentTask() {
+    return xTaskGetCurrentTaskHandle();
+  }
+#else
+  // Single threaded
+  struct TierLock {
+    TierLock(eSPIFFSTieredOn&) {}
+  };
+  void* currentTask() {
+    return this;
+  }
+#endif
+
+ private:  // storage
+  using Base::printer;
+  Tier                 tier;
+  bool                 persistOnSleep;
+  bool                 restored = false;
+  unsigned long        persistInterval = 0;
+  unsigned long        lastPersist = 0;
+  std::vector<HotFile> hotFiles;
+#if defined(ESP32)
+  SemaphoreHandle_t tierMutex = nullptr;
+#endif
+};
+
+// Tiered eSPIFFS on the default backend, a class so it can be forward declared
+class eSPIFFSTiered : public eSPIFFSTieredOn<Effortless_SPIFFS_BACKEND> {
+ public:  // constructors
+  using eSPIFFSTieredOn<Effortless_SPIFFS_BACKEND>::eSPIFFSTieredOn;
+};
+
+#endif
+
+#else
+#error Effortless_SPIFFS requires a C++ compiler
+#endif
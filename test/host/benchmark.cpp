@@ -0,0 +1,591 @@
+// Host benchmark, runs every operation against the flash emulator and prints CSV per operation:
+// op,type,encoding,mode,value bytes,iterations,ops per sec,flash bytes per op,erases per op,opens per op,bytes written per op,cpu ns per op,peak heap bytes
+// Ops per sec is simulated flash time from the emulator's page, erase and lookup latencies, cpu ns is host time for the whole
+// operation including the emulator. Peak heap is the most allocated through new at once above what was in use at the start.
+// Usage: host_benchmark [iterations]
+#include <Arduino.h>
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>  // Before the library so its JSON overloads are built, the JSON rows are left out without it
+#endif
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_KV.h>
+#include <Effortless_SPIFFS_RingLog.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BENCHMARK_FILE "/bench.txt"
+
+// SPIFFS with the rename of LittleFS on the ESP8266, which replaces the target in one step
+struct ReplacingSPIFFS : eSPIFFSSPIFFS {
+  static const bool RENAME_REPLACES = true;
+};
+
+static int                        iterations = 100;
+static eSPIFFS                    fileSystem;
+static eSPIFFSOn<ReplacingSPIFFS> replacingFileSystem;
+
+// Heap in use and its peak, every allocation through new carries its size in front of it
+static std::atomic<size_t> heapInUse(0);
+static std::atomic<size_t> heapPeak(0);
+static size_t              heapAtStart = 0;
+
+void* operator new(size_t _size) {
+  char* block = (char*)malloc(sizeof(max_align_t) + _size);
+  if (!block) throw std::bad_alloc();
+  *(size_t*)block = _size;
+  size_t inUse = heapInUse += _size;
+  size_t peak = heapPeak;
+  while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse)) {}
+  return block + sizeof(max_align_t);
+}
+void operator delete(void* _pointer) noexcept {
+  if (!_pointer) return;
+  char* block = (char*)_pointer - sizeof(max_align_t);
+  heapInUse -= *(size_t*)block;
+  free(block);
+}
+void operator delete(void* _pointer, size_t) noexcept {
+  operator delete(_pointer);
+}
+
+static std::chrono::steady_clock::time_point started;
+
+static const char* encodingName() {
+  return fileSystem.getEncoding() == eSPIFFS::BINARY_ENCODING ? "binary" : "text";
+}
+
+static void startMeasure() {
+  // Zero the flash counters, the heap peak and the clock for the next report
+  spiffsFlash()->resetCounters();
+  heapAtStart = heapInUse;
+  heapPeak = heapAtStart;
+  started = std::chrono::steady_clock::now();
+}
+
+static void report(const char* _op, const char* _type, const char* _mode, size_t _valueBytes, int _count, size_t _bytesWritten) {
+  // Per operation figures since the last start, bytes written are what the operation produced
+  double        cpuNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+  FlashCounters counters = spiffsFlash()->counters();
+  double        opsPerSec = counters.micros ? _count * 1000000.0 / counters.micros : 0;
+  printf("%s,%s,%s,%s,%u,%d,%.1f,%.1f,%.3f,%.2f,%.1f,%.0f,%u\n", _op, _type, encodingName(), _mode, (unsigned)_valueBytes, _count, opsPerSec,
+         (double)counters.programmedBytes / _count, (double)counters.erases / _count, (double)counters.opens / _count, (double)_bytesWritten / _count,
+         cpuNanos / _count, (unsigned)(heapPeak - heapAtStart));
+}
+static void report(const char* _op, const char* _type, const char* _mode, size_t _valueBytes, int _count) {
+  report(_op, _type, _mode, _valueBytes, _count, spiffsFlash()->counters().bytesWritten);
+}
+
+// Run the same call a number of times and report the flash work it caused
+#define MEASURE(call, op, type, mode, valueBytes)  \
+  startMeasure();                                  \
+  for (int i = 0; i < iterations; i++) call;       \
+  report(op, type, mode, valueBytes, iterations);
+
+template <class T>
+static void benchmarkValue(const char* _type, T& _value, size_t _valueBytes, bool _append) {
+  T output{};
+  fileSystem.removeFile(BENCHMARK_FILE);
+  fileSystem.setAtomicSaves(false);
+  MEASURE(fileSystem.saveToFile(BENCHMARK_FILE, _value), "save", _type, "direct", _valueBytes);
+  fileSystem.setAtomicSaves(true);
+  MEASURE(fileSystem.saveToFile(BENCHMARK_FILE, _value), "save", _type, "atomic", _valueBytes);
+  spiffsFlash()->setRenameReplaces(true);
+  MEASURE(replacingFileSystem.saveToFile(BENCHMARK_FILE, _value), "save", _type, "atomic replace", _valueBytes);
+  spiffsFlash()->setRenameReplaces(false);
+  fileSystem.setAtomicSaves(false);
+  MEASURE(fileSystem.openFromFile(BENCHMARK_FILE, output), "open", _type, "direct", _valueBytes);
+  if (_append) {
+    fileSystem.removeFile(BENCHMARK_FILE);
+    MEASURE(fileSystem.appendToFile(BENCHMARK_FILE, _value), "append", _type, "direct", _valueBytes);
+  }
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+
+struct Reading {
+  uint32_t time;
+  float    value;
+  int16_t  flags;
+};
+
+// The label and value of each type in the lists below, numbers default to 100
+template <class T>
+struct Example {
+  static const char* name();
+  static void        fill(T& _value) {
+    _value = 100;
+  }
+  static size_t bytes(const T&) {
+    return sizeof(T);
+  }
+};
+template <>
+const char* Example<bool>::name() {
+  return "bool";
+}
+template <>
+void Example<bool>::fill(bool& _value) {
+  _value = true;
+}
+template <>
+const char* Example<signed char>::name() {
+  return "signed char";
+}
+template <>
+const char* Example<unsigned char>::name() {
+  return "unsigned char";
+}
+template <>
+const char* Example<short>::name() {
+  return "short";
+}
+template <>
+const char* Example<unsigned short>::name() {
+  return "unsigned short";
+}
+template <>
+const char* Example<int>::name() {
+  return "int";
+}
+template <>
+void Example<int>::fill(int& _value) {
+  _value = 123456;
+}
+template <>
+const char* Example<unsigned int>::name() {
+  return "unsigned int";
+}
+template <>
+void Example<unsigned int>::fill(unsigned int& _value) {
+  _value = 4000000000u;
+}
+template <>
+const char* Example<long>::name() {
+  return "long";
+}
+template <>
+void Example<long>::fill(long& _value) {
+  _value = -1234567890;
+}
+template <>
+const char* Example<unsigned long>::name() {
+  return "unsigned long";
+}
+template <>
+void Example<unsigned long>::fill(unsigned long& _value) {
+  _value = 4000000000ul;
+}
+template <>
+const char* Example<float>::name() {
+  return "float";
+}
+template <>
+void Example<float>::fill(float& _value) {
+  _value = 3.14159f;
+}
+template <>
+const char* Example<double>::name() {
+  return "double";
+}
+template <>
+void Example<double>::fill(double& _value) {
+  _value = 2.718281828459045;
+}
+template <>
+const char* Example<char*>::name() {
+  return "char*";
+}
+template <>
+void Example<char*>::fill(char*& _value) {
+  static char text[] = "sixteen chars ok";
+  _value = text;
+}
+template <>
+size_t Example<char*>::bytes(char* const& _value) {
+  return strlen(_value);
+}
+template <>
+const char* Example<String>::name() {
+  return "String";
+}
+template <>
+void Example<String>::fill(String& _value) {
+  _value = "sixteen chars ok";
+}
+template <>
+size_t Example<String>::bytes(const String& _value) {
+  return _value.length();
+}
+
+typedef int                   IntBlock[64];
+typedef std::array<float, 64> FloatArray;
+typedef std::vector<uint16_t> ShortVector;
+template <>
+const char* Example<IntBlock>::name() {
+  return "int[64]";
+}
+template <>
+void Example<IntBlock>::fill(IntBlock& _value) {
+  for (int i = 0; i < 64; i++) _value[i] = i * 1000;
+}
+template <>
+const char* Example<FloatArray>::name() {
+  return "std::array<float 64>";
+}
+template <>
+void Example<FloatArray>::fill(FloatArray& _value) {
+  for (int i = 0; i < 64; i++) _value[i] = i * 0.5f;
+}
+template <>
+const char* Example<ShortVector>::name() {
+  return "std::vector<uint16_t> 64";
+}
+template <>
+void Example<ShortVector>::fill(ShortVector& _value) {
+  _value.assign(64, 7);
+}
+template <>
+size_t Example<ShortVector>::bytes(const ShortVector& _value) {
+  return _value.size() * sizeof(uint16_t);
+}
+template <>
+const char* Example<Reading>::name() {
+  return "struct";
+}
+template <>
+void Example<Reading>::fill(Reading& _value) {
+  _value = {1000, 21.5f, 3};
+}
+
+template <class... Types>
+struct TypeList {};
+// One group of rows per overload, std::string has its own rows at several sizes
+typedef TypeList<bool, signed char, unsigned char, short, unsigned short, int, unsigned int, long, unsigned long, float, double, char*, String> ValueTypes;
+typedef TypeList<IntBlock, FloatArray, ShortVector, Reading> BulkTypes;
+
+static void benchmarkTypes(TypeList<>, bool) {}
+template <class T, class... Rest>
+static void benchmarkTypes(TypeList<T, Rest...>, bool _append) {
+  T value{};
+  Example<T>::fill(value);
+  benchmarkValue(Example<T>::name(), value, Example<T>::bytes(value), _append);
+  benchmarkTypes(TypeList<Rest...>(), _append);
+}
+
+static void benchmarkValues() {
+  // Every value overload in both encodings, appends are always text so they are measured once
+  for (int encoding = 0; encoding < 2; encoding++) {
+    bool text = encoding == 0;
+    fileSystem.setEncoding(text ? eSPIFFS::TEXT_ENCODING : eSPIFFS::BINARY_ENCODING);
+    replacingFileSystem.setEncoding(text ? eSPIFFSOn<ReplacingSPIFFS>::TEXT_ENCODING : eSPIFFSOn<ReplacingSPIFFS>::BINARY_ENCODING);
+    benchmarkTypes(ValueTypes(), text);
+    for (size_t size : {16, 256, 2048}) {
+      std::string value(size, 's');
+      benchmarkValue("std::string", value, size, text);
+    }
+    fileSystem.saveToFile(BENCHMARK_FILE, "sixteen chars ok");
+    eSPIFFS::CharBuffer buffer;
+    MEASURE(fileSystem.openFromFile(BENCHMARK_FILE, buffer), "open", "CharBuffer", "direct", 16);
+    fileSystem.removeFile(BENCHMARK_FILE);
+  }
+  // Blocks are binary whatever the encoding, so they are measured once with it
+  benchmarkTypes(BulkTypes(), true);
+  fileSystem.setEncoding(eSPIFFS::TEXT_ENCODING);
+  replacingFileSystem.setEncoding(eSPIFFSOn<ReplacingSPIFFS>::TEXT_ENCODING);
+}
+
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+static void benchmarkJson() {
+  // A document has no default constructor, so it gets its own rows rather than a place in the lists
+  DynamicJsonDocument document(1024);
+  DynamicJsonDocument output(1024);
+  document["name"] = "sensor";
+  document["interval"] = 60;
+  JsonArray readings = document.createNestedArray("readings");
+  for (int i = 0; i < 8; i++) readings.add(i * 1.5);
+  size_t size = measureJson(document);
+  MEASURE(fileSystem.saveToFile(BENCHMARK_FILE, document), "save", "DynamicJsonDocument", "direct", size);
+  MEASURE(fileSystem.openFromFile(BENCHMARK_FILE, output), "open", "DynamicJsonDocument", "direct", size);
+  fileSystem.removeFile(BENCHMARK_FILE);
+  MEASURE(fileSystem.appendToFile(BENCHMARK_FILE, document), "append", "DynamicJsonDocument", "direct", size);
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+#endif
+
+static std::string jsonPayload(size_t _size) {
+  // Readings laid out as ArduinoJson serializes them, the same keys over and over with changing numbers
+  std::string json = "{\"device\":\"greenhouse\",\"readings\":[";
+  char        reading[96];
+  for (int i = 0; json.size() + 64 < _size; i++) {
+    snprintf(reading, sizeof(reading), "%s{\"time\":%d,\"temperature\":%.1f,\"humidity\":%d}", i ? "," : "", 1700000000 + i * 60,
+             18 + (i * 7 % 50) / 10.0, 40 + i * 13 % 30);
+    json += reading;
+  }
+  return json + "]}";
+}
+
+static void benchmarkCompression() {
+  // The codec alone on JSON text, bytes written against value bytes is the ratio, then saves and opens of the same text
+  for (size_t size : {256, 2048, 8192}) {
+    std::string json = jsonPayload(size);
+    std::string compressed;
+    std::string decoded;
+    startMeasure();
+    for (int i = 0; i < iterations; i++) Effortless_SPIFFS_Internal::compressLZ((const uint8_t*)json.data(), json.size(), compressed);
+    report("compress", "json", "lz", json.size(), iterations, compressed.size() * iterations);
+    startMeasure();
+    for (int i = 0; i < iterations; i++) Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)compressed.data(), compressed.size(), decoded);
+    report("decompress", "json", "lz", json.size(), iterations, decoded.size() * iterations);
+    MEASURE(fileSystem.saveToFile(BENCHMARK_FILE, json), "save", "json", "direct", json.size());
+    MEASURE(fileSystem.openFromFile(BENCHMARK_FILE, decoded), "open", "json", "direct", json.size());
+    fileSystem.setCompression(true);
+    MEASURE(fileSystem.saveToFile(BENCHMARK_FILE, json), "save", "json", "compressed", json.size());
+    MEASURE(fileSystem.openFromFile(BENCHMARK_FILE, decoded), "open", "json", "compressed", json.size());
+    fileSystem.setCompression(false);
+    fileSystem.removeFile(BENCHMARK_FILE);
+  }
+}
+
+static void benchmarkContention() {
+  // Tasks saving to one shared file, each saving to its own, or all reading one file, lock waits show up as CPU time per op
+  static const char* layouts[] = {"same file", "own file", "same file reads"};
+  char               mode[40];
+  int                first = 0;
+  spiffsFlash()->setYieldOnAccess(true);
+  for (int numThreads : {1, 2, 4}) {
+    for (int layout = 0; layout < 3; layout++) {
+      bool reading = layout == 2;
+      snprintf(mode, sizeof(mode), "%s %d thread%s", layouts[layout], numThreads, numThreads > 1 ? "s" : "");
+      fileSystem.saveToFile(BENCHMARK_FILE, first);
+      std::vector<std::thread> tasks;
+      startMeasure();
+      for (int t = 0; t < numThreads; t++) {
+        tasks.push_back(std::thread([t, layout, reading]() {
+          char name[24] = BENCHMARK_FILE;
+          int  value = 0;
+          if (layout == 1) snprintf(name, sizeof(name), "/bench%d.txt", t);
+          for (int i = 0; i < iterations; i++) {
+            if (reading) fileSystem.openFromFile(name, value);
+            else fileSystem.saveToFile(name, (value = i));
+          }
+        }));
+      }
+      for (std::thread& task : tasks) task.join();
+      report(reading ? "open" : "save", "int", mode, sizeof(int), numThreads * iterations);
+      for (const std::string& name : spiffsFlash()->list()) fileSystem.removeFile(name.c_str());
+    }
+  }
+  spiffsFlash()->setYieldOnAccess(false);
+}
+
+template <class T, class Format, class Parse, class LibraryParse>
+static void benchmarkNumber(const char* _type, const std::vector<T>& _values, Format _sprintf, Parse _strto, LibraryParse _libraryParse) {
+  // Only the conversion to and from text, with sprintf and strto* as older versions did it and with the library
+  char                     text[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+  std::vector<std::string> texts;
+  volatile double          sink = 0;
+  int                      count = iterations * _values.size();
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    for (T value : _values) sink = sink + _sprintf(text, value);
+  }
+  report("format", _type, "sprintf", sizeof(T), count, 0);
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    for (T value : _values) sink = sink + Effortless_SPIFFS_Internal::formatNumber(text, value);
+  }
+  report("format", _type, "library", sizeof(T), count, 0);
+  for (T value : _values) {
+    Effortless_SPIFFS_Internal::formatNumber(text, value);
+    texts.push_back(text);
+  }
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    for (const std::string& number : texts) sink = sink + _strto(number.c_str());
+  }
+  report("parse", _type, "strto", sizeof(T), count, 0);
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    for (const std::string& number : texts) sink = sink + _libraryParse(number.c_str());
+  }
+  report("parse", _type, "library", sizeof(T), count, 0);
+}
+
+static void benchmarkNumbers() {
+  // The same 256 values of each type every time, integers of every length and decimals as sensors give them
+  std::mt19937_64     random(1);
+  std::vector<long>   integers;
+  std::vector<float>  floats;
+  std::vector<double> doubles;
+  std::vector<double> largeDoubles;
+  for (int i = 0; i < 256; i++) {
+    integers.push_back((long)(random() >> (random() % 64)) * (i % 2 ? -1 : 1));
+    floats.push_back((int)(random() % 200000 - 100000) / 100.0f);
+    doubles.push_back((int64_t)(random() % 2000000000 - 1000000000) / 10000.0);
+    largeDoubles.push_back(doubles.back() * 1e250);
+  }
+  benchmarkNumber(
+      "long", integers, [](char* _text, long _value) { return snprintf(_text, Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE, "%li", _value); },
+      [](const char* _text) { return strtol(_text, nullptr, 10); }, Effortless_SPIFFS_Internal::parseInteger<long>);
+  benchmarkNumber(
+      "float", floats,
+      [](char* _text, float _value) { return snprintf(_text, Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE, "%.*g", Effortless_SPIFFS_PRECISION, _value); },
+      [](const char* _text) { return (float)strtod(_text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<float>);
+  benchmarkNumber(
+      "double", doubles,
+      [](char* _text, double _value) { return snprintf(_text, Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE, "%.*g", Effortless_SPIFFS_PRECISION, _value); },
+      [](const char* _text) { return strtod(_text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<double>);
+  benchmarkNumber(
+      "double 1e250", largeDoubles,
+      [](char* _text, double _value) { return snprintf(_text, Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE, "%.*g", Effortless_SPIFFS_PRECISION, _value); },
+      [](const char* _text) { return strtod(_text, nullptr); }, Effortless_SPIFFS_Internal::parseFloat<double>);
+}
+
+static void benchmarkCache() {
+  // Repeated saves of a hot file held in RAM, including the final write back
+  int value = 1;
+  fileSystem.enableCache();
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    value = i;
+    fileSystem.saveToFile(BENCHMARK_FILE, value);
+  }
+  fileSystem.flush();
+  report("save", "int", "cached", sizeof(int), iterations);
+  fileSystem.disableCache();
+  fileSystem.removeFile(BENCHMARK_FILE);
+}
+
+static void benchmarkBatch(int _numFiles) {
+  // Saving many files one at a time versus as a single batch, per file
+  std::vector<eSPIFFS::BatchEntry> entries;
+  char                             name[24];
+  for (int i = 0; i < _numFiles; i++) {
+    sprintf(name, "/bench%d.txt", i);
+    entries.push_back({name, "0123456789"});
+  }
+  startMeasure();
+  for (int i = 0; i < iterations; i++) {
+    for (const eSPIFFS::BatchEntry& entry : entries) fileSystem.saveFile(entry.name.c_str(), entry.data.c_str());
+  }
+  report("save", "file", "single", 10, iterations * _numFiles);
+  startMeasure();
+  for (int i = 0; i < iterations; i++) fileSystem.saveFiles(entries);
+  report("save", "file", "batch", 10, iterations * _numFiles);
+  for (const eSPIFFS::BatchEntry& entry : entries) fileSystem.removeFile(entry.name.c_str());
+}
+
+static void benchmarkKeyValue() {
+  eSPIFFSKV store;
+  int       value = 7;
+  MEASURE(store.saveToFile("counter", (value = i)), "save", "int", "kv", sizeof(int));
+  MEASURE(store.openFromFile("counter", value), "open", "int", "kv", sizeof(int));
+  fileSystem.removeFile("/store.kv");
+}
+
+template <class Store>
+static void benchmarkKeys(Store& _store, const char* _layout, int _numKeys, const char* _format) {
+  // Creates every key, saves a new value to each and opens each, per key
+  char name[24];
+  char mode[32];
+  int  value = 0;
+  snprintf(mode, sizeof(mode), "%s %d keys", _layout, _numKeys);
+  startMeasure();
+  for (int k = 0; k < _numKeys; k++) {
+    snprintf(name, sizeof(name), _format, k);
+    _store.saveToFile(name, (value = k));
+  }
+  report("create", "int", mode, sizeof(int), _numKeys);
+  startMeasure();
+  for (int k = 0; k < _numKeys; k++) {
+    snprintf(name, sizeof(name), _format, k);
+    _store.saveToFile(name, (value = k + _numKeys));
+  }
+  report("save", "int", mode, sizeof(int), _numKeys);
+  startMeasure();
+  for (int k = 0; k < _numKeys; k++) {
+    snprintf(name, sizeof(name), _format, k);
+    _store.openFromFile(name, value);
+  }
+  report("open", "int", mode, sizeof(int), _numKeys);
+}
+
+static void benchmarkKeyLayouts() {
+  // The same settings as one file per key and as keys in one store, at sizes from a few settings to a large table
+  char name[24];
+  for (int numKeys : {10, 100, 1000}) {
+    benchmarkKeys(fileSystem, "file per key", numKeys, "/key%d");
+    for (int k = 0; k < numKeys; k++) {
+      snprintf(name, sizeof(name), "/key%d", k);
+      fileSystem.removeFile(name);
+    }
+    eSPIFFSKV store("/bench.kv");
+    benchmarkKeys(store, "kv", numKeys, "key%d");
+    fileSystem.removeFile("/bench.kv");
+  }
+}
+
+static void benchmarkPartialUpdate() {
+  // Changing one 4 byte field in the middle of a raw record, by saving the whole record again or by updating the field in place
+  uint32_t field = 0;
+  for (size_t size : {256, 1024, 4096}) {
+    std::vector<uint8_t> record(size, 0x55);
+    size_t               offset = size / 2;
+    auto                 rewrite = [&](uint32_t _value) {
+      memcpy(&record[offset], &(field = _value), sizeof(field));
+      return fileSystem.saveFile(BENCHMARK_FILE, record.data(), record.size());
+    };
+    rewrite(0);
+    fileSystem.setAtomicSaves(false);
+    MEASURE(rewrite(i), "save", "raw", "full rewrite", size);
+    fileSystem.setAtomicSaves(true);
+    MEASURE(rewrite(i), "save", "raw", "atomic rewrite", size);
+    fileSystem.setAtomicSaves(false);
+    MEASURE(fileSystem.updateField(BENCHMARK_FILE, offset, (field = i)), "update", "raw", "field", size);
+    MEASURE(fileSystem.readField(BENCHMARK_FILE, offset, field), "open", "raw", "field", size);
+    fileSystem.removeFile(BENCHMARK_FILE);
+  }
+}
+
+struct Sample {
+  uint32_t time;
+  float    value;
+};
+
+static void benchmarkRingLog() {
+  eSPIFFSRingLog<Sample> log(fileSystem, "/bench.log", 256);
+  log.begin();
+  Sample sample = {0, 1.5f};
+  MEASURE(log.append((sample.time = i, sample)), "append", "record", "ringlog", sizeof(Sample));
+  log.end();
+  fileSystem.removeFile("/bench.log");
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) iterations = atoi(argv[1]) > 0 ? atoi(argv[1]) : 1;
+  spiffsFlash()->format();
+  fileSystem.mount();
+  replacingFileSystem.mount();
+  printf("op,type,encoding,mode,value bytes,iterations,ops per sec,flash bytes per op,erases per op,opens per op,bytes written per op,cpu ns per op,peak heap bytes\n");
+  benchmarkValues();
+#if defined ARDUINOJSON_VERSION_MAJOR && ARDUINOJSON_VERSION_MAJOR == 6
+  benchmarkJson();
+#endif
+  benchmarkNumbers();
+  benchmarkCompression();
+  benchmarkContention();
+  benchmarkCache();
+  benchmarkBatch(8);
+  benchmarkKeyValue();
+  benchmarkKeyLayouts();
+  benchmarkPartialUpdate();
+  benchmarkRingLog();
+  return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Minimal test runner for the host tests, each test file is one executable registered with ctest
+#include <Arduino.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace HostTest {
+
+  struct Case {
+    const char* name;
+    void (*run)();
+  };
+  inline std::vector<Case>& cases() {
+    static std::vector<Case> registered;
+    return registered;
+  }
+  inline int& failures() {
+    static int count = 0;
+    return count;
+  }
+  struct Registrar {
+    Registrar(const char* _name, void (*_run)()) {
+      cases().push_back({_name, _run});
+    }
+  };
+
+}  // namespace HostTest
+
+#define TEST(name)                                       \
+  static void                name();                     \
+  static HostTest::Registrar name##Registrar(#name, name); \
+  static void                name()
+
+#define CHECK(condition)                                                    \
+  do {                                                                      \
+    if (!(condition)) {                                                     \
+      printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      HostTest::failures()++;                                               \
+    }                                                                       \
+  } while (0)
+
+#define CHECK_EQUAL(expected, actual)                                                            \
+  do {                                                                                           \
+    if (!((expected) == (actual))) {                                                             \
+      printf("  %s:%d: CHECK_EQUAL(%s, %s) failed\n", __FILE__, __LINE__, #expected, #actual); \
+      HostTest::failures()++;                                                                    \
+    }                                                                                            \
+  } while (0)
+
+int main() {
+  for (const HostTest::Case& test : HostTest::cases()) {
+    int before = HostTest::failures();
+    test.run();
+    printf("%s %s\n", HostTest::failures() == before ? "PASS" : "FAIL", test.name);
+  }
+  return HostTest::failures() ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// Host stand-in for the parts of the ESP32 Arduino core the library uses, tests include it first as a sketch would
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "Print.h"
+#include "Stream.h"
+#include "WString.h"
+#include "freertos/FreeRTOS.h"
+
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+
+inline unsigned long micros() {
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+inline unsigned long millis() {
+  return micros() / 1000;
+}
+inline void delay(unsigned long _ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(_ms));
+}
+inline void yield() {
+  std::this_thread::yield();
+}
+
+class EspClass {
+ public:
+  uint32_t getFlashChipSize() {
+    return 4 * 1024 * 1024;
+  }
+  uint32_t getFreeHeap() {
+    return 256 * 1024;
+  }
+};
+static EspClass ESP __attribute__((unused));
+
+class HardwareSerial : public Stream {
+ public:
+  using Print::write;
+  void begin(unsigned long) {}
+  size_t write(uint8_t _byte) override {
+    return fwrite(&_byte, 1, 1, stdout);
+  }
+  size_t write(const uint8_t* _buffer, size_t _size) override {
+    return fwrite(_buffer, 1, _size, stdout);
+  }
+  int available() override {
+    return 0;
+  }
+  int read() override {
+    return -1;
+  }
+  int peek() override {
+    return -1;
+  }
+};
+static HardwareSerial Serial __attribute__((unused));
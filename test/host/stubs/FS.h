@@ -0,0 +1,192 @@
+#pragma once
+
+// Host stand-in for the ESP32 core FS.h, File and FS forward to a FileImpl and FSImpl as they do on the device
+#include <ctime>
+#include <memory>
+
+#include "Arduino.h"
+
+namespace fs {
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+  class File;
+
+  class FileImpl;
+  typedef std::shared_ptr<FileImpl> FileImplPtr;
+  class FSImpl;
+  typedef std::shared_ptr<FSImpl> FSImplPtr;
+
+  enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+  };
+
+  class File : public Stream {
+   public:
+    File(FileImplPtr _p = FileImplPtr()) : p(_p) {}
+
+    using Print::write;
+    size_t write(uint8_t _byte) override;
+    size_t write(const uint8_t* _buffer, size_t _size) override;
+    int    available() override;
+    int    read() override;
+    int    peek() override;
+    void   flush() override;
+    size_t read(uint8_t* _buffer, size_t _size);
+    size_t readBytes(char* _buffer, size_t _length) override {
+      return read((uint8_t*)_buffer, _length);
+    }
+
+    bool seek(uint32_t _pos, SeekMode _mode);
+    bool seek(uint32_t _pos) {
+      return seek(_pos, SeekSet);
+    }
+    size_t position() const;
+    size_t size() const;
+    bool   setBufferSize(size_t _size);
+    void   close();
+    operator bool() const;
+    time_t      getLastWrite();
+    const char* path() const;
+    const char* name() const;
+
+    bool isDirectory();
+    File openNextFile(const char* _mode = FILE_READ);
+    void rewindDirectory();
+
+   protected:
+    FileImplPtr p;
+  };
+
+  class FS {
+   public:
+    FS(FSImplPtr _impl) : impl(_impl) {}
+
+    File open(const char* _path, const char* _mode = FILE_READ, const bool _create = false);
+    File open(const String& _path, const char* _mode = FILE_READ, const bool _create = false) {
+      return open(_path.c_str(), _mode, _create);
+    }
+    bool exists(const char* _path);
+    bool exists(const String& _path) {
+      return exists(_path.c_str());
+    }
+    bool remove(const char* _path);
+    bool remove(const String& _path) {
+      return remove(_path.c_str());
+    }
+    bool rename(const char* _pathFrom, const char* _pathTo);
+    bool rename(const String& _pathFrom, const String& _pathTo) {
+      return rename(_pathFrom.c_str(), _pathTo.c_str());
+    }
+    bool mkdir(const char* _path);
+    bool rmdir(const char* _path);
+
+   protected:
+    FSImplPtr impl;
+  };
+
+}  // namespace fs
+
+#include "FSImpl.h"
+
+namespace fs {
+
+  inline size_t File::write(uint8_t _byte) {
+    return write(&_byte, 1);
+  }
+  inline size_t File::write(const uint8_t* _buffer, size_t _size) {
+    return p ? p->write(_buffer, _size) : 0;
+  }
+  inline int File::available() {
+    return p ? (int)(p->size() - p->position()) : 0;
+  }
+  inline int File::read() {
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+  }
+  inline int File::peek() {
+    if (!p) return -1;
+    size_t  position = p->position();
+    uint8_t byte;
+    if (p->read(&byte, 1) != 1) return -1;
+    p->seek(position, SeekSet);
+    return byte;
+  }
+  inline void File::flush() {
+    if (p) p->flush();
+  }
+  inline size_t File::read(uint8_t* _buffer, size_t _size) {
+    return p ? p->read(_buffer, _size) : 0;
+  }
+  inline bool File::seek(uint32_t _pos, SeekMode _mode) {
+    return p && p->seek(_pos, _mode);
+  }
+  inline size_t File::position() const {
+    return p ? p->position() : 0;
+  }
+  inline size_t File::size() const {
+    return p ? p->size() : 0;
+  }
+  inline bool File::setBufferSize(size_t _size) {
+    return p && p->setBufferSize(_size);
+  }
+  inline void File::close() {
+    if (p) {
+      p->close();
+      p = nullptr;
+    }
+  }
+  inline File::operator bool() const {
+    return p != nullptr && *p;
+  }
+  inline time_t File::getLastWrite() {
+    return p ? p->getLastWrite() : 0;
+  }
+  inline const char* File::path() const {
+    return p ? p->path() : nullptr;
+  }
+  inline const char* File::name() const {
+    return p ? p->name() : nullptr;
+  }
+  inline bool File::isDirectory() {
+    return p && p->isDirectory();
+  }
+  inline File File::openNextFile(const char* _mode) {
+    return p ? File(p->openNextFile(_mode)) : File();
+  }
+  inline void File::rewindDirectory() {
+    if (p) p->rewindDirectory();
+  }
+
+  inline File FS::open(const char* _path, const char* _mode, const bool _create) {
+    if (!impl || !_path || _path[0] != '/') return File();
+    return File(impl->open(_path, _mode, _create));
+  }
+  inline bool FS::exists(const char* _path) {
+    return impl && impl->exists(_path);
+  }
+  inline bool FS::remove(const char* _path) {
+    return impl && impl->remove(_path);
+  }
+  inline bool FS::rename(const char* _pathFrom, const char* _pathTo) {
+    return impl && impl->rename(_pathFrom, _pathTo);
+  }
+  inline bool FS::mkdir(const char* _path) {
+    return impl && impl->mkdir(_path);
+  }
+  inline bool FS::rmdir(const char* _path) {
+    return impl && impl->rmdir(_path);
+  }
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
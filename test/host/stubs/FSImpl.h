@@ -0,0 +1,51 @@
+#pragma once
+
+// Host stand-in for the ESP32 core FSImpl.h, the interfaces a file system implements
+#include <ctime>
+#include <memory>
+
+#include "FS.h"
+
+namespace fs {
+
+  class FileImpl {
+   public:
+    virtual ~FileImpl() {}
+    virtual size_t      write(const uint8_t* _buffer, size_t _size) = 0;
+    virtual size_t      read(uint8_t* _buffer, size_t _size) = 0;
+    virtual void        flush() = 0;
+    virtual bool        seek(uint32_t _pos, SeekMode _mode) = 0;
+    virtual size_t      position() const = 0;
+    virtual size_t      size() const = 0;
+    virtual bool        setBufferSize(size_t _size) = 0;
+    virtual void        close() = 0;
+    virtual time_t      getLastWrite() = 0;
+    virtual const char* path() const = 0;
+    virtual const char* name() const = 0;
+    virtual bool        isDirectory() = 0;
+    virtual FileImplPtr openNextFile(const char* _mode) = 0;
+    virtual void        rewindDirectory() = 0;
+    virtual operator bool() = 0;
+  };
+
+  class FSImpl {
+   protected:
+    const char* _mountpoint = nullptr;
+
+   public:
+    virtual ~FSImpl() {}
+    virtual FileImplPtr open(const char* _path, const char* _mode, const bool _create) = 0;
+    virtual bool        exists(const char* _path) = 0;
+    virtual bool        rename(const char* _pathFrom, const char* _pathTo) = 0;
+    virtual bool        remove(const char* _path) = 0;
+    virtual bool        mkdir(const char* _path) = 0;
+    virtual bool        rmdir(const char* _path) = 0;
+    void                mountpoint(const char* _path) {
+      _mountpoint = _path;
+    }
+    const char* mountpoint() {
+      return _mountpoint;
+    }
+  };
+
+}  // namespace fs
@@ -0,0 +1,398 @@
+#pragma once
+
+// RAM image standing in for the flash file system, counts every call the library makes so tests can check them
+// and models page programs, block erases and flash time for the host benchmark
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FSImpl.h"
+
+struct FlashCounters {
+  unsigned long begins = 0;
+  unsigned long ends = 0;
+  unsigned long exists = 0;
+  unsigned long opens = 0;
+  unsigned long removes = 0;
+  unsigned long renames = 0;
+  unsigned long reads = 0;
+  unsigned long writes = 0;
+  unsigned long bytesRead = 0;
+  unsigned long bytesWritten = 0;
+  unsigned long programmedBytes = 0;  // Whole pages programmed, including file metadata
+  unsigned long erases = 0;           // Blocks erased to make room for the programmed pages
+  unsigned long micros = 0;           // Simulated flash time
+};
+
+// NOR flash as seen by SPIFFS on the ESP32, defaults are typical datasheet times
+struct FlashGeometry {
+  size_t        pageSize = 256;            // Programmed as a whole, a write programs every page it touches
+  size_t        blockSize = 4096;          // Erased as a whole once its pages have all been used
+  unsigned long pageProgramMicros = 700;   // Per page programmed
+  unsigned long pageReadMicros = 20;       // Per page read
+  unsigned long blockEraseMicros = 45000;  // Per block erased
+  unsigned long lookupMicros = 100;        // Per exists, open, rename and remove, finding the file's metadata
+};
+
+class FlashEmulator : public fs::FSImpl, public std::enable_shared_from_this<FlashEmulator> {
+ public:  // test controls
+  FlashCounters counters() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return calls;
+  }
+  void resetCounters() {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls = FlashCounters();
+    unerased = 0;
+  }
+  void setGeometry(const FlashGeometry& _geometry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    geometry = _geometry;
+  }
+  void format() {
+    // Wipe every file, open handles keep their own copy
+    std::lock_guard<std::mutex> lock(mutex);
+    files.clear();
+  }
+  bool isMounted() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mounted;
+  }
+  std::string contents(const std::string& _path) {
+    // Bytes of a file without counting a read
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        found = files.find(_path);
+    return found == files.end() ? std::string() : std::string(found->second->data.begin(), found->second->data.end());
+  }
+  void setContents(const std::string& _path, const std::string& _data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<Node>       node = std::make_shared<Node>();
+    node->data.assign(_data.begin(), _data.end());
+    node->lastWrite = time(nullptr);
+    files[_path] = node;
+  }
+  void cutPowerAfter(long _operations) {
+    // Let this many writes, creates, renames and removes through, then lose power part way through a write
+    std::lock_guard<std::mutex> lock(mutex);
+    powerBudget = _operations;
+    powerOff = false;
+  }
+  void restorePower() {
+    std::lock_guard<std::mutex> lock(mutex);
+    powerBudget = -1;
+    powerOff = false;
+  }
+  bool powerLost() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return powerOff;
+  }
+  void setRenameReplaces(bool _replaces) {
+    // LittleFS on the ESP8266 renames over an existing file, SPIFFS on the ESP32 refuses
+    std::lock_guard<std::mutex> lock(mutex);
+    renameReplaces = _replaces;
+  }
+  void setYieldOnAccess(bool _yield) {
+    // Let other threads run before every open, read and write so concurrent tests interleave even on one core
+    yielding = _yield;
+  }
+  std::vector<std::string> list() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string>    names;
+    for (auto& file : files) names.push_back(file.first);
+    return names;
+  }
+
+ public:  // SPIFFSFS
+  bool begin() {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.begins++;
+    mounted = true;
+    return true;
+  }
+  void end() {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.ends++;
+    mounted = false;
+  }
+  size_t totalBytes() {
+    return capacity;
+  }
+  size_t usedBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t                      used = 0;
+    for (auto& file : files) used += file.second->data.size();
+    return used;
+  }
+
+ public:  // fs::FSImpl
+  fs::FileImplPtr open(const char* _path, const char* _mode, const bool) override {
+    pause();
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.opens++;
+    lookup();
+    if (!mounted) return fs::FileImplPtr();
+    std::string path(_path);
+    if (isDirectory(path)) return std::make_shared<DirImpl>(shared_from_this(), path, listLocked(path));
+
+    bool reading = _mode[0] == 'r';
+    bool plus = strchr(_mode, '+') != nullptr;
+    auto found = files.find(path);
+    if (found == files.end()) {
+      if (reading || !powered()) return fs::FileImplPtr();
+      found = files.insert(std::make_pair(path, std::make_shared<Node>())).first;
+      found->second->lastWrite = time(nullptr);
+      program(1);
+    } else if (_mode[0] == 'w') {
+      if (!powered()) return fs::FileImplPtr();
+      found->second->data.clear();
+      program(1);
+      found->second->lastWrite = time(nullptr);
+    }
+    return std::make_shared<FileImpl>(shared_from_this(), path, found->second, reading || plus, !reading || plus, _mode[0] == 'a');
+  }
+  bool exists(const char* _path) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.exists++;
+    lookup();
+    return mounted && (files.count(_path) || isDirectory(_path));
+  }
+  bool rename(const char* _pathFrom, const char* _pathTo) override {
+    // Like SPIFFS on the ESP32 the target must not exist
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.renames++;
+    lookup();
+    auto found = files.find(_pathFrom);
+    if (!mounted || found == files.end() || (files.count(_pathTo) && !renameReplaces) || !powered()) return false;
+    program(1);
+    files[_pathTo] = found->second;
+    files.erase(found);
+    return true;
+  }
+  bool remove(const char* _path) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.removes++;
+    lookup();
+    if (!mounted || !files.count(_path) || !powered()) return false;
+    program(1);
+    return files.erase(_path) > 0;
+  }
+  bool mkdir(const char*) override {
+    return false;
+  }
+  bool rmdir(const char*) override {
+    return false;
+  }
+
+ private:  // files
+  struct Node {
+    std::vector<uint8_t> data;
+    time_t               lastWrite = 0;
+  };
+  class FileImpl : public fs::FileImpl {
+   public:
+    FileImpl(std::shared_ptr<FlashEmulator> _flash, const std::string& _path, std::shared_ptr<Node> _node, bool _readable, bool _writable, bool _append)
+        : flash(_flash), filePath(_path), node(_node), readable(_readable), writable(_writable), append(_append) {}
+    size_t write(const uint8_t* _buffer, size_t _size) override {
+      flash->pause();
+      std::lock_guard<std::mutex> lock(flash->mutex);
+      if (!node || !writable || !flash->mounted) return 0;
+      bool wasOff = flash->powerOff;
+      if (!flash->powered()) {
+        // The write that loses power only gets half way
+        if (wasOff) return 0;
+        _size /= 2;
+      }
+      if (append) offset = node->data.size();
+      if (_size) flash->program((offset + _size - 1) / flash->geometry.pageSize - offset / flash->geometry.pageSize + 1);
+      if (node->data.size() < offset + _size) node->data.resize(offset + _size);
+      std::copy(_buffer, _buffer + _size, node->data.begin() + offset);
+      offset += _size;
+      node->lastWrite = time(nullptr);
+      flash->calls.writes++;
+      flash->calls.bytesWritten += _size;
+      return _size;
+    }
+    size_t read(uint8_t* _buffer, size_t _size) override {
+      flash->pause();
+      std::lock_guard<std::mutex> lock(flash->mutex);
+      if (!node || !readable || !flash->mounted || offset >= node->data.size()) return 0;
+      size_t count = std::min(_size, node->data.size() - offset);
+      flash->calls.micros += ((offset + count - 1) / flash->geometry.pageSize - offset / flash->geometry.pageSize + 1) * flash->geometry.pageReadMicros;
+      std::copy(node->data.begin() + offset, node->data.begin() + offset + count, _buffer);
+      offset += count;
+      flash->calls.reads++;
+      flash->calls.bytesRead += count;
+      return count;
+    }
+    void flush() override {}
+    bool seek(uint32_t _pos, fs::SeekMode _mode) override {
+      std::lock_guard<std::mutex> lock(flash->mutex);
+      if (!node) return false;
+      size_t base = _mode == fs::SeekSet ? 0 : _mode == fs::SeekCur ? offset : node->data.size();
+      if (base + _pos > node->data.size()) return false;
+      offset = base + _pos;
+      return true;
+    }
+    size_t position() const override {
+      return offset;
+    }
+    size_t size() const override {
+      std::lock_guard<std::mutex> lock(flash->mutex);
+      return node ? node->data.size() : 0;
+    }
+    bool setBufferSize(size_t) override {
+      return true;
+    }
+    void close() override {
+      node = nullptr;
+    }
+    time_t getLastWrite() override {
+      std::lock_guard<std::mutex> lock(flash->mutex);
+      return node ? node->lastWrite : 0;
+    }
+    const char* path() const override {
+      return filePath.c_str();
+    }
+    const char* name() const override {
+      return filePath.c_str() + filePath.rfind('/') + 1;
+    }
+    bool isDirectory() override {
+      return false;
+    }
+    fs::FileImplPtr openNextFile(const char*) override {
+      return fs::FileImplPtr();
+    }
+    void rewindDirectory() override {}
+    operator bool() override {
+      return node != nullptr;
+    }
+
+   private:
+    std::shared_ptr<FlashEmulator> flash;
+    std::string                    filePath;
+    std::shared_ptr<Node>          node;
+    bool                           readable;
+    bool                           writable;
+    bool                           append;
+    size_t                         offset = 0;
+  };
+  class DirImpl : public fs::FileImpl {
+   public:
+    DirImpl(std::shared_ptr<FlashEmulator> _flash, const std::string& _path, const std::vector<std::string>& _entries)
+        : flash(_flash), dirPath(_path), entries(_entries) {}
+    size_t write(const uint8_t*, size_t) override {
+      return 0;
+    }
+    size_t read(uint8_t*, size_t) override {
+      return 0;
+    }
+    void flush() override {}
+    bool seek(uint32_t, fs::SeekMode) override {
+      return false;
+    }
+    size_t position() const override {
+      return 0;
+    }
+    size_t size() const override {
+      return 0;
+    }
+    bool setBufferSize(size_t) override {
+      return false;
+    }
+    void close() override {
+      open = false;
+    }
+    time_t getLastWrite() override {
+      return 0;
+    }
+    const char* path() const override {
+      return dirPath.c_str();
+    }
+    const char* name() const override {
+      return dirPath.c_str() + dirPath.rfind('/') + 1;
+    }
+    bool isDirectory() override {
+      return true;
+    }
+    fs::FileImplPtr openNextFile(const char* _mode) override {
+      // Entries removed since the directory was opened are skipped
+      while (open && next < entries.size()) {
+        fs::FileImplPtr file = flash->open(entries[next++].c_str(), _mode, false);
+        if (file) return file;
+      }
+      return fs::FileImplPtr();
+    }
+    void rewindDirectory() override {
+      next = 0;
+    }
+    operator bool() override {
+      return open;
+    }
+
+   private:
+    std::shared_ptr<FlashEmulator> flash;
+    std::string                    dirPath;
+    std::vector<std::string>       entries;
+    size_t                         next = 0;
+    bool                           open = true;
+  };
+
+  bool powered() {
+    // Spend one operation of the power budget, false once it has run out
+    if (powerBudget < 0) return true;
+    if (powerBudget > 0) {
+      powerBudget--;
+      return true;
+    }
+    powerOff = true;
+    return false;
+  }
+  void pause() {
+    if (yielding) std::this_thread::yield();
+  }
+  void lookup() {
+    calls.micros += geometry.lookupMicros;
+  }
+  void program(size_t _pages) {
+    // Pages go to erased space, every block's worth of programmed pages costs one erase to reclaim
+    calls.programmedBytes += _pages * geometry.pageSize;
+    calls.micros += _pages * geometry.pageProgramMicros;
+    unerased += _pages * geometry.pageSize;
+    for (; unerased >= geometry.blockSize; unerased -= geometry.blockSize) {
+      calls.erases++;
+      calls.micros += geometry.blockEraseMicros;
+    }
+  }
+  bool isDirectory(const std::string& _path) {
+    if (_path == "/") return true;
+    std::string prefix = _path + "/";
+    auto        found = files.lower_bound(prefix);
+    return found != files.end() && found->first.compare(0, prefix.size(), prefix) == 0;
+  }
+  std::vector<std::string> listLocked(const std::string& _path) {
+    std::string              prefix = _path == "/" ? _path : _path + "/";
+    std::vector<std::string> names;
+    for (auto& file : files) {
+      if (file.first.compare(0, prefix.size(), prefix) == 0) names.push_back(file.first);
+    }
+    return names;
+  }
+
+ private:  // storage
+  std::mutex                                    mutex;
+  std::map<std::string, std::shared_ptr<Node>> files;
+  FlashCounters                                 calls;
+  FlashGeometry                                 geometry;
+  size_t                                        unerased = 0;
+  bool                                          mounted = false;
+  bool                                          renameReplaces = false;
+  long                                          powerBudget = -1;
+  bool                                          powerOff = false;
+  size_t                                        capacity = 1024 * 1024;
+  std::atomic<bool>                             yielding{false};
+};
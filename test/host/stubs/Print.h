@@ -0,0 +1,69 @@
+#pragma once
+
+// Host stand-in for the Arduino Print class
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "WString.h"
+
+class Print {
+ public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t _byte) = 0;
+  virtual size_t write(const uint8_t* _buffer, size_t _size) {
+    size_t written = 0;
+    while (written < _size && write(_buffer[written])) written++;
+    return written;
+  }
+  size_t write(const char* _buffer, size_t _size) {
+    return write((const uint8_t*)_buffer, _size);
+  }
+  virtual void flush() {}
+
+  size_t printf(const char* _format, ...) __attribute__((format(printf, 2, 3))) {
+    char    text[256];
+    va_list args;
+    va_start(args, _format);
+    int length = vsnprintf(text, sizeof(text), _format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write((const uint8_t*)text, (size_t)length < sizeof(text) ? length : sizeof(text) - 1);
+  }
+
+  size_t print(const char* _text) {
+    return write((const uint8_t*)_text, strlen(_text));
+  }
+  size_t print(const String& _text) {
+    return print(_text.c_str());
+  }
+  size_t print(char _c) {
+    return write((uint8_t)_c);
+  }
+  size_t print(int _value) {
+    return printf("%d", _value);
+  }
+  size_t print(unsigned int _value) {
+    return printf("%u", _value);
+  }
+  size_t print(long _value) {
+    return printf("%ld", _value);
+  }
+  size_t print(unsigned long _value) {
+    return printf("%lu", _value);
+  }
+  size_t print(double _value, int _digits = 2) {
+    return printf("%.*f", _digits, _value);
+  }
+
+  size_t println() {
+    return print("\r\n");
+  }
+  template <class T>
+  size_t println(const T& _value) {
+    size_t written = print(_value);
+    return written + println();
+  }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// Host stand-in for the ESP32 core SPIFFS.h, backed by the flash emulator
+#include "FS.h"
+#include "FlashEmulator.h"
+
+inline std::shared_ptr<FlashEmulator> spiffsFlash() {
+  static std::shared_ptr<FlashEmulator> flash = std::make_shared<FlashEmulator>();
+  return flash;
+}
+
+class SPIFFSFS : public fs::FS {
+ public:
+  SPIFFSFS() : fs::FS(spiffsFlash()) {}
+  bool begin(bool = false, const char* = "/spiffs", uint8_t = 10, const char* = nullptr) {
+    return spiffsFlash()->begin();
+  }
+  bool format() {
+    spiffsFlash()->format();
+    return true;
+  }
+  size_t totalBytes() {
+    return spiffsFlash()->totalBytes();
+  }
+  size_t usedBytes() {
+    return spiffsFlash()->usedBytes();
+  }
+  void end() {
+    spiffsFlash()->end();
+  }
+};
+
+static SPIFFSFS SPIFFS;
@@ -0,0 +1,30 @@
+#pragma once
+
+// Host stand-in for the Arduino Stream class
+#include "Print.h"
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long _timeout) {
+    timeout = _timeout;
+  }
+  virtual size_t readBytes(char* _buffer, size_t _length) {
+    size_t count = 0;
+    while (count < _length) {
+      int c = read();
+      if (c < 0) break;
+      _buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t* _buffer, size_t _length) {
+    return readBytes((char*)_buffer, _length);
+  }
+
+ protected:
+  unsigned long timeout = 1000;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+// Host stand-in for the Arduino String, only the members the library and tests use
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+class String {
+ public:
+  String(const char* _cstr = "") : buffer(_cstr ? _cstr : "") {}
+  String(const String& _other) = default;
+  String(String&& _other) = default;
+  explicit String(char _c) : buffer(1, _c) {}
+  explicit String(int _value) : buffer(std::to_string(_value)) {}
+  explicit String(unsigned int _value) : buffer(std::to_string(_value)) {}
+  explicit String(long _value) : buffer(std::to_string(_value)) {}
+  explicit String(unsigned long _value) : buffer(std::to_string(_value)) {}
+  explicit String(double _value, unsigned int _decimals = 2) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)_decimals, _value);
+    buffer = text;
+  }
+
+  String& operator=(const String& _other) = default;
+  String& operator=(String&& _other) = default;
+  String& operator=(const char* _cstr) {
+    buffer = _cstr ? _cstr : "";
+    return *this;
+  }
+
+  bool reserve(unsigned int _size) {
+    buffer.reserve(_size);
+    return true;
+  }
+  unsigned int length() const {
+    return buffer.size();
+  }
+  const char* c_str() const {
+    return buffer.c_str();
+  }
+
+  bool concat(const String& _other) {
+    buffer += _other.buffer;
+    return true;
+  }
+  bool concat(const char* _cstr) {
+    if (_cstr) buffer += _cstr;
+    return _cstr != nullptr;
+  }
+  bool concat(const char* _cstr, unsigned int _length) {
+    if (_cstr) buffer.append(_cstr, _length);
+    return _cstr != nullptr;
+  }
+  bool concat(char _c) {
+    buffer += _c;
+    return true;
+  }
+  String& operator+=(const String& _other) {
+    concat(_other);
+    return *this;
+  }
+  String& operator+=(const char* _cstr) {
+    concat(_cstr);
+    return *this;
+  }
+  String& operator+=(char _c) {
+    concat(_c);
+    return *this;
+  }
+
+  char operator[](unsigned int _index) const {
+    return _index < buffer.size() ? buffer[_index] : 0;
+  }
+  char& operator[](unsigned int _index) {
+    return buffer[_index];
+  }
+  bool operator==(const String& _other) const {
+    return buffer == _other.buffer;
+  }
+  bool operator==(const char* _cstr) const {
+    return buffer == (_cstr ? _cstr : "");
+  }
+  bool operator!=(const String& _other) const {
+    return !(*this == _other);
+  }
+  bool operator!=(const char* _cstr) const {
+    return !(*this == _cstr);
+  }
+
+  long toInt() const {
+    return strtol(buffer.c_str(), nullptr, 10);
+  }
+  float toFloat() const {
+    return strtof(buffer.c_str(), nullptr);
+  }
+  double toDouble() const {
+    return strtod(buffer.c_str(), nullptr);
+  }
+
+  friend String operator+(const String& _left, const String& _right) {
+    String sum(_left);
+    sum += _right;
+    return sum;
+  }
+  friend String operator+(const String& _left, const char* _right) {
+    String sum(_left);
+    sum += _right;
+    return sum;
+  }
+  friend String operator+(const char* _left, const String& _right) {
+    String sum(_left);
+    sum += _right;
+    return sum;
+  }
+
+ private:
+  std::string buffer;
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+// Host stand-in for the IDF version header, the Arduino ESP32 core 2.x is built on IDF 4.4
+#define ESP_IDF_VERSION_MAJOR 4
+#define ESP_IDF_VERSION_MINOR 4
+#define ESP_IDF_VERSION_PATCH 0
@@ -0,0 +1,82 @@
+#pragma once
+
+// Host stand-in for the IDF 4 partition API, tests register partitions backed by RAM with hostAddPartition
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xff } esp_partition_subtype_t;
+typedef enum { SPI_FLASH_MMAP_DATA, SPI_FLASH_MMAP_INST } spi_flash_mmap_memory_t;
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  uint8_t              subtype;
+  uint32_t             address;
+  uint32_t             size;
+  char                 label[17];
+  bool                 encrypted;
+} esp_partition_t;
+
+struct HostPartition {
+  esp_partition_t partition;
+  std::string     data;
+};
+inline std::map<std::string, std::shared_ptr<HostPartition>>& hostPartitions() {
+  static std::map<std::string, std::shared_ptr<HostPartition>> partitions;
+  return partitions;
+}
+inline std::map<spi_flash_mmap_handle_t, std::string>& hostMappings() {
+  // Live mappings, tests check every one is unmapped
+  static std::map<spi_flash_mmap_handle_t, std::string> mappings;
+  return mappings;
+}
+inline void hostAddPartition(const char* _label, const std::string& _data, size_t _size) {
+  std::shared_ptr<HostPartition> entry = std::make_shared<HostPartition>();
+  entry->partition.type = ESP_PARTITION_TYPE_DATA;
+  entry->partition.subtype = 0x82;
+  entry->partition.size = _size;
+  entry->partition.encrypted = false;
+  strncpy(entry->partition.label, _label, sizeof(entry->partition.label) - 1);
+  entry->data = _data;
+  entry->data.resize(_size, '\xff');
+  hostPartitions()[_label] = entry;
+}
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t _type, esp_partition_subtype_t, const char* _label) {
+  auto found = hostPartitions().find(_label ? _label : "");
+  return found != hostPartitions().end() && found->second->partition.type == _type ? &found->second->partition : nullptr;
+}
+inline HostPartition* hostPartition(const esp_partition_t* _partition) {
+  for (auto& entry : hostPartitions()) {
+    if (&entry.second->partition == _partition) return entry.second.get();
+  }
+  return nullptr;
+}
+inline esp_err_t esp_partition_read(const esp_partition_t* _partition, size_t _offset, void* _output, size_t _size) {
+  HostPartition* partition = hostPartition(_partition);
+  if (!partition || _offset + _size > partition->data.size()) return ESP_ERR_INVALID_ARG;
+  memcpy(_output, partition->data.data() + _offset, _size);
+  return ESP_OK;
+}
+inline esp_err_t esp_partition_mmap(const esp_partition_t* _partition, size_t _offset, size_t _size, spi_flash_mmap_memory_t, const void** _output,
+                                    spi_flash_mmap_handle_t* _handle) {
+  static spi_flash_mmap_handle_t nextHandle = 1;
+  HostPartition*                 partition = hostPartition(_partition);
+  if (!partition || _offset + _size > partition->data.size()) return ESP_ERR_INVALID_ARG;
+  *_handle = nextHandle++;
+  *_output = partition->data.data() + _offset;
+  hostMappings()[*_handle] = partition->partition.label;
+  return ESP_OK;
+}
+inline void spi_flash_munmap(spi_flash_mmap_handle_t _handle) {
+  hostMappings().erase(_handle);
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS calls the library makes, tasks are std::threads and semaphores use a mutex and condition variable
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t     TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY -1
+#define portMAX_DELAY 0xffffffffu
+
+// Semaphores
+struct HostSemaphore {
+  std::mutex              mutex;
+  std::condition_variable changed;
+  UBaseType_t             count = 0;
+  bool                    recursive = false;
+  std::thread::id         owner;
+  UBaseType_t             depth = 0;
+};
+typedef HostSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return new HostSemaphore();
+}
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  SemaphoreHandle_t semaphore = new HostSemaphore();
+  semaphore->count = 1;
+  return semaphore;
+}
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  SemaphoreHandle_t semaphore = xSemaphoreCreateMutex();
+  semaphore->recursive = true;
+  return semaphore;
+}
+inline void vSemaphoreDelete(SemaphoreHandle_t _semaphore) {
+  delete _semaphore;
+}
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t _semaphore, TickType_t) {
+  std::unique_lock<std::mutex> lock(_semaphore->mutex);
+  _semaphore->changed.wait(lock, [&] { return _semaphore->count > 0; });
+  _semaphore->count--;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t _semaphore) {
+  std::lock_guard<std::mutex> lock(_semaphore->mutex);
+  if (_semaphore->count > 0) return pdFALSE;
+  _semaphore->count = 1;
+  _semaphore->changed.notify_all();
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t _semaphore, TickType_t) {
+  std::unique_lock<std::mutex> lock(_semaphore->mutex);
+  std::thread::id              self = std::this_thread::get_id();
+  if (_semaphore->depth && _semaphore->owner == self) {
+    _semaphore->depth++;
+    return pdTRUE;
+  }
+  _semaphore->changed.wait(lock, [&] { return _semaphore->depth == 0; });
+  _semaphore->owner = self;
+  _semaphore->depth = 1;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t _semaphore) {
+  std::lock_guard<std::mutex> lock(_semaphore->mutex);
+  if (!_semaphore->depth || _semaphore->owner != std::this_thread::get_id()) return pdFALSE;
+  if (--_semaphore->depth == 0) _semaphore->changed.notify_all();
+  return pdTRUE;
+}
+
+// Tasks, each one a detached std::thread with a notification count
+struct HostTask {
+  std::mutex              mutex;
+  std::condition_variable notified;
+  uint32_t                notifications = 0;
+};
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  // Threads not started by xTaskCreate, such as main, get a handle on first use
+  static thread_local std::unique_ptr<HostTask> self(new HostTask());
+  return self.get();
+}
+inline bool& hostTaskCreateFails() {
+  // Set by tests to make xTaskCreate report that it ran out of memory
+  static bool fails = false;
+  return fails;
+}
+inline BaseType_t xTaskCreate(TaskFunction_t _function, const char*, uint32_t, void* _parameter, UBaseType_t, TaskHandle_t* _handle) {
+  if (hostTaskCreateFails()) return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+  std::mutex              started;
+  std::condition_variable ready;
+  TaskHandle_t            task = nullptr;
+  std::thread([&, _function, _parameter] {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    {
+      std::lock_guard<std::mutex> lock(started);
+      task = self;
+      ready.notify_all();
+    }
+    _function(_parameter);
+  }).detach();
+  std::unique_lock<std::mutex> lock(started);
+  ready.wait(lock, [&] { return task != nullptr; });
+  if (_handle) *_handle = task;
+  return pdPASS;
+}
+inline void vTaskDelete(TaskHandle_t) {
+  // The calling task returns from its function straight after, which ends the thread
+}
+inline void xTaskNotifyGive(TaskHandle_t _task) {
+  std::lock_guard<std::mutex> lock(_task->mutex);
+  _task->notifications++;
+  _task->notified.notify_all();
+}
+inline uint32_t ulTaskNotifyTake(BaseType_t _clearOnExit, TickType_t _ticks) {
+  TaskHandle_t                 self = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(self->mutex);
+  if (_ticks == portMAX_DELAY) {
+    self->notified.wait(lock, [&] { return self->notifications > 0; });
+  } else {
+    self->notified.wait_for(lock, std::chrono::milliseconds(_ticks), [&] { return self->notifications > 0; });
+  }
+  uint32_t count = self->notifications;
+  if (count) self->notifications = _clearOnExit ? 0 : count - 1;
+  return count;
+}
+inline void vTaskDelay(TickType_t _ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(_ticks));
+}
+
+// Critical sections
+struct portMUX_TYPE {
+  std::mutex mutex;
+};
+#define portMUX_INITIALIZER_UNLOCKED \
+  {}
+#define portENTER_CRITICAL(mux) (mux)->mutex.lock()
+#define portEXIT_CRITICAL(mux) (mux)->mutex.unlock()
@@ -0,0 +1,127 @@
+#pragma once
+
+// Host stand-in for the ESP32 core vfs_api.h, files under the mount point go straight to the host's C file API as the IDF VFS does
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+#include "FS.h"
+
+class VFSImpl;
+
+class VFSFileImpl : public fs::FileImpl {
+ public:
+  VFSFileImpl(VFSImpl* _fileSystem, const char* _path, const char* _mode);
+  ~VFSFileImpl() override {
+    close();
+  }
+  size_t write(const uint8_t* _buffer, size_t _size) override {
+    return file ? fwrite(_buffer, 1, _size, file) : 0;
+  }
+  size_t read(uint8_t* _buffer, size_t _size) override {
+    return file ? fread(_buffer, 1, _size, file) : 0;
+  }
+  void flush() override {
+    if (file) fflush(file);
+  }
+  bool seek(uint32_t _pos, fs::SeekMode _mode) override {
+    return file && fseek(file, _pos, _mode == fs::SeekSet ? SEEK_SET : _mode == fs::SeekCur ? SEEK_CUR : SEEK_END) == 0;
+  }
+  size_t position() const override {
+    return file ? ftell(file) : 0;
+  }
+  size_t size() const override {
+    struct stat info;
+    if (!file) return 0;
+    fflush(file);
+    return fstat(fileno(file), &info) == 0 ? info.st_size : 0;
+  }
+  bool setBufferSize(size_t _size) override {
+    return file && setvbuf(file, nullptr, _IOFBF, _size) == 0;
+  }
+  void close() override {
+    if (file) fclose(file);
+    if (dir) closedir(dir);
+    file = nullptr;
+    dir = nullptr;
+  }
+  time_t getLastWrite() override {
+    struct stat info;
+    return stat(fullPath.c_str(), &info) == 0 ? info.st_mtime : 0;
+  }
+  const char* path() const override {
+    return filePath.c_str();
+  }
+  const char* name() const override {
+    return filePath.c_str() + filePath.rfind('/') + 1;
+  }
+  bool isDirectory() override {
+    return dir != nullptr;
+  }
+  fs::FileImplPtr openNextFile(const char* _mode) override {
+    if (!dir) return fs::FileImplPtr();
+    for (struct dirent* entry; (entry = readdir(dir));) {
+      if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+      std::string child = (filePath == "/" ? "" : filePath) + "/" + entry->d_name;
+      return std::make_shared<VFSFileImpl>(fileSystem, child.c_str(), _mode);
+    }
+    return fs::FileImplPtr();
+  }
+  void rewindDirectory() override {
+    if (dir) rewinddir(dir);
+  }
+  operator bool() override {
+    return file || dir;
+  }
+
+ private:
+  VFSImpl*    fileSystem;
+  std::string filePath;
+  std::string fullPath;
+  FILE*       file = nullptr;
+  DIR*        dir = nullptr;
+};
+
+class VFSImpl : public fs::FSImpl {
+ public:
+  fs::FileImplPtr open(const char* _path, const char* _mode, const bool) override {
+    // Reading a missing file fails, any other mode creates it
+    if (!_mountpoint || !_path || _path[0] != '/') return fs::FileImplPtr();
+    struct stat info;
+    if (_mode[0] == 'r' && stat(fullPath(_path).c_str(), &info) != 0) return fs::FileImplPtr();
+    std::shared_ptr<VFSFileImpl> file = std::make_shared<VFSFileImpl>(this, _path, _mode);
+    return *file ? file : fs::FileImplPtr();
+  }
+  bool exists(const char* _path) override {
+    struct stat info;
+    return _mountpoint && stat(fullPath(_path).c_str(), &info) == 0;
+  }
+  bool rename(const char* _pathFrom, const char* _pathTo) override {
+    return _mountpoint && ::rename(fullPath(_pathFrom).c_str(), fullPath(_pathTo).c_str()) == 0;
+  }
+  bool remove(const char* _path) override {
+    return _mountpoint && unlink(fullPath(_path).c_str()) == 0;
+  }
+  bool mkdir(const char* _path) override {
+    return _mountpoint && ::mkdir(fullPath(_path).c_str(), 0755) == 0;
+  }
+  bool rmdir(const char* _path) override {
+    return _mountpoint && ::rmdir(fullPath(_path).c_str()) == 0;
+  }
+  std::string fullPath(const char* _path) {
+    return std::string(_mountpoint) + _path;
+  }
+};
+
+inline VFSFileImpl::VFSFileImpl(VFSImpl* _fileSystem, const char* _path, const char* _mode)
+    : fileSystem(_fileSystem), filePath(_path), fullPath(_fileSystem->fullPath(_path)) {
+  struct stat info;
+  if (stat(fullPath.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+    dir = opendir(fullPath.c_str());
+  } else {
+    file = fopen(fullPath.c_str(), _mode);
+  }
+}
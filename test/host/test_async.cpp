@@ -0,0 +1,99 @@
+// Queued saves are written by the worker task, each save gets its own request number and a failed worker falls back to writing directly
+#include "host_test.h"
+
+#include <Effortless_SPIFFS_Async.h>
+
+#include <set>
+#include <thread>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+  hostTaskCreateFails() = false;
+}
+
+TEST(queuedSaveIsWrittenByWorker) {
+  resetFlash();
+  eSPIFFSAsync fileSystem;
+  std::mutex   completedMutex;
+  uint32_t     completed = 0;
+  bool         succeeded = false;
+  fileSystem.onComplete([&](uint32_t _request, const char*, bool _success) {
+    std::lock_guard<std::mutex> lock(completedMutex);
+    completed = _request;
+    succeeded = _success;
+  });
+  int      value = 42;
+  uint32_t request = fileSystem.queueSave("/value", value);
+  CHECK(request != 0);
+  CHECK_EQUAL(request, fileSystem.lastRequest());
+  fileSystem.flushAndWait();
+  CHECK(!fileSystem.isPending(request));
+  CHECK_EQUAL(std::string("42"), spiffsFlash()->contents("/value"));
+
+  // The callback runs after the write, on the worker
+  for (int i = 0; i < 1000; i++) {
+    {
+      std::lock_guard<std::mutex> lock(completedMutex);
+      if (completed) break;
+    }
+    vTaskDelay(1);
+  }
+  std::lock_guard<std::mutex> lock(completedMutex);
+  CHECK_EQUAL(request, completed);
+  CHECK(succeeded);
+}
+
+TEST(readSeesQueuedSave) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "1");
+  eSPIFFSAsync fileSystem;
+  int          value = 2;
+  CHECK(fileSystem.saveToFile("/value", value));
+  int read = 0;
+  CHECK(fileSystem.openFromFile("/value", read));
+  CHECK_EQUAL(2, read);
+}
+
+TEST(requestNumbersBelongToTheirTask) {
+  // Tasks saving at the same time each get back the number of their own save
+  resetFlash();
+  eSPIFFSAsync             fileSystem;
+  std::mutex               seenMutex;
+  std::set<uint32_t>       seen;
+  int                      mismatches = 0;
+  std::vector<std::thread> tasks;
+  for (int t = 0; t < 4; t++) {
+    tasks.push_back(std::thread([&, t]() {
+      char name[16];
+      sprintf(name, "/task%d", t);
+      for (int i = 0; i < 200; i++) {
+        uint32_t request = fileSystem.queueSave(name, i);
+        bool     matches = request != 0 && fileSystem.lastRequest() == request;
+        std::lock_guard<std::mutex> lock(seenMutex);
+        mismatches += !matches || !seen.insert(request).second;
+      }
+    }));
+  }
+  for (std::thread& task : tasks) task.join();
+  fileSystem.flushAndWait();
+  CHECK_EQUAL(0, mismatches);
+  CHECK_EQUAL(800u, seen.size());
+  CHECK_EQUAL(std::string("199"), spiffsFlash()->contents("/task3"));
+}
+
+TEST(failedWorkerWritesDirectly) {
+  resetFlash();
+  hostTaskCreateFails() = true;
+  eSPIFFSAsync fileSystem;
+  uint32_t     completed = 0;
+  fileSystem.onComplete([&](uint32_t _request, const char*, bool) { completed = _request; });
+  int      value = 7;
+  uint32_t request = fileSystem.queueSave("/value", value);
+  CHECK(request != 0);
+  CHECK_EQUAL(request, completed);
+  CHECK_EQUAL(0u, fileSystem.pending());
+  CHECK_EQUAL(std::string("7"), spiffsFlash()->contents("/value"));
+  hostTaskCreateFails() = false;
+}
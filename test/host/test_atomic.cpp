@@ -0,0 +1,172 @@
+// Atomic saves leave either the old or the new file after power is lost at any point, and never touch user files
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->restorePower();
+  spiffsFlash()->setRenameReplaces(false);
+  spiffsFlash()->resetCounters();
+}
+
+// SPIFFS with the rename behaviour of LittleFS on the ESP8266
+struct ReplacingSPIFFS : eSPIFFSSPIFFS {
+  static const bool RENAME_REPLACES = true;
+};
+
+template <class Backend>
+static int powerLossOutcomes(bool _atomic, int& _torn) {
+  // Cut power after every possible number of flash operations and check what a fresh mount finds
+  const std::string oldValue(300, 'o');
+  const std::string newValue(400, 'n');
+  _torn = 0;
+  for (long cut = 0;; cut++) {
+    resetFlash();
+    spiffsFlash()->setRenameReplaces(Backend::RENAME_REPLACES);
+    spiffsFlash()->setContents("/value", oldValue);
+    {
+      eSPIFFSOn<Backend> fileSystem;
+      fileSystem.setAtomicSaves(_atomic);
+      fileSystem.mount();
+      spiffsFlash()->cutPowerAfter(cut);
+      std::string input = newValue;
+      fileSystem.saveToFile("/value", input);
+    }
+    bool completed = !spiffsFlash()->powerLost();
+    spiffsFlash()->restorePower();
+    spiffsFlash()->end();
+
+    eSPIFFSOn<Backend> fileSystem;
+    CHECK(fileSystem.mount());
+    std::string value = spiffsFlash()->contents("/value");
+    if (value != oldValue && value != newValue) _torn++;
+    if (_atomic) CHECK_EQUAL(1u, spiffsFlash()->list().size());
+    if (completed) {
+      CHECK(value == newValue);
+      return cut;
+    }
+  }
+}
+
+TEST(atomicSaveSurvivesPowerLoss) {
+  int torn;
+  int cuts = powerLossOutcomes<eSPIFFSSPIFFS>(true, torn);
+  CHECK(cuts > 4);
+  CHECK_EQUAL(0, torn);
+}
+
+TEST(atomicSaveSurvivesPowerLossWithReplacingRename) {
+  int torn;
+  powerLossOutcomes<ReplacingSPIFFS>(true, torn);
+  CHECK_EQUAL(0, torn);
+}
+
+TEST(directSaveCanTearOnPowerLoss) {
+  int torn;
+  powerLossOutcomes<eSPIFFSSPIFFS>(false, torn);
+  CHECK(torn > 0);
+}
+
+TEST(userFilesWithMarksAreLeftAlone) {
+  resetFlash();
+  spiffsFlash()->setContents("/a", "original");
+  spiffsFlash()->setContents("/a^", "user");
+  spiffsFlash()->setContents("/notes~", "user");
+  spiffsFlash()->setContents("/a~12345678", "user");
+  spiffsFlash()->setContents("/a^12345678", "user");
+  eSPIFFS fileSystem;
+  CHECK(fileSystem.mount());
+  CHECK_EQUAL(5u, spiffsFlash()->list().size());
+  CHECK_EQUAL(std::string("original"), spiffsFlash()->contents("/a"));
+}
+
+TEST(leftoversFromAnInterruptedSaveAreRecovered) {
+  // A save that stopped before verifying is dropped, one that stopped while swapping in is finished
+  resetFlash();
+  std::string staged = "new";
+  uint32_t    crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)staged.data(), staged.size());
+  spiffsFlash()->setContents("/a", "old");
+  spiffsFlash()->setContents(Effortless_SPIFFS_Internal::markedName("/a", '^', crc), staged);
+  spiffsFlash()->setContents("/b", "old");
+  spiffsFlash()->setContents(Effortless_SPIFFS_Internal::markedName("/b", '~', Effortless_SPIFFS_Internal::crc32((const uint8_t*)"/b", 2)), "ne");
+  eSPIFFS fileSystem;
+  CHECK(fileSystem.mount());
+  CHECK_EQUAL(2u, spiffsFlash()->list().size());
+  CHECK_EQUAL(std::string("new"), spiffsFlash()->contents("/a"));
+  CHECK_EQUAL(std::string("old"), spiffsFlash()->contents("/b"));
+}
+
+TEST(damagedStagedFileIsNotPromoted) {
+  resetFlash();
+  uint32_t crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)"new", 3);
+  spiffsFlash()->setContents("/a", "old");
+  spiffsFlash()->setContents(Effortless_SPIFFS_Internal::markedName("/a", '^', crc), "nex");
+  eSPIFFS fileSystem;
+  CHECK(fileSystem.mount());
+  CHECK_EQUAL(std::string("old"), spiffsFlash()->contents("/a"));
+}
+
+TEST(stagedFileIsNotPromotedWhenRenameReplaces) {
+  resetFlash();
+  spiffsFlash()->setRenameReplaces(true);
+  uint32_t crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)"new", 3);
+  spiffsFlash()->setContents("/a", "old");
+  spiffsFlash()->setContents(Effortless_SPIFFS_Internal::markedName("/a", '^', crc), "new");
+  eSPIFFSOn<ReplacingSPIFFS> fileSystem;
+  CHECK(fileSystem.mount());
+  CHECK_EQUAL(std::string("old"), spiffsFlash()->contents("/a"));
+}
+
+TEST(atomicSavesAreOnByDefault) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+  int value = 1;
+  CHECK(fileSystem.saveToFile("/value", value));
+  CHECK_EQUAL(2ul, spiffsFlash()->counters().renames);
+  fileSystem.setAtomicSaves(false);
+  spiffsFlash()->resetCounters();
+  CHECK(fileSystem.saveToFile("/value", value));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(1ul, counters.opens);
+  CHECK_EQUAL(0ul, counters.renames);
+}
+
+TEST(atomicSaveCost) {
+  // One save reads the data back once, then SPIFFS needs two renames and a remove
+  resetFlash();
+  spiffsFlash()->setContents("/value", "0");
+  eSPIFFS fileSystem;
+  fileSystem.setAtomicSaves(true);
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+  std::string value(100, 'v');
+  CHECK(fileSystem.saveToFile("/value", value));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(2ul, counters.opens);
+  CHECK_EQUAL(100ul, counters.bytesWritten);
+  CHECK_EQUAL(100ul, counters.bytesRead);
+  CHECK_EQUAL(2ul, counters.renames);
+  CHECK_EQUAL(1ul, counters.removes);
+}
+
+TEST(atomicSaveCostWithReplacingRename) {
+  // No read back and a single rename, the same number of opens as a direct save plus one rename
+  resetFlash();
+  spiffsFlash()->setRenameReplaces(true);
+  spiffsFlash()->setContents("/value", "0");
+  eSPIFFSOn<ReplacingSPIFFS> fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+  std::string value(100, 'v');
+  CHECK(fileSystem.saveToFile("/value", value));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(1ul, counters.opens);
+  CHECK_EQUAL(0ul, counters.bytesRead);
+  CHECK_EQUAL(1ul, counters.renames);
+  CHECK_EQUAL(0ul, counters.removes);
+  CHECK_EQUAL(std::string(100, 'v'), spiffsFlash()->contents("/value"));
+}
@@ -0,0 +1,428 @@
+// The RAM, RTC and POSIX backends run the same calls as flash, including atomic saves, recovery, the index, batches, ring logs
+// and the key value store, async and tiered classes built on eSPIFFSOn
+#include "host_test.h"
+
+// Headers written against the old class still forward declare it
+class eSPIFFS;
+static bool saveDefaults(eSPIFFS& _fileSystem);
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_Async.h>
+#include <Effortless_SPIFFS_KV.h>
+#include <Effortless_SPIFFS_POSIX.h>
+#include <Effortless_SPIFFS_RAM.h>
+#include <Effortless_SPIFFS_RTC.h>
+#include <Effortless_SPIFFS_RingLog.h>
+#include <Effortless_SPIFFS_Tiered.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static std::string posixRoot() {
+  // One fresh directory per test run
+  static std::string root;
+  if (root.empty()) {
+    char path[] = "/tmp/espiffs_XXXXXX";
+    root = mkdtemp(path);
+    atexit([] { system(("rm -rf " + root).c_str()); });
+  }
+  return root;
+}
+
+static void resetFlash() {
+  eSPIFFSRAM::format();
+  eSPIFFSRTC::format();
+  eSPIFFSPOSIX::setRoot(posixRoot().c_str());
+  std::string command = "rm -rf " + posixRoot() + "/*";
+  CHECK_EQUAL(0, system(command.c_str()));
+}
+
+static std::string diskContents(const std::string& _path) {
+  std::ifstream     file(posixRoot() + _path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+template <class Backend>
+static void valuesRoundTrip() {
+  resetFlash();
+  eSPIFFSOn<Backend> fileSystem;
+  CHECK(fileSystem.mount());
+
+  int         number = 42;
+  double      real = 2.5;
+  std::string text = "hello";
+  CHECK(fileSystem.saveToFile("/number", number));
+  CHECK(fileSystem.saveToFile("/real", real));
+  CHECK(fileSystem.saveToFile("/text", text));
+  CHECK(fileSystem.appendFile("/text", " world"));
+
+  int         readNumber = 0;
+  double      readReal = 0;
+  std::string readText;
+  const char* readChars = nullptr;
+  CHECK(fileSystem.openFromFile("/number", readNumber));
+  CHECK(fileSystem.openFromFile("/real", readReal));
+  CHECK(fileSystem.openFromFile("/text", readText));
+  CHECK(fileSystem.openFromFile("/text", readChars));
+  CHECK_EQUAL(42, readNumber);
+  CHECK(readReal == 2.5);
+  CHECK_EQUAL(std::string("hello world"), readText);
+  CHECK(readChars && std::string(readChars) == "hello world");
+  CHECK_EQUAL(11, fileSystem.getFileSize("/text"));
+
+  CHECK(fileSystem.renameFile("/text", "/moved"));
+  CHECK(!fileSystem.exists("/text"));
+  CHECK(fileSystem.exists("/moved"));
+  CHECK(fileSystem.removeFile("/moved"));
+  CHECK(!fileSystem.exists("/moved"));
+  CHECK(!fileSystem.openFromFile("/moved", readText));
+}
+
+template <class Backend>
+static void atomicSavesAndRecovery() {
+  resetFlash();
+  {
+    eSPIFFSOn<Backend> fileSystem;
+    fileSystem.setAtomicSaves(true);
+    std::string value(300, 'a');
+    CHECK(fileSystem.saveToFile("/value", value));
+    value.assign(400, 'b');
+    CHECK(fileSystem.saveToFile("/value", value));
+  }
+
+  // Leave a verified staged file behind as if power was lost while swapping it in
+  {
+    eSPIFFSOn<Backend> fileSystem;
+    std::string        staged(500, 'c');
+    std::string        stagedName = Effortless_SPIFFS_Internal::markedName("/value", '^', Effortless_SPIFFS_Internal::crc32((const uint8_t*)staged.data(), staged.size()));
+    CHECK(fileSystem.saveFile(stagedName.c_str(), staged.c_str()));
+  }
+
+  eSPIFFSOn<Backend> fileSystem;
+  CHECK(fileSystem.mount());
+  std::string value;
+  CHECK(fileSystem.openFromFile("/value", value));
+  CHECK(value == std::string(Backend::RENAME_REPLACES ? 400 : 500, Backend::RENAME_REPLACES ? 'b' : 'c'));
+  size_t numFiles = 0;
+  File   root = fileSystem.getFile("/", "r");
+  for (File file = root.openNextFile(); file; file = root.openNextFile()) numFiles++;
+  CHECK_EQUAL(Backend::RENAME_REPLACES ? 2u : 1u, numFiles);  // Staged files are left alone when rename replaces
+}
+
+template <class Backend>
+static void indexListsTheRoot() {
+  resetFlash();
+  {
+    eSPIFFSOn<Backend> fileSystem;
+    CHECK(fileSystem.saveFile("/a", "1"));
+    CHECK(fileSystem.saveFile("/b", "22"));
+  }
+  eSPIFFSOn<Backend> fileSystem;
+  fileSystem.enableIndex();
+  CHECK(fileSystem.mount());
+  CHECK_EQUAL(2u * 16, fileSystem.getIndexMemory());
+  CHECK_EQUAL(2, fileSystem.getFileSize("/b"));
+  CHECK(!fileSystem.exists("/c"));
+}
+
+struct Sample {
+  uint32_t time;
+  float    value;
+};
+
+template <class Backend>
+static void ringLogWrapsInPlace() {
+  resetFlash();
+  eSPIFFSOn<Backend>                             fileSystem;
+  eSPIFFSRingLog<Sample, eSPIFFSOn<Backend>> log(fileSystem, "/samples.log", 4, 1);
+  for (uint32_t i = 1; i <= 7; i++) CHECK(log.append({i, i * 0.5f}));
+  log.end();
+
+  eSPIFFSRingLog<Sample, eSPIFFSOn<Backend>> reopened(fileSystem, "/samples.log", 4, 1);
+  Sample                                     last[4];
+  CHECK_EQUAL(4u, reopened.readLast(last, 4));
+  for (uint32_t i = 0; i < 4; i++) CHECK_EQUAL(i + 4, last[i].time);
+}
+
+template <class Backend>
+static void batchCommitsTogether() {
+  resetFlash();
+  eSPIFFSOn<Backend>                 fileSystem;
+  eSPIFFSBatchOn<eSPIFFSOn<Backend>> batch(fileSystem);
+  int                                a = 1;
+  std::string                        b = "two";
+  CHECK(batch.stage("/a", a));
+  CHECK(batch.stage("/b", b));
+  CHECK(!fileSystem.exists("/a"));
+  CHECK(batch.commit());
+  std::string read;
+  CHECK(fileSystem.openFromFile("/b", read));
+  CHECK_EQUAL(b, read);
+  CHECK(!fileSystem.exists(Effortless_SPIFFS_JOURNAL));
+}
+
+// Classes built on eSPIFFSOn replace its calls at compile time, none of them carries a vtable
+static_assert(!std::is_polymorphic<eSPIFFS>::value, "eSPIFFS has virtual methods");
+static_assert(!std::is_polymorphic<eSPIFFSKV>::value, "eSPIFFSKV has virtual methods");
+static_assert(!std::is_polymorphic<eSPIFFSAsync>::value, "eSPIFFSAsync has virtual methods");
+static_assert(!std::is_polymorphic<eSPIFFSTiered>::value, "eSPIFFSTiered has virtual methods");
+
+template <class Backend>
+static void keyValueStoreInOneFile() {
+  resetFlash();
+  eSPIFFSKVOn<Backend> store("/store.kv");
+  int                  number = 7;
+  std::string          text = "seven";
+  CHECK(store.saveToFile("number", number));
+  CHECK(store.saveToFile("text", text));
+  int         readNumber = 0;
+  std::string readText;
+  CHECK(store.openFromFile("number", readNumber));
+  CHECK(store.openFromFile("text", readText));
+  CHECK_EQUAL(7, readNumber);
+  CHECK_EQUAL(text, readText);
+
+  eSPIFFSOn<Backend> fileSystem;
+  CHECK(fileSystem.exists("/store.kv"));
+  CHECK(!fileSystem.exists("number"));
+}
+
+template <class Backend>
+static void asyncSavesReachTheBackend() {
+  resetFlash();
+  eSPIFFSAsyncOn<Backend> fileSystem;
+  int                     value = 3;
+  uint32_t                request = fileSystem.queueSave("/queued", value);
+  CHECK(request != 0);
+  fileSystem.flushAndWait();
+  CHECK(!fileSystem.isPending(request));
+  eSPIFFSOn<Backend> plain;
+  int                read = 0;
+  CHECK(plain.openFromFile("/queued", read));
+  CHECK_EQUAL(3, read);
+}
+
+template <class Backend>
+static void hotFilesWaitForPersist() {
+  resetFlash();
+  eSPIFFSTieredOn<Backend> fileSystem;
+  fileSystem.addHotFile("/hot");
+  int counter = 0;
+  for (int i = 0; i < 10; i++) {
+    counter++;
+    CHECK(fileSystem.saveToFile("/hot", counter));
+  }
+  int read = 0;
+  CHECK(fileSystem.openFromFile("/hot", read));
+  CHECK_EQUAL(10, read);
+  eSPIFFSOn<Backend> plain;
+  CHECK(!plain.exists("/hot"));
+  CHECK(fileSystem.persist());
+  CHECK(plain.openFromFile("/hot", read));
+  CHECK_EQUAL(10, read);
+}
+
+TEST(ramValuesRoundTrip) {
+  valuesRoundTrip<eSPIFFSRAM>();
+}
+
+TEST(posixValuesRoundTrip) {
+  valuesRoundTrip<eSPIFFSPOSIX>();
+}
+
+TEST(rtcValuesRoundTrip) {
+  valuesRoundTrip<eSPIFFSRTC>();
+}
+
+TEST(ramAtomicSavesAndRecovery) {
+  atomicSavesAndRecovery<eSPIFFSRAM>();
+}
+
+TEST(posixAtomicSavesAndRecovery) {
+  atomicSavesAndRecovery<eSPIFFSPOSIX>();
+}
+
+TEST(rtcAtomicSavesAndRecovery) {
+  atomicSavesAndRecovery<eSPIFFSRTC>();
+}
+
+TEST(ramIndexListsTheRoot) {
+  indexListsTheRoot<eSPIFFSRAM>();
+}
+
+TEST(posixIndexListsTheRoot) {
+  indexListsTheRoot<eSPIFFSPOSIX>();
+}
+
+TEST(rtcIndexListsTheRoot) {
+  indexListsTheRoot<eSPIFFSRTC>();
+}
+
+TEST(ramRingLogWrapsInPlace) {
+  ringLogWrapsInPlace<eSPIFFSRAM>();
+}
+
+TEST(posixRingLogWrapsInPlace) {
+  ringLogWrapsInPlace<eSPIFFSPOSIX>();
+}
+
+TEST(rtcRingLogWrapsInPlace) {
+  ringLogWrapsInPlace<eSPIFFSRTC>();
+}
+
+TEST(ramBatchCommitsTogether) {
+  batchCommitsTogether<eSPIFFSRAM>();
+}
+
+TEST(posixBatchCommitsTogether) {
+  batchCommitsTogether<eSPIFFSPOSIX>();
+}
+
+TEST(rtcBatchCommitsTogether) {
+  batchCommitsTogether<eSPIFFSRTC>();
+}
+
+TEST(ramKeyValueStoreInOneFile) {
+  keyValueStoreInOneFile<eSPIFFSRAM>();
+}
+
+TEST(posixKeyValueStoreInOneFile) {
+  keyValueStoreInOneFile<eSPIFFSPOSIX>();
+}
+
+TEST(rtcKeyValueStoreInOneFile) {
+  keyValueStoreInOneFile<eSPIFFSRTC>();
+}
+
+TEST(ramAsyncSavesReachTheBackend) {
+  asyncSavesReachTheBackend<eSPIFFSRAM>();
+}
+
+TEST(posixAsyncSavesReachTheBackend) {
+  asyncSavesReachTheBackend<eSPIFFSPOSIX>();
+}
+
+TEST(rtcAsyncSavesReachTheBackend) {
+  asyncSavesReachTheBackend<eSPIFFSRTC>();
+}
+
+TEST(ramHotFilesWaitForPersist) {
+  hotFilesWaitForPersist<eSPIFFSRAM>();
+}
+
+TEST(posixHotFilesWaitForPersist) {
+  hotFilesWaitForPersist<eSPIFFSPOSIX>();
+}
+
+TEST(rtcHotFilesWaitForPersist) {
+  hotFilesWaitForPersist<eSPIFFSRTC>();
+}
+
+TEST(posixFilesAreOnDisk) {
+  resetFlash();
+  eSPIFFSOn<eSPIFFSPOSIX> fileSystem;
+  int                     value = 1234;
+  CHECK(fileSystem.saveToFile("/value.txt", value));
+  CHECK_EQUAL(std::string("1234"), diskContents("/value.txt"));
+}
+
+TEST(posixMountFailsWithoutRoot) {
+  eSPIFFSPOSIX::setRoot("/tmp/espiffs_missing_root");
+  eSPIFFSOn<eSPIFFSPOSIX> fileSystem;
+  CHECK(!fileSystem.mount());
+  eSPIFFSPOSIX::setRoot(posixRoot().c_str());
+  CHECK(fileSystem.mount());
+}
+
+TEST(ramSharedBetweenInstances) {
+  resetFlash();
+  eSPIFFSOn<eSPIFFSRAM> first;
+  eSPIFFSOn<eSPIFFSRAM> second;
+  CHECK(first.saveFile("/shared", "value"));
+  std::string value;
+  CHECK(second.openFromFile("/shared", value));
+  CHECK_EQUAL(std::string("value"), value);
+  CHECK_EQUAL(5u, eSPIFFSRAM::usedBytes());
+}
+
+TEST(ramSavesFailOnceFull) {
+  resetFlash();
+  eSPIFFSOn<eSPIFFSRAM> fileSystem;
+  std::string           large(Effortless_SPIFFS_RAM_SIZE - 10, 'l');
+  std::string           extra(20, 'e');
+  CHECK(fileSystem.saveToFile("/large", large));
+  CHECK(!fileSystem.saveToFile("/extra", extra));
+  CHECK(fileSystem.removeFile("/large"));
+  CHECK(fileSystem.saveToFile("/extra", extra));
+  CHECK_EQUAL(20u, eSPIFFSRAM::usedBytes());
+}
+
+TEST(ramFoldersAreListed) {
+  resetFlash();
+  eSPIFFSOn<eSPIFFSRAM> fileSystem;
+  CHECK(fileSystem.saveFile("/top", "t"));
+  CHECK(fileSystem.saveFile("/folder/a", "a"));
+  CHECK(fileSystem.saveFile("/folder/b", "b"));
+  File                     root = fileSystem.getFile("/", "r");
+  std::vector<std::string> names;
+  for (File file = root.openNextFile(); file; file = root.openNextFile()) names.push_back(std::string(file.path()) + (file.isDirectory() ? "/" : ""));
+  CHECK_EQUAL(2u, names.size());
+  CHECK(names.size() == 2 && names[0] == "/folder/" && names[1] == "/top");
+  CHECK(fileSystem.exists("/folder"));
+}
+
+TEST(rtcFilesComeBackAfterAReset) {
+  // A new RTC file system reads back the image the old one left in RTC memory, as it would after waking from deep sleep
+  resetFlash();
+  {
+    eSPIFFSOn<eSPIFFSRTC> fileSystem;
+    int                   counter = 12;
+    CHECK(fileSystem.saveToFile("/counter", counter));
+    CHECK(fileSystem.saveFile("/folder/name", "kept"));
+  }
+  fs::FS      restored(std::make_shared<Effortless_SPIFFS_Internal::RtcFS>());
+  File        counter = restored.open("/counter", "r");
+  File        name = restored.open("/folder/name", "r");
+  std::string contents(8, '\0');
+  CHECK(counter && name);
+  contents.resize(counter.read((uint8_t*)&contents[0], contents.size()));
+  CHECK_EQUAL(std::string("12"), contents);
+  contents.resize(8);
+  contents.resize(name.read((uint8_t*)&contents[0], contents.size()));
+  CHECK_EQUAL(std::string("kept"), contents);
+}
+
+TEST(rtcDamagedImageIsIgnored) {
+  resetFlash();
+  eSPIFFSOn<eSPIFFSRTC> fileSystem;
+  CHECK(fileSystem.saveFile("/value", "1234"));
+  ((uint8_t*)Effortless_SPIFFS_Internal::rtcFileMemory())[20] ^= 0xFF;
+  fs::FS restored(std::make_shared<Effortless_SPIFFS_Internal::RtcFS>());
+  CHECK(!restored.exists("/value"));
+}
+
+TEST(rtcSavesFailOnceFull) {
+  // Names and lengths take room in RTC memory as well as contents
+  resetFlash();
+  eSPIFFSOn<eSPIFFSRTC> fileSystem;
+  std::string           large(Effortless_SPIFFS_RTC_FS_SIZE - 40, 'l');
+  std::string           extra(20, 'e');
+  CHECK(fileSystem.saveToFile("/large", large));
+  CHECK(!fileSystem.saveToFile("/extra", extra));
+  CHECK(fileSystem.removeFile("/large"));
+  CHECK(fileSystem.saveToFile("/extra", extra));
+  CHECK_EQUAL(3u + 6 + 20, eSPIFFSRTC::usedBytes());
+}
+
+static bool saveDefaults(eSPIFFS& _fileSystem) {
+  return _fileSystem.saveFile("/defaults", "1");
+}
+
+TEST(defaultClassCanBeForwardDeclared) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  CHECK(saveDefaults(fileSystem));
+}
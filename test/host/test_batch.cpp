@@ -0,0 +1,165 @@
+// A batch saves every file or none of them, reads back what it staged, and a failed batch never loses cached values
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->restorePower();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(failedBatchKeepsCachedValue) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache();
+  int value = 1;
+  CHECK(fileSystem.saveToFile("/a", value));
+  CHECK(spiffsFlash()->contents("/a").empty());
+
+  eSPIFFSBatch batch(fileSystem);
+  int          other = 2;
+  batch.stage("/a", other);
+  spiffsFlash()->cutPowerAfter(0);
+  CHECK(!batch.commit());
+  spiffsFlash()->restorePower();
+
+  int read = 0;
+  CHECK(fileSystem.openFromFile("/a", read));
+  CHECK_EQUAL(1, read);
+  CHECK(fileSystem.flush());
+  CHECK_EQUAL(std::string("1"), spiffsFlash()->contents("/a"));
+}
+
+TEST(committedBatchReplacesCachedValue) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache();
+  int value = 1;
+  CHECK(fileSystem.saveToFile("/a", value));
+
+  eSPIFFSBatch batch(fileSystem);
+  int          other = 2;
+  batch.stage("/a", other);
+  CHECK(batch.commit());
+  CHECK(fileSystem.flush());
+
+  int read = 0;
+  CHECK(fileSystem.openFromFile("/a", read));
+  CHECK_EQUAL(2, read);
+  CHECK_EQUAL(std::string("2"), spiffsFlash()->contents("/a"));
+}
+
+TEST(batchSurvivesPowerLoss) {
+  // Cut power after every flash operation of a commit, a fresh mount finds every old value or every new one
+  int torn = 0;
+  for (long cut = 0;; cut++) {
+    resetFlash();
+    spiffsFlash()->setContents("/a", "1");
+    spiffsFlash()->setContents("/b", "1");
+    {
+      eSPIFFS fileSystem;
+      fileSystem.mount();
+      eSPIFFSBatch batch(fileSystem);
+      int          a = 22;
+      int          b = 22;
+      batch.stage("/a", a);
+      batch.stage("/b", b);
+      spiffsFlash()->cutPowerAfter(cut);
+      batch.commit();
+    }
+    bool completed = !spiffsFlash()->powerLost();
+    spiffsFlash()->restorePower();
+    spiffsFlash()->end();
+
+    eSPIFFS fileSystem;
+    CHECK(fileSystem.mount());
+    std::string a = spiffsFlash()->contents("/a");
+    std::string b = spiffsFlash()->contents("/b");
+    if (a != b || (a != "1" && a != "22")) torn++;
+    CHECK_EQUAL(2u, spiffsFlash()->list().size());
+    if (completed) {
+      CHECK(a == "22");
+      CHECK(cut > 4);
+      break;
+    }
+  }
+  CHECK_EQUAL(0, torn);
+}
+
+TEST(stagedValuesReadBackBeforeCommit) {
+  // Staging only touches RAM, reads of staged files see the staged value and other files come from flash
+  resetFlash();
+  spiffsFlash()->setContents("/other", "7");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+
+  eSPIFFSBatch batch(fileSystem);
+  int          a = 5;
+  std::string  text = "hello";
+  float        values[3] = {1.5f, 2.5f, 3.5f};
+  CHECK(batch.stage("/a", a));
+  CHECK(batch.stage("/text", text));
+  CHECK(batch.stage("/values", values));
+  CHECK_EQUAL(3u, batch.size());
+  CHECK_EQUAL(0ul, spiffsFlash()->counters().opens);
+  CHECK(!fileSystem.exists("/a"));
+
+  int         readA = 0;
+  std::string readText;
+  float       readValues[3] = {};
+  int         readOther = 0;
+  CHECK(batch.openFromFile("/a", readA));
+  CHECK(batch.openFromFile("/text", readText));
+  CHECK(batch.openFromFile("/values", readValues));
+  CHECK(batch.openFromFile("/other", readOther));
+  CHECK_EQUAL(5, readA);
+  CHECK_EQUAL(text, readText);
+  CHECK_EQUAL(2.5f, readValues[1]);
+  CHECK_EQUAL(7, readOther);
+
+  CHECK(batch.commit());
+  CHECK_EQUAL(0u, batch.size());
+  CHECK_EQUAL(std::string("5"), spiffsFlash()->contents("/a"));
+  CHECK_EQUAL(text, spiffsFlash()->contents("/text"));
+}
+
+TEST(stagedValuesUseTheFileSystemSettings) {
+  // A binary or compressing file system gets exactly the bytes its own saveToFile would write
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  fileSystem.setCompression(true);
+  int         value = 12345;
+  std::string text(512, 'x');
+  CHECK(fileSystem.saveToFile("/direct", value));
+  CHECK(fileSystem.saveToFile("/directText", text));
+
+  eSPIFFSBatch batch(fileSystem);
+  CHECK(batch.stage("/staged", value));
+  CHECK(batch.stage("/stagedText", text));
+  CHECK(batch.commit());
+  CHECK_EQUAL(spiffsFlash()->contents("/direct"), spiffsFlash()->contents("/staged"));
+  CHECK_EQUAL(spiffsFlash()->contents("/directText"), spiffsFlash()->contents("/stagedText"));
+  CHECK(spiffsFlash()->contents("/stagedText").size() < text.size());
+}
+
+TEST(stagedAppendStartsFromTheFile) {
+  resetFlash();
+  spiffsFlash()->setContents("/log", "ab");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  eSPIFFSBatch batch(fileSystem);
+  const char*  first = "cd";
+  const char*  second = "ef";
+  CHECK(batch.stageAppend("/log", first));
+  CHECK(batch.stageAppend("/log", second));
+  CHECK_EQUAL(std::string("ab"), spiffsFlash()->contents("/log"));
+  CHECK(batch.commit());
+  CHECK_EQUAL(std::string("abcdef"), spiffsFlash()->contents("/log"));
+}
@@ -0,0 +1,89 @@
+// Binary encoding stores numbers as a tagged little endian value with a CRC8 and still reads text files
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(binarySizesMatchTheTable) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  bool   flag = true;
+  int    integer = -123456;
+  float  single = 1.5f;
+  double wide = 3.141592653589793;
+  CHECK(fileSystem.saveToFile("/bool", flag));
+  CHECK(fileSystem.saveToFile("/int", integer));
+  CHECK(fileSystem.saveToFile("/float", single));
+  CHECK(fileSystem.saveToFile("/double", wide));
+  CHECK_EQUAL(4u, spiffsFlash()->contents("/bool").size());
+  CHECK_EQUAL(7u, spiffsFlash()->contents("/int").size());
+  CHECK_EQUAL(7u, spiffsFlash()->contents("/float").size());
+  CHECK_EQUAL(11u, spiffsFlash()->contents("/double").size());
+  CHECK_EQUAL(0xE5, (uint8_t)spiffsFlash()->contents("/int")[0]);
+}
+
+TEST(binaryRoundTrip) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  int64_t big = -9007199254740993LL;
+  double  wide = 0.1;
+  bool    flag = true;
+  CHECK(fileSystem.saveToFile("/big", big));
+  CHECK(fileSystem.saveToFile("/double", wide));
+  CHECK(fileSystem.saveToFile("/bool", flag));
+
+  int64_t bigRead = 0;
+  double  wideRead = 0;
+  bool    flagRead = false;
+  CHECK(fileSystem.openFromFile("/big", bigRead));
+  CHECK(fileSystem.openFromFile("/double", wideRead));
+  CHECK(fileSystem.openFromFile("/bool", flagRead));
+  CHECK_EQUAL(big, bigRead);
+  CHECK_EQUAL(wide, wideRead);
+  CHECK(flagRead);
+}
+
+TEST(binaryConvertsBetweenTypes) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  int value = 250;
+  CHECK(fileSystem.saveToFile("/value", value));
+  double asDouble = 0;
+  long   asLong = 0;
+  CHECK(fileSystem.openFromFile("/value", asDouble));
+  CHECK(fileSystem.openFromFile("/value", asLong));
+  CHECK_EQUAL(250.0, asDouble);
+  CHECK_EQUAL(250L, asLong);
+}
+
+TEST(textFilesStillLoad) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "-17");
+  eSPIFFS fileSystem;
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  int value = 0;
+  CHECK(fileSystem.openFromFile("/value", value));
+  CHECK_EQUAL(-17, value);
+}
+
+TEST(corruptBinaryIsNotDecoded) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setEncoding(eSPIFFS::BINARY_ENCODING);
+  int value = 1000;
+  CHECK(fileSystem.saveToFile("/value", value));
+  std::string stored = spiffsFlash()->contents("/value");
+  stored[3] ^= 0x01;
+  spiffsFlash()->setContents("/value", stored);
+  int read = 0;
+  fileSystem.openFromFile("/value", read);
+  CHECK(read != (1000 ^ 0x100));
+}
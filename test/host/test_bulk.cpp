@@ -0,0 +1,93 @@
+// Arrays, vectors and plain structs are saved as one binary block and damaged blocks are never decoded
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+struct Point {
+  int16_t x;
+  int16_t y;
+};
+
+TEST(bulkRoundTrip) {
+  resetFlash();
+  eSPIFFS            fileSystem;
+  std::vector<int>   values = {1, -2, 300000, -400000};
+  Point              points[2] = {{1, 2}, {-3, 4}};
+  std::vector<int>   valuesRead;
+  Point              pointsRead[2] = {};
+  CHECK(fileSystem.saveToFile("/values", values));
+  CHECK(fileSystem.saveToFile("/points", points));
+  CHECK_EQUAL(13u + 4 * sizeof(int), spiffsFlash()->contents("/values").size());
+  CHECK(fileSystem.openFromFile("/values", valuesRead));
+  CHECK(fileSystem.openFromFile("/points", pointsRead));
+  CHECK(valuesRead == values);
+  CHECK_EQUAL(-3, pointsRead[1].x);
+  CHECK_EQUAL(4, pointsRead[1].y);
+}
+
+TEST(bulkConvertsScalars) {
+  resetFlash();
+  eSPIFFS             fileSystem;
+  std::vector<int>    values = {1, -2, 3};
+  std::vector<double> asDouble;
+  CHECK(fileSystem.saveToFile("/values", values));
+  CHECK(fileSystem.openFromFile("/values", asDouble));
+  CHECK_EQUAL(3u, asDouble.size());
+  CHECK_EQUAL(-2.0, asDouble[1]);
+}
+
+TEST(bulkIgnoresTornAppend) {
+  resetFlash();
+  eSPIFFS          fileSystem;
+  std::vector<int> first = {1, 2};
+  std::vector<int> second = {3, 4};
+  CHECK(fileSystem.saveToFile("/values", first));
+  CHECK(fileSystem.appendToFile("/values", second));
+  std::string stored = spiffsFlash()->contents("/values");
+  stored.resize(stored.size() - 3);
+  spiffsFlash()->setContents("/values", stored);
+  std::vector<int> read;
+  CHECK(fileSystem.openFromFile("/values", read));
+  CHECK(read == first);
+}
+
+static std::string block(uint8_t _tag, uint16_t _elementSize, uint32_t _count, size_t _payloadSize) {
+  // A block with a valid CRC around whatever header it is given
+  std::string data(13 + _payloadSize, '\x01');
+  data[0] = (char)0xE5;
+  data[1] = 0x51;
+  data[2] = _tag;
+  data[3] = _elementSize;
+  data[4] = _elementSize >> 8;
+  for (size_t i = 0; i < 4; i++) data[5 + i] = _count >> (8 * i);
+  uint32_t crc = Effortless_SPIFFS_Internal::crc32((const uint8_t*)data.data() + 13, _payloadSize,
+                                                   Effortless_SPIFFS_Internal::crc32((const uint8_t*)data.data(), 9));
+  for (size_t i = 0; i < 4; i++) data[9 + i] = crc >> (8 * i);
+  return data;
+}
+
+TEST(bulkRejectsSizesTheTagNeverHas) {
+  // Zero sized signed elements would shift by a negative amount, odd sizes are never written
+  resetFlash();
+  eSPIFFS fileSystem;
+  const struct {
+    uint8_t  tag;
+    uint16_t size;
+  } invalid[] = {{0x20, 0}, {0x30, 0}, {0x10, 0}, {0x23, 3}, {0x12, 2}, {0x42, 2}, {0x29, 9}, {0x00, 0}};
+  for (auto& entry : invalid) {
+    spiffsFlash()->setContents("/values", block(entry.tag, entry.size, 4, entry.size * 4));
+    std::vector<long> read;
+    CHECK(!fileSystem.openFromFile("/values", read));
+    CHECK(read.empty());
+  }
+  spiffsFlash()->setContents("/values", block(0x22, 2, 2, 4));
+  std::vector<long> read;
+  CHECK(fileSystem.openFromFile("/values", read));
+  CHECK_EQUAL(2u, read.size());
+}
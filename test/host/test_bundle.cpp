@@ -0,0 +1,67 @@
+// Images packed by extras/eSPIFFS_bundle.py open from memory or a mapped partition and are looked up without copying
+#include "host_test.h"
+
+#include <Effortless_SPIFFS_Bundle.h>
+
+#include "bundle_assets.h"
+
+static std::string contents(const eSPIFFSBundle::Asset& _asset) {
+  return std::string((const char*)_asset.data, _asset.size);
+}
+
+TEST(bundleFindsEveryFile) {
+  eSPIFFSBundle bundle;
+  CHECK(bundle.begin(assets, assets_size));
+  CHECK(bundle.verify());
+  CHECK_EQUAL(5u, bundle.numFiles());
+  CHECK_EQUAL(std::string("<html>index</html>\n"), contents(bundle.find("/index.html")));
+  CHECK_EQUAL(std::string("body{margin:0}\n"), contents(bundle.find("/css/site.css")));
+  CHECK_EQUAL(std::string("a"), contents(bundle.find("/a")));
+  CHECK_EQUAL(std::string("ab"), contents(bundle.find("/ab")));
+  CHECK(bundle.exists("/empty.txt"));
+  CHECK_EQUAL(0, bundle.getFileSize("/empty.txt"));
+  CHECK(!bundle.find("/missing"));
+  CHECK(!bundle.find("/a/"));
+  CHECK(!bundle.find(""));
+
+  // Data is a view into the image, aligned for word reads
+  eSPIFFSBundle::Asset page = bundle.find("/index.html");
+  CHECK(page.data >= assets && page.data < assets + assets_size);
+  CHECK_EQUAL(0u, (page.data - assets) % 4);
+}
+
+TEST(bundleRejectsDamagedImages) {
+  std::string   image((const char*)assets, assets_size);
+  eSPIFFSBundle bundle;
+  CHECK(!bundle.begin((const uint8_t*)image.data(), 10));
+  CHECK(!bundle.begin((const uint8_t*)image.data(), image.size() - 1));
+
+  std::string wrongMagic = image;
+  wrongMagic[0] = 'x';
+  CHECK(!bundle.begin((const uint8_t*)wrongMagic.data(), wrongMagic.size()));
+
+  std::string outside = image;
+  outside[20 + 8 + 3] = 0x7f;  // Data offset of the first entry
+  CHECK(!bundle.begin((const uint8_t*)outside.data(), outside.size()));
+
+  std::string flipped = image;
+  flipped[flipped.size() - 2] ^= 0x01;
+  CHECK(bundle.begin((const uint8_t*)flipped.data(), flipped.size()));
+  CHECK(!bundle.verify());
+}
+
+TEST(bundleMapsAPartition) {
+  // Only the image is mapped, not the whole partition, and it is unmapped again on end
+  hostAddPartition("assets", std::string((const char*)assets, assets_size), 64 * 1024);
+  {
+    eSPIFFSBundle bundle;
+    CHECK(bundle.begin("assets"));
+    CHECK(bundle.verify());
+    CHECK_EQUAL(assets_size, bundle.imageSize());
+    CHECK_EQUAL(std::string("ab"), contents(bundle.find("/ab")));
+    CHECK_EQUAL(1u, hostMappings().size());
+    CHECK(!bundle.begin("missing"));
+    CHECK_EQUAL(0u, hostMappings().size());
+  }
+  CHECK_EQUAL(0u, hostMappings().size());
+}
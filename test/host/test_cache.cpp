@@ -0,0 +1,105 @@
+// The write back cache answers reads from RAM and only writes dirty files back when flushed
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(readsAreServedFromRam) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "42");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache();
+  spiffsFlash()->resetCounters();
+
+  int value = 0;
+  for (int i = 0; i < 10; i++) CHECK(fileSystem.openFromFile("/value", value));
+  CHECK_EQUAL(42, value);
+  CHECK_EQUAL(1ul, spiffsFlash()->counters().opens);
+  CHECK_EQUAL(9ul, fileSystem.getCacheStats().hits);
+  CHECK_EQUAL(1ul, fileSystem.getCacheStats().misses);
+}
+
+TEST(unchangedSavesAreSkipped) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "42");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache();
+  spiffsFlash()->resetCounters();
+
+  int value = 42;
+  CHECK(fileSystem.saveToFile("/value", value));
+  CHECK(fileSystem.flush());
+  CHECK_EQUAL(1ul, fileSystem.getCacheStats().writesAvoided);
+  CHECK_EQUAL(0ul, fileSystem.getCacheStats().flashWrites);
+  CHECK_EQUAL(0ul, spiffsFlash()->counters().writes);
+}
+
+TEST(dirtyFilesWaitForFlush) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "1");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache();
+
+  for (int i = 2; i <= 10; i++) CHECK(fileSystem.saveToFile("/value", i));
+  CHECK_EQUAL(std::string("1"), spiffsFlash()->contents("/value"));
+  int value = 0;
+  CHECK(fileSystem.openFromFile("/value", value));
+  CHECK_EQUAL(10, value);
+
+  CHECK(fileSystem.flush());
+  CHECK_EQUAL(std::string("10"), spiffsFlash()->contents("/value"));
+  CHECK_EQUAL(1ul, fileSystem.getCacheStats().flashWrites);
+}
+
+TEST(flushCountPolicy) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache(Effortless_SPIFFS_CACHE_SIZE, 0, 2);
+
+  int value = 1;
+  CHECK(fileSystem.saveToFile("/a", value));
+  CHECK(spiffsFlash()->contents("/a").empty());
+  CHECK(fileSystem.saveToFile("/b", value));
+  CHECK_EQUAL(std::string("1"), spiffsFlash()->contents("/a"));
+  CHECK_EQUAL(std::string("1"), spiffsFlash()->contents("/b"));
+}
+
+TEST(destructorWritesBack) {
+  resetFlash();
+  {
+    eSPIFFS fileSystem;
+    fileSystem.mount();
+    fileSystem.enableCache();
+    int value = 5;
+    CHECK(fileSystem.saveToFile("/value", value));
+    CHECK(spiffsFlash()->contents("/value").empty());
+  }
+  CHECK_EQUAL(std::string("5"), spiffsFlash()->contents("/value"));
+}
+
+TEST(evictionWritesBackDirtyFiles) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.enableCache(32);
+
+  std::string first(20, 'a');
+  std::string second(20, 'b');
+  CHECK(fileSystem.saveToFile("/first", first));
+  CHECK(fileSystem.saveToFile("/second", second));
+  CHECK_EQUAL(first, spiffsFlash()->contents("/first"));
+  CHECK_EQUAL(1ul, fileSystem.getCacheStats().evictions);
+
+  std::string tooLarge(64, 'c');
+  CHECK(fileSystem.saveToFile("/large", tooLarge));
+  CHECK_EQUAL(tooLarge, spiffsFlash()->contents("/large"));
+}
@@ -0,0 +1,60 @@
+// char* reads share one buffer from the char pool across every eSPIFFS and free it before reading again
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(largeCharFileReadsTwice) {
+  // 600 bytes takes three of the four default slots, so the second read only fits once the first is freed
+  resetFlash();
+  spiffsFlash()->setContents("/large", std::string(600, 'c'));
+  eSPIFFS fileSystem;
+  for (int i = 0; i < 2; i++) {
+    char* output = nullptr;
+    CHECK(fileSystem.openFromFile("/large", output));
+    CHECK(output && std::string(output) == std::string(600, 'c'));
+  }
+  const char* constOutput = nullptr;
+  CHECK(fileSystem.openFromFile("/large", constOutput));
+  CHECK(constOutput && strlen(constOutput) == 600);
+}
+
+TEST(instancesDoNotHoldCharSlots) {
+  // Every instance reads a large file in turn, no instance keeps slots from its last read
+  resetFlash();
+  spiffsFlash()->setContents("/large", std::string(600, 'l'));
+  eSPIFFS     first;
+  eSPIFFS     second;
+  eSPIFFS     third;
+  const char* output = nullptr;
+  CHECK(first.openFromFile("/large", output));
+  CHECK(second.openFromFile("/large", output));
+  CHECK(third.openFromFile("/large", output));
+  CHECK(output && strlen(output) == 600);
+
+  // Only the last result is held, leaving the rest of the pool for a CharBuffer
+  eSPIFFS::CharBuffer buffer;
+  spiffsFlash()->setContents("/small", "small");
+  CHECK(first.openFromFile("/small", buffer));
+  CHECK_EQUAL(std::string("small"), std::string(buffer.c_str()));
+}
+
+TEST(charReadFailureKeepsPoolFree) {
+  resetFlash();
+  spiffsFlash()->setContents("/large", std::string(600, 'f'));
+  eSPIFFS fileSystem;
+  char*   output = nullptr;
+  CHECK(fileSystem.openFromFile("/large", output));
+  CHECK(!fileSystem.openFromFile("/missing", output));
+
+  // The failed read released the earlier result, so a whole pool sized buffer is free
+  eSPIFFS::CharBuffer buffer;
+  spiffsFlash()->setContents("/full", std::string(Effortless_SPIFFS_CHAR_SIZE - 1, 'x'));
+  CHECK(fileSystem.openFromFile("/full", buffer));
+  CHECK_EQUAL((size_t)Effortless_SPIFFS_CHAR_SIZE - 1, buffer.length());
+}
@@ -0,0 +1,81 @@
+// Compressed text reads back exactly, is only kept when it is smaller and loads whether or not compression is on
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+#include <random>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+static std::string sample(std::mt19937& _random, size_t _len, int _alphabet) {
+  // Text with repeats at every distance, including past the end of the window
+  std::string text;
+  while (text.size() < _len) {
+    if (text.size() > 8 && _random() % 3 == 0) {
+      size_t from = _random() % text.size();
+      size_t count = 1 + _random() % 40;
+      for (size_t i = 0; i < count && text.size() < _len; i++) text += text[from + i];
+    } else {
+      text += (char)('a' + _random() % _alphabet);
+    }
+  }
+  return text;
+}
+
+TEST(codecRoundTrip) {
+  std::mt19937 random(12345);
+  for (int i = 0; i < 300; i++) {
+    size_t      len = i < 20 ? i : random() % 9000;
+    std::string input = sample(random, len, 1 + random() % 255);
+    std::string compressed, output;
+    Effortless_SPIFFS_Internal::compressLZ((const uint8_t*)input.data(), input.size(), compressed);
+    CHECK(Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)compressed.data(), compressed.size(), output));
+    CHECK(output == input);
+  }
+}
+
+TEST(damagedCompressedDataIsRejected) {
+  std::mt19937 random(7);
+  std::string  input = sample(random, 2000, 8);
+  std::string  compressed, output;
+  Effortless_SPIFFS_Internal::compressLZ((const uint8_t*)input.data(), input.size(), compressed);
+  for (size_t i = 2; i < compressed.size(); i += 37) {
+    std::string damaged = compressed;
+    damaged[i] ^= 0x10;
+    CHECK(!Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)damaged.data(), damaged.size(), output) || output == input);
+  }
+  CHECK(!Effortless_SPIFFS_Internal::decompressLZ((const uint8_t*)compressed.data(), compressed.size() - 1, output));
+}
+
+TEST(compressedFilesAreSmallerAndLoadWithCompressionOff) {
+  resetFlash();
+  eSPIFFS     fileSystem;
+  std::string config;
+  for (int i = 0; config.size() < 1000; i++) config += "{\"sensor\":" + std::to_string(i % 10) + ",\"enabled\":true},";
+  fileSystem.setCompression(true);
+  CHECK(fileSystem.saveToFile("/config", config));
+  CHECK(spiffsFlash()->contents("/config").size() < config.size() / 2);
+
+  std::string read;
+  fileSystem.setCompression(false);
+  CHECK(fileSystem.openFromFile("/config", read));
+  CHECK(read == config);
+}
+
+TEST(smallOrIncompressibleValuesAreStoredAsTheyAre) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setCompression(true);
+  std::string small(Effortless_SPIFFS_COMPRESS_MIN - 1, 'a');
+  std::mt19937 random(99);
+  std::string  noise;
+  for (int i = 0; i < 500; i++) noise += (char)(' ' + random() % 95);
+  CHECK(fileSystem.saveToFile("/small", small));
+  CHECK(fileSystem.saveToFile("/noise", noise));
+  CHECK(spiffsFlash()->contents("/small") == small);
+  CHECK(spiffsFlash()->contents("/noise") == noise);
+}
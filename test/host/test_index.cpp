@@ -0,0 +1,103 @@
+// With the index on, metadata comes from RAM and the index follows every change the library makes
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_KV.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(metadataIsAnsweredFromRam) {
+  resetFlash();
+  spiffsFlash()->setContents("/a", "12345");
+  eSPIFFS fileSystem;
+  fileSystem.enableIndex();
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+
+  CHECK(fileSystem.exists("/a"));
+  CHECK(!fileSystem.exists("/missing"));
+  CHECK_EQUAL(5, fileSystem.getFileSize("/a"));
+  CHECK(fileSystem.getLastWrite("/a") != 0);
+  int value = 0;
+  CHECK(!fileSystem.openFromFile("/missing", value));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(0ul, counters.opens);
+  CHECK_EQUAL(0ul, counters.exists);
+  CHECK(fileSystem.getIndexMemory() >= 16);
+}
+
+TEST(indexFollowsChanges) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.enableIndex();
+  fileSystem.setAtomicSaves(true);
+  fileSystem.mount();
+
+  std::string value = "hello";
+  CHECK(fileSystem.saveToFile("/a", value));
+  CHECK_EQUAL(5, fileSystem.getFileSize("/a"));
+  CHECK(fileSystem.appendFile("/a", "hello"));
+  CHECK_EQUAL(10, fileSystem.getFileSize("/a"));
+  CHECK(fileSystem.renameFile("/a", "/b"));
+  CHECK(!fileSystem.exists("/a"));
+  CHECK_EQUAL(10, fileSystem.getFileSize("/b"));
+  CHECK(fileSystem.removeFile("/b"));
+  CHECK(!fileSystem.exists("/b"));
+
+  std::vector<eSPIFFS::BatchEntry> entries = {{"/c", "123"}, {"/d", "4567"}};
+  CHECK(fileSystem.saveFiles(entries));
+  CHECK_EQUAL(3, fileSystem.getFileSize("/c"));
+  CHECK_EQUAL(4, fileSystem.getFileSize("/d"));
+
+  // Temporary names of atomic and batch saves never show up
+  spiffsFlash()->resetCounters();
+  CHECK(!fileSystem.exists(Effortless_SPIFFS_Internal::markedName("/c", '~', Effortless_SPIFFS_Internal::crc32((const uint8_t*)"/c", 2)).c_str()));
+  CHECK_EQUAL(0ul, spiffsFlash()->counters().exists);
+}
+
+TEST(filesWrittenByHandFallBackToTheFileSystem) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.enableIndex();
+  fileSystem.mount();
+  File file = fileSystem.getFile("/raw", "w");
+  file.print("abc");
+  file.close();
+  spiffsFlash()->resetCounters();
+  CHECK_EQUAL(3, fileSystem.getFileSize("/raw"));
+  CHECK_EQUAL(1ul, spiffsFlash()->counters().opens);
+}
+
+TEST(namesSharingAHashAfterTheIndexIsBuilt) {
+  // "/f1079599" and "/f1262382" have the same FNV-1a hash
+  resetFlash();
+  spiffsFlash()->setContents("/f1079599", "old");
+  eSPIFFS fileSystem;
+  fileSystem.enableIndex();
+  fileSystem.mount();
+  CHECK(!fileSystem.exists("/f1262382"));
+  CHECK_EQUAL(0, fileSystem.getFileSize("/f1262382"));
+
+  CHECK(fileSystem.saveFile("/f1262382", "newer"));
+  CHECK_EQUAL(3, fileSystem.getFileSize("/f1079599"));
+  CHECK_EQUAL(5, fileSystem.getFileSize("/f1262382"));
+  CHECK(fileSystem.removeFile("/f1262382"));
+  CHECK(fileSystem.exists("/f1079599"));
+  CHECK(!fileSystem.exists("/f1262382"));
+  std::string value;
+  CHECK(fileSystem.openFromFile("/f1079599", value));
+  CHECK_EQUAL(std::string("old"), value);
+}
+
+TEST(keyValueReportsTheStoreWriteTime) {
+  resetFlash();
+  eSPIFFSKV store;
+  int       value = 1;
+  CHECK(store.saveToFile("counter", value));
+  CHECK(store.getLastWrite("counter") != 0);
+  CHECK_EQUAL(store.getLastWrite("counter"), store.getLastWrite("other"));
+}
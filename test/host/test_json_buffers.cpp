@@ -0,0 +1,48 @@
+// ArduinoJson reads and writes one byte at a time, the buffers turn those into reads and writes of a whole buffer
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+static const size_t DOCUMENT_SIZE = 6000;
+static const size_t NUM_BUFFERS = (DOCUMENT_SIZE + Effortless_SPIFFS_JSON_BUFFER_SIZE - 1) / Effortless_SPIFFS_JSON_BUFFER_SIZE;
+
+TEST(bufferedReaderReadsWholeBuffers) {
+  resetFlash();
+  std::string document;
+  for (size_t i = 0; i < DOCUMENT_SIZE; i++) document += (char)('a' + i % 26);
+  spiffsFlash()->setContents("/doc.json", document);
+  eSPIFFS fileSystem;
+  File    file = fileSystem.getFile("/doc.json", "r");
+  spiffsFlash()->resetCounters();
+
+  Effortless_SPIFFS_Internal::BufferedReader reader(file);
+  std::string                                read;
+  CHECK_EQUAL('a', reader.peek());
+  for (int c; (c = reader.read()) >= 0;) read += (char)c;
+  CHECK(read == document);
+  CHECK_EQUAL((unsigned long)NUM_BUFFERS, spiffsFlash()->counters().reads);
+}
+
+TEST(bufferedPrintWritesWholeBuffers) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  File    file = fileSystem.getFile("/doc.json", "w");
+  spiffsFlash()->resetCounters();
+
+  Effortless_SPIFFS_Internal::BufferedPrint output(file);
+  std::string                               document;
+  for (size_t i = 0; i < DOCUMENT_SIZE; i++) {
+    document += (char)('a' + i % 26);
+    CHECK_EQUAL(1u, output.write((uint8_t)document.back()));
+  }
+  CHECK(output.finish());
+  file.close();
+  CHECK(spiffsFlash()->contents("/doc.json") == document);
+  CHECK_EQUAL((unsigned long)NUM_BUFFERS, spiffsFlash()->counters().writes);
+}
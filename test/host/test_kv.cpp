@@ -0,0 +1,103 @@
+// The key value store keeps every value in one log file and survives reloads, torn writes and compaction
+#include "host_test.h"
+
+#include <Effortless_SPIFFS_KV.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(valuesShareOneFile) {
+  resetFlash();
+  eSPIFFSKV store;
+  for (int i = 0; i < 100; i++) {
+    String key = String("key") + String(i);
+    CHECK(store.saveToFile(key.c_str(), i));
+  }
+  CHECK_EQUAL(100u, store.size());
+  std::vector<std::string> files = spiffsFlash()->list();
+  CHECK_EQUAL(1u, files.size());
+  CHECK_EQUAL(std::string("/store.kv"), files[0]);
+
+  int value = 0;
+  CHECK(store.openFromFile("key57", value));
+  CHECK_EQUAL(57, value);
+  CHECK(!store.openFromFile("key100", value));
+}
+
+TEST(reloadKeepsLatestValues) {
+  resetFlash();
+  {
+    eSPIFFSKV store;
+    int       first = 1;
+    int       second = 2;
+    CHECK(store.saveToFile("a", first));
+    CHECK(store.saveToFile("b", first));
+    CHECK(store.saveToFile("a", second));
+    CHECK(store.remove("b"));
+  }
+  eSPIFFSKV store;
+  int       value = 0;
+  CHECK(store.openFromFile("a", value));
+  CHECK_EQUAL(2, value);
+  CHECK(!store.contains("b"));
+  CHECK_EQUAL(1u, store.size());
+}
+
+TEST(unchangedValueIsNotWritten) {
+  resetFlash();
+  eSPIFFSKV store;
+  int       value = 5;
+  CHECK(store.saveToFile("a", value));
+  size_t bytes = store.fileBytes();
+  CHECK(store.saveToFile("a", value));
+  CHECK_EQUAL(bytes, store.fileBytes());
+  CHECK_EQUAL(bytes, spiffsFlash()->contents("/store.kv").size());
+}
+
+TEST(tornRecordIsDropped) {
+  resetFlash();
+  {
+    eSPIFFSKV store;
+    int       first = 1;
+    int       second = 22;
+    CHECK(store.saveToFile("a", first));
+    CHECK(store.saveToFile("b", second));
+  }
+  std::string stored = spiffsFlash()->contents("/store.kv");
+  spiffsFlash()->setContents("/store.kv", stored.substr(0, stored.size() - 2));
+
+  eSPIFFSKV store;
+  int       value = 0;
+  CHECK(store.openFromFile("a", value));
+  CHECK_EQUAL(1, value);
+  CHECK(!store.contains("b"));
+  CHECK_EQUAL(store.fileBytes(), spiffsFlash()->contents("/store.kv").size());
+}
+
+TEST(compactionDropsGarbage) {
+  resetFlash();
+  eSPIFFSKV store;
+  store.setCompactThreshold(0);
+  std::string text(200, 'x');
+  for (int i = 0; i < 10; i++) {
+    text += 'y';
+    CHECK(store.saveToFile("text", text));
+  }
+  CHECK(store.garbageBytes() > 0);
+  CHECK(store.compact());
+  CHECK_EQUAL(0u, store.garbageBytes());
+  std::string loaded;
+  CHECK(store.openFromFile("text", loaded));
+  CHECK(loaded == text);
+  CHECK_EQUAL(store.fileBytes(), spiffsFlash()->contents("/store.kv").size());
+}
+
+TEST(directFileAccessIsRefused) {
+  resetFlash();
+  eSPIFFSKV store;
+  CHECK(!store.getFile("a", "w"));
+  CHECK(spiffsFlash()->list().empty());
+}
@@ -0,0 +1,112 @@
+// Tasks sharing files through one or more instances never see a torn value, and reads only share the file lock
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+#include <atomic>
+#include <thread>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+  spiffsFlash()->setYieldOnAccess(true);
+}
+
+static const int    NUM_CALLS = 500;
+static const size_t VALUE_SIZE = 300;
+
+static bool uniform(const std::string& _value) {
+  // Every save writes one repeated character, anything else was read while a save was part way through
+  return _value.size() == VALUE_SIZE && _value.find_first_not_of(_value[0]) == std::string::npos;
+}
+
+// Records the kind of access every call asks for, passing itself to eSPIFFSOn so its beforeAccess is the one called
+struct RecordingFileSystem : eSPIFFSOn<Effortless_SPIFFS_BACKEND, RecordingFileSystem> {
+  int reads = 0;
+  int writes = 0;
+
+ protected:
+  friend eSPIFFSOn<Effortless_SPIFFS_BACKEND, RecordingFileSystem>;
+  void beforeAccess(const char*, bool _write) {
+    (_write ? writes : reads)++;
+  }
+};
+
+TEST(readsOnlyAskForReadAccess) {
+  resetFlash();
+  spiffsFlash()->setContents("/number", "42");
+  spiffsFlash()->setContents("/text", "text");
+  RecordingFileSystem fileSystem;
+  fileSystem.mount();
+
+  int         number = 0;
+  std::string text;
+  char*       chars = nullptr;
+  char        buffer[8];
+  CHECK(fileSystem.openFromFile("/number", number));
+  CHECK(fileSystem.openFromFile("/text", text));
+  CHECK(fileSystem.openFromFile("/text", chars));
+  CHECK(fileSystem.openFile("/text", buffer, sizeof(buffer)));
+  CHECK(fileSystem.exists("/text"));
+  CHECK(fileSystem.getFileSize("/text"));
+  fileSystem.getFile("/text", "r").close();
+  CHECK(fileSystem.reads > 0);
+  CHECK_EQUAL(0, fileSystem.writes);
+}
+
+TEST(concurrentSavesAndReadsAreNeverTorn) {
+  // Two writers and two readers on one file, half of them through a second instance
+  resetFlash();
+  spiffsFlash()->setContents("/shared", std::string(VALUE_SIZE, 'a'));
+  eSPIFFS                  first;
+  eSPIFFS                  second;
+  std::atomic<int>         ready(0);
+  std::atomic<int>         torn(0);
+  std::atomic<int>         failed(0);
+  std::vector<std::thread> tasks;
+  for (int t = 0; t < 4; t++) {
+    eSPIFFS& fileSystem = t % 2 ? second : first;
+    tasks.push_back(std::thread([&fileSystem, &ready, &torn, &failed, t]() {
+      for (ready++; ready < 4;) std::this_thread::yield();
+      for (int i = 0; i < NUM_CALLS; i++) {
+        std::string value;
+        if (t < 2) {
+          value.assign(VALUE_SIZE, (char)('a' + (t * NUM_CALLS + i) % 26));
+          if (!fileSystem.saveToFile("/shared", value)) failed++;
+        } else if (!fileSystem.openFromFile("/shared", value)) {
+          failed++;
+        } else if (!uniform(value)) {
+          torn++;
+        }
+      }
+    }));
+  }
+  for (std::thread& task : tasks) task.join();
+  CHECK_EQUAL(0, failed.load());
+  CHECK_EQUAL(0, torn.load());
+  CHECK(uniform(spiffsFlash()->contents("/shared")));
+}
+
+TEST(tasksOnDifferentFilesRunTogether) {
+  // Each task keeps to its own file, every value it reads back is the one it saved
+  resetFlash();
+  eSPIFFS                  fileSystem;
+  std::atomic<int>         ready(0);
+  std::atomic<int>         mismatched(0);
+  std::vector<std::thread> tasks;
+  for (int t = 0; t < 4; t++) {
+    tasks.push_back(std::thread([&fileSystem, &ready, &mismatched, t]() {
+      char filename[16];
+      sprintf(filename, "/task%d", t);
+      for (ready++; ready < 4;) std::this_thread::yield();
+      for (int i = 0; i < NUM_CALLS; i++) {
+        int saved = t * NUM_CALLS + i;
+        int read = -1;
+        if (!fileSystem.saveToFile(filename, saved) || !fileSystem.openFromFile(filename, read) || read != saved) mismatched++;
+      }
+    }));
+  }
+  for (std::thread& task : tasks) task.join();
+  CHECK_EQUAL(0, mismatched.load());
+}
@@ -0,0 +1,88 @@
+// mount() keeps the file system started, so reads and saves skip the begin() and exists() calls
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(legacyCallsBeginAndExistsPerRead) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setAtomicSaves(false);
+  int saved = 42;
+  CHECK(fileSystem.saveToFile("/value", saved));
+  spiffsFlash()->resetCounters();
+
+  int value = 0;
+  for (int i = 0; i < 10; i++) CHECK(fileSystem.openFromFile("/value", value));
+  CHECK_EQUAL(42, value);
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(10ul, counters.begins);
+  CHECK_EQUAL(10ul, counters.exists);
+  CHECK_EQUAL(10ul, counters.opens);
+}
+
+TEST(mountedReadsOnlyOpen) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setAtomicSaves(false);
+  CHECK(fileSystem.mount());
+  int saved = 42;
+  CHECK(fileSystem.saveToFile("/value", saved));
+  spiffsFlash()->resetCounters();
+
+  int value = 0;
+  for (int i = 0; i < 10; i++) CHECK(fileSystem.openFromFile("/value", value));
+  CHECK_EQUAL(42, value);
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(0ul, counters.begins);
+  CHECK_EQUAL(0ul, counters.exists);
+  CHECK_EQUAL(10ul, counters.opens);
+}
+
+TEST(mountedSavesSkipBegin) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setAtomicSaves(false);
+  CHECK(fileSystem.mount());
+  spiffsFlash()->resetCounters();
+
+  for (int i = 0; i < 10; i++) CHECK(fileSystem.saveToFile("/value", i));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(0ul, counters.begins);
+  CHECK_EQUAL(0ul, counters.exists);
+  CHECK_EQUAL(10ul, counters.opens);
+}
+
+TEST(mountBeginsOnce) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  CHECK(fileSystem.mount());
+  CHECK(fileSystem.mount());
+  CHECK(fileSystem.isMounted());
+  CHECK_EQUAL(1ul, spiffsFlash()->counters().begins);
+}
+
+TEST(unmountEndsTheSession) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  CHECK(fileSystem.mount());
+  fileSystem.unmount();
+  CHECK(!fileSystem.isMounted());
+  CHECK(!spiffsFlash()->isMounted());
+  CHECK(fileSystem.remount());
+  CHECK_EQUAL(2ul, spiffsFlash()->counters().begins);
+}
+
+TEST(missingFileFailsWithoutOpen) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  int     value = 7;
+  CHECK(!fileSystem.openFromFile("/missing", value));
+  CHECK_EQUAL(7, value);
+  CHECK_EQUAL(0ul, spiffsFlash()->counters().opens);
+}
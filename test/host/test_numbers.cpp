@@ -0,0 +1,242 @@
+// Text numbers read back bit for bit with the fewest digits, in the printf %g layout, and parse exactly as strtod and strtof
+// Built again with EXHAUSTIVE_FLOATS to round trip every one of the 2^32 floats
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+#include <climits>
+#include <cmath>
+#include <random>
+
+using Effortless_SPIFFS_Internal::formatNumber;
+using Effortless_SPIFFS_Internal::parseFloat;
+using Effortless_SPIFFS_Internal::parseInteger;
+
+static const int NUM_RANDOM = 100000;
+
+template <class T>
+static std::string format(T _value) {
+  char   output[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+  size_t len = formatNumber(output, _value);
+  CHECK_EQUAL(strlen(output), len);
+  return output;
+}
+
+template <class T>
+static bool sameBits(T _first, T _second) {
+  return memcmp(&_first, &_second, sizeof(T)) == 0;
+}
+
+template <class T>
+static T parseLibc(const char* _input);
+template <>
+float parseLibc<float>(const char* _input) {
+  return strtof(_input, nullptr);
+}
+template <>
+double parseLibc<double>(const char* _input) {
+  return strtod(_input, nullptr);
+}
+
+static int significantDigits(const std::string& _text) {
+  // Digits before any exponent, without leading or trailing zeros
+  std::string digits;
+  for (char c : _text.substr(0, _text.find('e'))) {
+    if (c >= '0' && c <= '9') digits += c;
+  }
+  size_t first = digits.find_first_not_of('0');
+  if (first == std::string::npos) return 0;
+  return digits.find_last_not_of('0') - first + 1;
+}
+
+template <class T>
+static bool fewerDigitsReadBack(T _value, int _digits) {
+  // Both neighbours of the exact value with one digit fewer, nothing shorter reads back if neither does
+  if (_digits <= 1) return false;
+  char exact[1024];
+  snprintf(exact, sizeof(exact), "%.800e", fabs((double)_value));
+  std::string digits = std::string(exact, 1) + std::string(exact + 2, _digits - 2);
+  std::string exponent = strchr(exact, 'e');
+  std::string above = digits;
+  int         carry = (int)above.size() - 1;
+  while (carry >= 0 && above[carry] == '9') above[carry--] = '0';
+  if (carry < 0) above.insert(0, "1");
+  else above[carry]++;
+  for (const std::string& candidate : {digits, above}) {
+    std::string text = std::string(_value < 0 ? "-" : "") + "0." + candidate + "e" + std::to_string(atoi(exponent.c_str() + 1) + 1);
+    if (sameBits(parseLibc<T>(text.c_str()), _value)) return true;
+  }
+  return false;
+}
+
+template <class T>
+static bool checkFormat(T _value) {
+  // Reads back through both parsers, has no digit more than needed, and matches %.15g for normal values that fit in it
+  std::string text = format(_value);
+  bool        ok = sameBits(parseLibc<T>(text.c_str()), _value) && sameBits(parseFloat<T>(text.c_str()), _value);
+  ok &= !fewerDigitsReadBack(_value, significantDigits(text));
+  if (sizeof(T) == sizeof(double) && std::isnormal(_value) && significantDigits(text) <= Effortless_SPIFFS_PRECISION) {
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%.*g", Effortless_SPIFFS_PRECISION, (double)_value);
+    ok &= text == expected;
+  }
+  if (!ok) printf("  %.17g formatted as %s\n", (double)_value, text.c_str());
+  return ok;
+}
+
+template <class T>
+static T fromBits(typename Effortless_SPIFFS_Internal::FloatLayout<T>::Bits _bits) {
+  T value;
+  memcpy(&value, &_bits, sizeof(value));
+  return value;
+}
+
+template <class T>
+static int checkEveryExponent() {
+  // Smallest, largest, middle and a random mantissa of every exponent, the neighbours of each power of two, and both signs
+  typedef Effortless_SPIFFS_Internal::FloatLayout<T> Layout;
+  typedef typename Layout::Bits                      Bits;
+  std::mt19937_64                                    random(Layout::MANTISSA_BITS);
+  const Bits                                         mantissaMask = ((Bits)1 << Layout::MANTISSA_BITS) - 1;
+  int                                                failures = 0;
+  for (Bits exponent = 0; exponent < ((Bits)1 << Layout::EXPONENT_BITS) - 1; exponent++) {
+    Bits mantissas[] = {0, 1, 2, mantissaMask, mantissaMask - 1, (Bits)1 << (Layout::MANTISSA_BITS - 1), (Bits)random() & mantissaMask};
+    for (Bits mantissa : mantissas) {
+      Bits bits = exponent << Layout::MANTISSA_BITS | mantissa;
+      failures += !checkFormat(fromBits<T>(bits));
+      failures += !checkFormat(fromBits<T>(bits | (Bits)1 << (sizeof(Bits) * 8 - 1)));
+    }
+  }
+  return failures;
+}
+
+TEST(integersMatchPrintfAndStrtol) {
+  std::mt19937_64 random(1);
+  char            expected[32];
+  long            edges[] = {0, 1, -1, 9, 10, 99, 100, -100, LONG_MAX, LONG_MIN, LONG_MAX - 1, LONG_MIN + 1};
+  for (long value : edges) {
+    snprintf(expected, sizeof(expected), "%ld", value);
+    CHECK_EQUAL(std::string(expected), format(value));
+    CHECK_EQUAL(value, parseInteger<long>(expected));
+  }
+  int failures = 0;
+  for (int i = 0; i < NUM_RANDOM; i++) {
+    // Every length of number, not just the long ones a uniform draw gives
+    long          value = (long)(random() >> (random() % 64));
+    unsigned long unsignedValue = random() >> (random() % 64);
+    if (i % 2) value = -value;
+    snprintf(expected, sizeof(expected), "%ld", value);
+    failures += format(value) != expected || parseInteger<long>(expected) != strtol(expected, nullptr, 10);
+    snprintf(expected, sizeof(expected), "%lu", unsignedValue);
+    failures += format(unsignedValue) != expected || parseInteger<unsigned long>(expected) != strtoul(expected, nullptr, 10);
+  }
+  CHECK_EQUAL(0, failures);
+}
+
+TEST(integerParsingAcceptsWhatStrtolDoes) {
+  const char* inputs[] = {"", "  42", "\t\n-7", "+15", "-0", "12abc", "abc", "- 5", "007", "3.9", "1e5", "99999999999", "-1",
+                          "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+                          "18446744073709551615", "18446744073709551616", "-18446744073709551616", "99999999999999999999999999"};
+  for (const char* input : inputs) {
+    CHECK_EQUAL(strtol(input, nullptr, 10), parseInteger<long>(input));
+    CHECK_EQUAL(strtoul(input, nullptr, 10), parseInteger<unsigned long>(input));
+  }
+}
+
+TEST(outOfRangeIntegersClampLikeStrtol) {
+  // Digit runs of every length up to well past the range, so values near and over the limits are all hit
+  std::mt19937_64 random(4);
+  int             failures = 0;
+  for (int i = 0; i < NUM_RANDOM; i++) {
+    std::string text = i % 3 == 0 ? "-" : (i % 3 == 1 ? "+" : "");
+    int         numDigits = 1 + random() % 26;
+    for (int d = 0; d < numDigits; d++) text += (char)('0' + random() % 10);
+    failures += parseInteger<long>(text.c_str()) != strtol(text.c_str(), nullptr, 10);
+    failures += parseInteger<unsigned long>(text.c_str()) != strtoul(text.c_str(), nullptr, 10);
+  }
+  CHECK_EQUAL(0, failures);
+}
+
+TEST(floatEveryExponent) {
+  CHECK_EQUAL(0, checkEveryExponent<float>());
+}
+
+TEST(doubleEveryExponent) {
+  CHECK_EQUAL(0, checkEveryExponent<double>());
+}
+
+TEST(randomFloatsAndDoubles) {
+  std::mt19937_64 random(2);
+  int             failures = 0;
+  for (int i = 0; i < NUM_RANDOM; i++) {
+    float  single = fromBits<float>((uint32_t)random());
+    double dual = fromBits<double>(random());
+    if (!std::isnan(single) && !std::isinf(single)) failures += !checkFormat(single);
+    if (!std::isnan(dual) && !std::isinf(dual)) failures += !checkFormat(dual);
+  }
+  CHECK_EQUAL(0, failures);
+}
+
+TEST(everydayValuesKeepTheirText) {
+  CHECK_EQUAL(std::string("0.1"), format(0.1f));
+  CHECK_EQUAL(std::string("0.1"), format(0.1));
+  CHECK_EQUAL(std::string("3.14159"), format(3.14159f));
+  CHECK_EQUAL(std::string("100"), format(100.0));
+  CHECK_EQUAL(std::string("1e+15"), format(1e15));
+  CHECK_EQUAL(std::string("0.0001"), format(1e-4));
+  CHECK_EQUAL(std::string("1e-05"), format(1e-5));
+  CHECK_EQUAL(std::string("-0"), format(-0.0));
+  CHECK_EQUAL(std::string("0.30000000000000004"), format(0.1 + 0.2));
+  CHECK_EQUAL(std::string("inf"), format(INFINITY));
+  CHECK_EQUAL(std::string("-inf"), format(-INFINITY));
+  CHECK_EQUAL(std::string("nan"), format(NAN));
+}
+
+TEST(randomDecimalTextParsesLikeLibc) {
+  // Mantissas of every length with exponents around and past the exact range, written the ways people write them
+  std::mt19937_64 random(3);
+  int             failures = 0;
+  char            text[64];
+  for (int i = 0; i < NUM_RANDOM; i++) {
+    int         numDigits = 1 + random() % 22;
+    std::string digits;
+    for (int d = 0; d < numDigits; d++) digits += (char)('0' + random() % 10);
+    int  point = random() % (numDigits + 1);
+    int  exponent = (int)(random() % 81) - 40;
+    bool negative = random() % 2;
+    snprintf(text, sizeof(text), "%s%s.%se%d", negative ? "-" : "", digits.substr(0, point).c_str(), digits.substr(point).c_str(), exponent);
+    failures += !sameBits(parseFloat<double>(text), strtod(text, nullptr)) || !sameBits(parseFloat<float>(text), strtof(text, nullptr));
+    text[strlen(text) - snprintf(nullptr, 0, "e%d", exponent)] = '\0';  // The same digits without an exponent
+    failures += !sameBits(parseFloat<double>(text), strtod(text, nullptr)) || !sameBits(parseFloat<float>(text), strtof(text, nullptr));
+  }
+  CHECK_EQUAL(0, failures);
+}
+
+TEST(unusualTextParsesLikeLibc) {
+  const char* inputs[] = {"", "  1.5", "\t-2", "+3", ".5", "5.", "1e", "1e+", "1e-", "-0", "0e0", "00012.50", "1E3", "abc", "1.5abc", "9007199254740993",
+                          "4.9e-324", "2.4e-324", "1.7976931348623157e308", "1e309", "1e-400", "123456789012345678901234567890", "0.000000000000000000001",
+                          "16777217", "3.4028235e38", "1.17549435e-38", "1.4e-45"};
+  for (const char* input : inputs) {
+    CHECK(sameBits(strtod(input, nullptr), parseFloat<double>(input)));
+    CHECK(sameBits(strtof(input, nullptr), parseFloat<float>(input)));
+  }
+  CHECK(std::isnan(parseFloat<double>("nan")));
+  CHECK(std::isinf(parseFloat<float>("-inf")));
+}
+
+#ifdef EXHAUSTIVE_FLOATS
+TEST(everyFloatRoundTrips) {
+  // Only the round trip, the shortest digit search through printf would take days
+  unsigned long failures = 0;
+  char          output[Effortless_SPIFFS_Internal::NUMBER_TEXT_SIZE];
+  for (uint64_t bits = 0; bits <= UINT32_MAX; bits++) {
+    float value = fromBits<float>((uint32_t)bits);
+    if (std::isnan(value)) continue;
+    formatNumber(output, value);
+    if (!sameBits(parseFloat<float>(output), value) || !sameBits(strtof(output, nullptr), value)) {
+      if (failures++ < 10) printf("  %.9g formatted as %s\n", value, output);
+    }
+  }
+  CHECK_EQUAL(0ul, failures);
+}
+#endif
@@ -0,0 +1,117 @@
+// Partial updates overwrite only the bytes they are given, and record files read and write records by index
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_KV.h>
+#include <Effortless_SPIFFS_RecordFile.h>
+
+#include <cstddef>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+struct Reading {
+  uint32_t time;
+  float    value;
+  uint8_t  flags;
+};
+
+TEST(updateRangeWritesOnlyTheRange) {
+  resetFlash();
+  spiffsFlash()->setContents("/record", std::string(4096, 'r'));
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+
+  const uint8_t patch[4] = {'p', 'p', 'p', 'p'};
+  CHECK(fileSystem.updateRange("/record", 1000, patch, sizeof(patch)));
+  FlashCounters counters = spiffsFlash()->counters();
+  CHECK_EQUAL(4ul, counters.bytesWritten);
+  CHECK_EQUAL(0ul, counters.bytesRead);
+  CHECK_EQUAL(1ul, counters.opens);
+
+  std::string expected(4096, 'r');
+  expected.replace(1000, 4, "pppp");
+  CHECK(spiffsFlash()->contents("/record") == expected);
+}
+
+TEST(updateRangeNeverGrowsTheFile) {
+  resetFlash();
+  spiffsFlash()->setContents("/record", "0123456789");
+  eSPIFFS       fileSystem;
+  const uint8_t patch[4] = {'p', 'p', 'p', 'p'};
+  CHECK(!fileSystem.updateRange("/record", 8, patch, sizeof(patch)));
+  CHECK(!fileSystem.updateRange("/missing", 0, patch, sizeof(patch)));
+  CHECK(!fileSystem.updateRange("/record", 0, patch, 0));
+  CHECK_EQUAL(std::string("0123456789"), spiffsFlash()->contents("/record"));
+}
+
+TEST(readRangeReadsOnlyTheRange) {
+  resetFlash();
+  spiffsFlash()->setContents("/record", "0123456789");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+  uint8_t output[3];
+  CHECK(fileSystem.readRange("/record", 4, output, sizeof(output)));
+  CHECK_EQUAL(std::string("456"), std::string((const char*)output, sizeof(output)));
+  CHECK_EQUAL(3ul, spiffsFlash()->counters().bytesRead);
+  CHECK(!fileSystem.readRange("/record", 8, output, sizeof(output)));
+}
+
+TEST(cachedUpdateRangeSkipsUnchangedBytes) {
+  resetFlash();
+  spiffsFlash()->setContents("/record", "0123456789");
+  eSPIFFS fileSystem;
+  fileSystem.enableCache();
+  uint8_t output[10];
+  CHECK(fileSystem.readRange("/record", 0, output, sizeof(output)));
+  spiffsFlash()->resetCounters();
+  const uint8_t same[2] = {'2', '3'};
+  CHECK(fileSystem.updateRange("/record", 2, same, sizeof(same)));
+  CHECK_EQUAL(1ul, fileSystem.getCacheStats().writesAvoided);
+  const uint8_t patch[2] = {'x', 'y'};
+  CHECK(fileSystem.updateRange("/record", 2, patch, sizeof(patch)));
+  CHECK(fileSystem.flush());
+  CHECK_EQUAL(std::string("01xy456789"), spiffsFlash()->contents("/record"));
+}
+
+TEST(recordFileWritesRecordsInPlace) {
+  resetFlash();
+  eSPIFFS                    fileSystem;
+  eSPIFFSRecordFile<Reading> records(fileSystem, "/readings");
+  Reading                    reading = {1, 1.5f, 0};
+  CHECK(records.resize(4));
+  CHECK_EQUAL(4u, records.size());
+  CHECK(records.write(2, reading));
+  CHECK(records.write(4, reading));
+  CHECK(!records.write(6, reading));
+  CHECK_EQUAL(5u, records.size());
+
+  spiffsFlash()->resetCounters();
+  uint8_t flags = 7;
+  CHECK(records.writeField(2, offsetof(Reading, flags), flags));
+  CHECK_EQUAL(1ul, spiffsFlash()->counters().bytesWritten);
+
+  Reading read;
+  CHECK(records.read(2, read));
+  CHECK_EQUAL(1u, read.time);
+  CHECK(read.value == 1.5f);
+  CHECK_EQUAL(7, read.flags);
+  CHECK(!records.read(5, read));
+}
+
+TEST(keyValueStoreRejectsPartialUpdates) {
+  resetFlash();
+  eSPIFFSKV     store;
+  int           value = 1234;
+  const uint8_t patch[1] = {0};
+  CHECK(store.saveToFile("value", value));
+  CHECK(!store.updateRange("value", 0, patch, sizeof(patch)));
+  int read = 0;
+  CHECK(store.openFromFile("value", read));
+  CHECK_EQUAL(1234, read);
+}
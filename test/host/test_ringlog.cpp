@@ -0,0 +1,106 @@
+// The ring log overwrites its oldest records, finds its head again after a reopen and skips torn slots
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_RingLog.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+static const size_t SLOT = 4 + sizeof(uint32_t) + 1;
+
+static void appendRange(eSPIFFSRingLog<uint32_t>& _log, uint32_t _first, uint32_t _last) {
+  for (uint32_t i = _first; i <= _last; i++) CHECK(_log.append(i));
+}
+
+TEST(ringLogWrapsAndKeepsNewest) {
+  resetFlash();
+  eSPIFFS                  fileSystem;
+  eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 5, 3);
+  appendRange(log, 1, 12);
+  CHECK_EQUAL(5u, log.size());
+  CHECK_EQUAL(5 * SLOT, spiffsFlash()->contents("/ring.log").size());
+
+  uint32_t last[5];
+  CHECK_EQUAL(5u, log.readLast(last, 5));
+  for (uint32_t i = 0; i < 5; i++) CHECK_EQUAL(i + 8, last[i]);
+}
+
+TEST(ringLogRecoversHeadAfterReopen) {
+  // Every head position in the first laps is found again by the binary search
+  for (uint32_t count = 1; count <= 17; count++) {
+    resetFlash();
+    eSPIFFS fileSystem;
+    {
+      eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 7, 2);
+      appendRange(log, 1, count);
+    }
+    eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 7, 2);
+    CHECK(log.begin());
+    CHECK_EQUAL(count < 7 ? count : 7u, log.size());
+    CHECK(log.append(count + 1));
+    uint32_t newest;
+    CHECK_EQUAL(1u, log.readLast(&newest, 1));
+    CHECK_EQUAL(count + 1, newest);
+  }
+}
+
+TEST(ringLogSkipsTornSlots) {
+  resetFlash();
+  eSPIFFS fileSystem;
+  {
+    eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 5, 1);
+    appendRange(log, 1, 4);
+  }
+  std::string contents = spiffsFlash()->contents("/ring.log");
+  contents[1 * SLOT + 5] ^= 0x40;
+  spiffsFlash()->setContents("/ring.log", contents);
+
+  eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 5, 1);
+  uint32_t                 last[4];
+  CHECK_EQUAL(3u, log.readLast(last, 4));
+  CHECK_EQUAL(1u, last[0]);
+  CHECK_EQUAL(3u, last[1]);
+  CHECK_EQUAL(4u, last[2]);
+}
+
+TEST(ringLogRecoversWhenSlotZeroIsTorn) {
+  // A torn write of slot 0 after wrapping falls back to the last slot
+  resetFlash();
+  eSPIFFS fileSystem;
+  {
+    eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 4, 1);
+    appendRange(log, 1, 5);
+  }
+  std::string contents = spiffsFlash()->contents("/ring.log");
+  contents[SLOT - 1] ^= 0x01;
+  spiffsFlash()->setContents("/ring.log", contents);
+
+  eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 4, 1);
+  CHECK(log.append(5));
+  uint32_t newest;
+  CHECK_EQUAL(1u, log.readLast(&newest, 1));
+  CHECK_EQUAL(5u, newest);
+}
+
+TEST(ringLogBufferLargerThanCapacity) {
+  // The default buffer of 8 on a log of 4, starting the flush half way round the ring
+  resetFlash();
+  eSPIFFS fileSystem;
+  {
+    eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 4);
+    appendRange(log, 1, 2);
+    CHECK(log.flush());
+    appendRange(log, 3, 11);
+    CHECK_EQUAL(4 * SLOT, spiffsFlash()->contents("/ring.log").size());
+  }
+  CHECK_EQUAL(4 * SLOT, spiffsFlash()->contents("/ring.log").size());
+
+  eSPIFFSRingLog<uint32_t> log(fileSystem, "/ring.log", 4);
+  uint32_t                 last[4];
+  CHECK_EQUAL(4u, log.readLast(last, 4));
+  for (uint32_t i = 0; i < 4; i++) CHECK_EQUAL(i + 8, last[i]);
+}
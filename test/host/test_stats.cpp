@@ -0,0 +1,58 @@
+// Statistics stay exact while several tasks share one instance, and nested calls are only counted once
+#define Effortless_SPIFFS_STATS true
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+
+#include <atomic>
+#include <thread>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+static const int NUM_TASKS = 4;
+static const int NUM_CALLS = 2000;
+
+TEST(concurrentReadsAreAllCounted) {
+  resetFlash();
+  spiffsFlash()->setContents("/value", "42");
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  fileSystem.resetStats();
+
+  // Every task starts at once so their calls overlap
+  std::atomic<int>         ready(0);
+  std::vector<std::thread> tasks;
+  for (int t = 0; t < NUM_TASKS; t++) {
+    tasks.push_back(std::thread([&fileSystem, &ready, t]() {
+      int value = 0;
+      for (ready++; ready < NUM_TASKS;) std::this_thread::yield();
+      for (int i = 0; i < NUM_CALLS; i++) fileSystem.openFromFile(t % 2 ? "/value" : "/missing", value);
+    }));
+  }
+  for (std::thread& task : tasks) task.join();
+
+  eSPIFFS::Stats stats = fileSystem.getStats();
+  CHECK_EQUAL((unsigned long)(NUM_TASKS * NUM_CALLS), stats.read.count);
+  CHECK_EQUAL((unsigned long)(NUM_TASKS / 2 * NUM_CALLS), stats.read.failures);
+  CHECK_EQUAL((unsigned long)(NUM_TASKS / 2 * NUM_CALLS), stats.failures[eSPIFFS::OPEN_FAILURE]);
+  CHECK_EQUAL((unsigned long)(NUM_TASKS / 2 * NUM_CALLS * 2), stats.bytesRead);
+}
+
+TEST(nestedCallsAreCountedOnce) {
+  // An atomic save reads the file back to verify it, that read is not a call of its own
+  resetFlash();
+  eSPIFFS fileSystem;
+  fileSystem.setAtomicSaves(true);
+  fileSystem.mount();
+  fileSystem.resetStats();
+  int value = 7;
+  CHECK(fileSystem.saveToFile("/value", value));
+  eSPIFFS::Stats stats = fileSystem.getStats();
+  CHECK_EQUAL(1ul, stats.save.count);
+  CHECK_EQUAL(0ul, stats.read.count);
+  CHECK_EQUAL(0ul, stats.save.failures);
+}
@@ -0,0 +1,95 @@
+// Values are read with a single open into fixed buffers and readFile() streams fixed size chunks
+#include "host_test.h"
+
+#include <Effortless_SPIFFS.h>
+#include <Effortless_SPIFFS_KV.h>
+#include <Effortless_SPIFFS_RingLog.h>
+
+static void resetFlash() {
+  spiffsFlash()->end();
+  spiffsFlash()->format();
+  spiffsFlash()->resetCounters();
+}
+
+TEST(valueReadsOpenOnce) {
+  resetFlash();
+  spiffsFlash()->setContents("/number", "12345");
+  spiffsFlash()->setContents("/text", std::string(1000, 't'));
+  eSPIFFS fileSystem;
+  fileSystem.mount();
+  spiffsFlash()->resetCounters();
+
+  long        number = 0;
+  std::string text;
+  String      arduinoText;
+  CHECK(fileSystem.openFromFile("/number", number));
+  CHECK(fileSystem.openFromFile("/text", text));
+  CHECK(fileSystem.openFromFile("/text", arduinoText));
+  CHECK_EQUAL(12345L, number);
+  CHECK_EQUAL(1000u, text.size());
+  CHECK_EQUAL(1000u, arduinoText.length());
+  CHECK_EQUAL(3ul, spiffsFlash()->counters().opens);
+}
+
+TEST(readFileStreamsChunks) {
+  resetFlash();
+  std::string contents;
+  for (int i = 0; i < 1000; i++) contents += (char)('a' + i % 26);
+  spiffsFlash()->setContents("/stream", contents);
+  eSPIFFS fileSystem;
+
+  std::string streamed;
+  size_t      largest = 0;
+  CHECK(fileSystem.readFile("/stream", [&](const uint8_t* _data, size_t _size) {
+    streamed.append((const char*)_data, _size);
+    largest = std::max(largest, _size);
+    return true;
+  }));
+  CHECK(streamed == contents);
+  CHECK_EQUAL((size_t)Effortless_SPIFFS_CHUNK_SIZE, largest);
+}
+
+TEST(readFileStopsEarly) {
+  resetFlash();
+  spiffsFlash()->setContents("/stream", std::string(1000, 's'));
+  eSPIFFS fileSystem;
+  int     calls = 0;
+  CHECK(fileSystem.readFile("/stream", [&](const uint8_t*, size_t) { return ++calls < 2; }));
+  CHECK_EQUAL(2, calls);
+}
+
+TEST(keyValueLongKeysCompareInChunks) {
+  resetFlash();
+  eSPIFFSKV   store;
+  std::string key(200, 'k');
+  std::string similar = key;
+  similar[150] = 'j';
+  int value = 1;
+  CHECK(store.saveToFile(key.c_str(), value));
+  CHECK(store.contains(key.c_str()));
+  CHECK(!store.contains(similar.c_str()));
+}
+
+struct LargeRecord {
+  uint32_t id;
+  uint8_t  payload[300];
+};
+
+TEST(ringLogReadsSlotsLargerThanAChunk) {
+  resetFlash();
+  eSPIFFS                     fileSystem;
+  eSPIFFSRingLog<LargeRecord> log(fileSystem, "/large.log", 4, 1);
+  LargeRecord                 record;
+  for (uint32_t i = 1; i <= 6; i++) {
+    record.id = i;
+    memset(record.payload, (int)i, sizeof(record.payload));
+    CHECK(log.append(record));
+  }
+
+  LargeRecord last[4];
+  CHECK_EQUAL(4u, log.readLast(last, 4));
+  for (uint32_t i = 0; i < 4; i++) {
+    CHECK_EQUAL(i + 3, last[i].id);
+    CHECK_EQUAL(i + 3, last[i].payload[299]);
+  }
+}